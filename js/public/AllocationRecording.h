@@ -60,6 +60,21 @@ typedef void (*RecordAllocationsCallback)(RecordAllocationInfo&& info);
 JS_FRIEND_API void EnableRecordingAllocations(
     JSContext* cx, RecordAllocationsCallback callback, double probability);
 
+/**
+ * Like EnableRecordingAllocations, but sample allocations by size rather than
+ * by count: each allocated byte is sampled with probability
+ * 1 / |averageBytesBetweenSamples|, and an allocation is recorded if any of its
+ * bytes are sampled. This gives a Poisson process over allocated bytes, so
+ * large allocations are more likely to be recorded and the number of stacks
+ * captured is proportional to the allocation volume rather than the allocation
+ * count. The size of an object includes its GC cell and any slots and elements
+ * allocated for it outside the GC heap. For example, passing 512 * 1024
+ * records roughly one allocation per 512KB allocated.
+ */
+JS_FRIEND_API void EnableRecordingAllocationsByBytes(
+    JSContext* cx, RecordAllocationsCallback callback,
+    uint32_t averageBytesBetweenSamples);
+
 /**
  * Turn off JS allocation recording. If any JS Debuggers are also recording
  * allocations, then the probability will be reset to the Debugger's desired
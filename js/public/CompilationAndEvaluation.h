@@ -290,6 +290,27 @@ extern JS_PUBLIC_API JSScript* CompileForNonSyntacticScopeDontInflate(
     JSContext* cx, const ReadOnlyCompileOptions& options,
     SourceText<mozilla::Utf8Unit>& srcBuf);
 
+/**
+ * Check that the provided UTF-16 data is a valid script, including its early
+ * errors, without compiling it: neither bytecode nor a script is created.
+ * Return true if it's valid, or return false with an error reported if it
+ * isn't (or on OOM).
+ *
+ * This is much cheaper than compiling for embeddings which only validate
+ * scripts, such as linters.
+ */
+extern JS_PUBLIC_API bool CheckScriptSyntax(
+    JSContext* cx, const ReadOnlyCompileOptions& options,
+    SourceText<char16_t>& srcBuf);
+
+/**
+ * Check that the provided UTF-8 data is a valid script, as above.  It is an
+ * error if the data contains invalid UTF-8.
+ */
+extern JS_PUBLIC_API bool CheckScriptSyntax(
+    JSContext* cx, const ReadOnlyCompileOptions& options,
+    SourceText<mozilla::Utf8Unit>& srcBuf);
+
 /**
  * Compile a function with envChain plus the global as its scope chain.
  * envChain must contain objects in the current compartment of cx.  The actual
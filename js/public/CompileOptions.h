@@ -125,6 +125,12 @@ class JS_PUBLIC_API TransitiveCompileOptions {
   bool hideScriptFromDebugger = false;
   bool fieldsEnabledOption = true;
 
+  // Try compiling with the Rust frontend first, falling back to the C++
+  // frontend for unsupported input.  This is captured from the ContextOptions
+  // of the context creating the options so that it survives the hand-off to
+  // helper thread contexts, which have default ContextOptions.
+  bool tryRustFrontend = false;
+
   /**
    * |introductionType| is a statically allocated C string: one of "eval",
    * "Function", or "GeneratorFunction".
@@ -206,6 +212,19 @@ class JS_PUBLIC_API ReadOnlyCompileOptions : public TransitiveCompileOptions {
   bool nonSyntacticScope = false;
   bool noScriptRval = false;
 
+  // Off-thread compilations that nothing waits on yet, such as preloads, may
+  // be marked speculative. Helper threads start them after the compilations
+  // that block the embedder, unless they have been queued for too long.
+  bool speculativeOffThread = false;
+
+  // The toStringStart offsets, in increasing order, of functions to compile
+  // along with the script instead of lazily, as recorded by
+  // js::GetDelazifiedFunctionOffsets in an earlier run over the same source.
+  // CompileOptions only refers to the array, which must outlive it, while
+  // OwningCompileOptions (as used by off-thread compilations) owns a copy.
+  const uint32_t* eagerFunctionOffsets = nullptr;
+  size_t eagerFunctionOffsetsLength = 0;
+
  protected:
   // Flag used to bypass the filename validation callback.
   // See also SetFilenameValidationCallback.
@@ -222,6 +241,10 @@ class JS_PUBLIC_API ReadOnlyCompileOptions : public TransitiveCompileOptions {
   // Read-only accessors for non-POD options. The proper way to set these
   // depends on the derived type.
   bool skipFilenameValidation() const { return skipFilenameValidation_; }
+
+  // Whether the function starting at |toStringStart| is listed in
+  // |eagerFunctionOffsets|.
+  bool isEagerFunction(uint32_t toStringStart) const;
   const char* filename() const { return filename_; }
   const char* introducerFilename() const { return introducerFilename_; }
   const char16_t* sourceMapURL() const { return sourceMapURL_; }
@@ -411,6 +434,18 @@ class MOZ_STACK_CLASS JS_PUBLIC_API CompileOptions final
     return *this;
   }
 
+  CompileOptions& setSpeculativeOffThread(bool s) {
+    speculativeOffThread = s;
+    return *this;
+  }
+
+  CompileOptions& setEagerFunctionOffsets(const uint32_t* offsets,
+                                          size_t length) {
+    eagerFunctionOffsets = offsets;
+    eagerFunctionOffsetsLength = length;
+    return *this;
+  }
+
   CompileOptions& setIntroductionType(const char* t) {
     introductionType = t;
     return *this;
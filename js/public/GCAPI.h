@@ -346,6 +346,44 @@ typedef enum JSGCParamKey {
    * Default: MallocGrowthFactor
    */
   JSGC_MALLOC_GROWTH_FACTOR = 36,
+
+  /**
+   * Target maximum duration of a minor GC, in microseconds.
+   *
+   * If set, the nursery will not be grown beyond the size predicted to be
+   * collectable within this time, and will be shrunk when it is larger. The
+   * prediction uses the time the last minor GC spent per tenured byte and the
+   * recent promotion rate. Zero means no target.
+   *
+   * Default: NurseryPauseTargetUS
+   */
+  JSGC_NURSERY_PAUSE_TARGET_US = 37,
+
+  /**
+   * Whether background decommit releases free arenas in chunks that are
+   * still in use.
+   *
+   * Decommitting single arenas splits transparent huge pages backing the GC
+   * heap. Embedders running with huge pages may disable this so that memory
+   * is only returned to the OS a whole chunk at a time. Shrinking GCs always
+   * decommit free arenas.
+   *
+   * Default: DecommitFreeArenasEnabled
+   */
+  JSGC_DECOMMIT_FREE_ARENAS = 38,
+
+  /**
+   * Whether minor GCs deduplicate identical inline strings as they are
+   * tenured.
+   *
+   * When enabled, a nursery inline string whose characters match a string
+   * already tenured by the same minor GC in the same zone is forwarded to that
+   * string rather than being copied. This costs a hash lookup per tenured
+   * inline string.
+   *
+   * Default: StringDeduplicationEnabled
+   */
+  JSGC_STRING_DEDUPLICATION = 39,
 } JSGCParamKey;
 
 /*
@@ -557,6 +595,27 @@ extern JS_PUBLIC_API bool IsGCScheduled(JSContext* cx);
  */
 extern JS_PUBLIC_API void SkipZoneForGC(Zone* zone);
 
+/**
+ * Set a limit on the size of the GC heap of the given zone, or clear it by
+ * passing zero. When the zone's GC heap reaches this size, JS_MaybeGC will
+ * start a GC of that zone alone, even if the engine's own heap thresholds have
+ * not been reached. This lets an embedding that hosts several independent
+ * tenants in one runtime collect each tenant's zones against its own budget.
+ *
+ * If such a GC leaves more than the quota live, the zone isn't collected for
+ * its quota again until its GC heap has grown by half over what was left.
+ *
+ * The quota is only checked by JS_MaybeGC, so the embedding should call that
+ * regularly, for example when idle.
+ */
+extern JS_PUBLIC_API void SetZoneGCHeapQuota(Zone* zone, size_t bytes);
+
+/**
+ * Get the GC heap quota set for the given zone by SetZoneGCHeapQuota, or zero
+ * if there is none.
+ */
+extern JS_PUBLIC_API size_t GetZoneGCHeapQuota(Zone* zone);
+
 /*
  * Non-Incremental GC:
  *
@@ -778,6 +837,43 @@ using GCNurseryCollectionCallback = void (*)(JSContext* cx,
 extern JS_PUBLIC_API GCNurseryCollectionCallback SetGCNurseryCollectionCallback(
     JSContext* cx, GCNurseryCollectionCallback callback);
 
+/**
+ * A histogram of GC pause durations. Bucket i counts pauses lasting at least
+ * 2^i and less than 2^(i+1) microseconds; the first bucket also counts shorter
+ * pauses and the last bucket also counts longer ones.
+ */
+struct GCDurationHistogram {
+  static const size_t BucketCount = 24;
+
+  uint64_t buckets[BucketCount] = {};
+  uint64_t count = 0;
+  uint64_t totalMicroseconds = 0;
+  uint64_t maxMicroseconds = 0;
+};
+
+/**
+ * GC pause statistics accumulated since the runtime was created or since the
+ * last call to ResetGCPauseHistogram. These are always collected and are cheap
+ * to query, so embedders can poll them periodically to build rolling views.
+ */
+struct GCPauseHistogram {
+  // Durations of major GC slices.
+  GCDurationHistogram majorSlices;
+
+  // Durations of nursery collections.
+  GCDurationHistogram minorGCs;
+
+  // Totals over completed major GCs, from which an average mark rate can be
+  // computed.
+  uint64_t cellsMarked = 0;
+  uint64_t markMicroseconds = 0;
+};
+
+extern JS_PUBLIC_API void GetGCPauseHistogram(JSContext* cx,
+                                              GCPauseHistogram* histogram);
+
+extern JS_PUBLIC_API void ResetGCPauseHistogram(JSContext* cx);
+
 typedef void (*DoCycleCollectionCallback)(JSContext* cx);
 
 /**
@@ -1097,6 +1193,34 @@ extern JS_PUBLIC_API bool IsIdleGCTaskNeeded(JSRuntime* rt);
 
 extern JS_PUBLIC_API void RunIdleTimeGCTask(JSRuntime* rt);
 
+/**
+ * The work performed by RunIdleTimeGCWork.
+ */
+enum class IdleGCWork {
+  // There was nothing worth doing in the time available.
+  None,
+
+  // The nursery was collected.
+  MinorGC,
+
+  // A slice of a new or in-progress incremental major GC was run.
+  MajorSlice
+};
+
+/**
+ * Use idle time before |deadline| to do whatever GC work is most useful now.
+ *
+ * In order of preference this runs a slice of an incremental GC that is in
+ * progress, collects the nursery if it is nearly full and the previous minor
+ * GC would have fit before the deadline, or starts an incremental GC of the
+ * zones that are close to their heap thresholds. Slices are limited to the
+ * whole milliseconds remaining before the deadline, so no major GC work is
+ * done with less than a millisecond left. The nursery is not collected if
+ * there is no previous minor GC to estimate its duration from.
+ */
+extern JS_PUBLIC_API IdleGCWork RunIdleTimeGCWork(JSContext* cx,
+                                                  mozilla::TimeStamp deadline);
+
 extern JS_PUBLIC_API void SetHostCleanupFinalizationGroupCallback(
     JSContext* cx, JSHostCleanupFinalizationGroupCallback cb, void* data);
 
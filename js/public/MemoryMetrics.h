@@ -468,7 +468,9 @@ struct HelperThreadStats {
  * Measurements that not associated with any individual runtime.
  */
 struct GlobalStats {
-#define FOR_EACH_SIZE(MACRO) MACRO(_, MallocHeap, tracelogger)
+#define FOR_EACH_SIZE(MACRO)        \
+  MACRO(_, MallocHeap, tracelogger) \
+  MACRO(_, MallocHeap, smooshCompileCache)
 
   explicit GlobalStats(mozilla::MallocSizeOf mallocSizeOf)
       : mallocSizeOf_(mallocSizeOf) {}
@@ -519,6 +521,10 @@ struct RuntimeSizes {
   ScriptSourceInfo scriptSourceInfo;
   GCSizes gc;
 
+  // Cumulative lookup counts of the uncompressed source cache.
+  uint64_t uncompressedSourceCacheHits = 0;
+  uint64_t uncompressedSourceCacheMisses = 0;
+
   typedef js::HashMap<const char*, ScriptSourceInfo, mozilla::CStringHasher,
                       js::SystemAllocPolicy>
       ScriptSourcesHashMap;
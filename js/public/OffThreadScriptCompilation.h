@@ -98,6 +98,23 @@ extern JS_PUBLIC_API bool CompileOffThreadModule(
 extern JS_PUBLIC_API JSObject* FinishOffThreadModule(JSContext* cx,
                                                      OffThreadToken* token);
 
+/*
+ * Get the specifiers of the static import requests of a module compiled off
+ * thread. Unlike FinishOffThreadModule, these may be called from the
+ * OffThreadCompileCallback, so that an embedder can start fetching and
+ * compiling the module's dependencies without waiting for the main thread.
+ *
+ * The returned string is null-terminated, owned by the token, and valid until
+ * the module is finished or cancelled. Its length is stored in |*length|, as
+ * specifiers may themselves contain null characters. Specifiers are in source
+ * order and are not resolved or deduplicated.
+ */
+extern JS_PUBLIC_API size_t GetOffThreadModuleRequestCount(
+    OffThreadToken* token);
+
+extern JS_PUBLIC_API const char16_t* GetOffThreadModuleRequest(
+    OffThreadToken* token, size_t index, size_t* length);
+
 extern JS_PUBLIC_API void CancelOffThreadModule(JSContext* cx,
                                                 OffThreadToken* token);
 
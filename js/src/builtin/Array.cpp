@@ -1150,6 +1150,10 @@ static MOZ_ALWAYS_INLINE bool IsArraySpecies(JSContext* cx,
   return IsSelfHostedFunctionWithName(getter, cx->names().ArraySpecies);
 }
 
+bool js::IsArraySpeciesDefault(JSContext* cx, HandleObject origArray) {
+  return IsArraySpecies(cx, origArray);
+}
+
 static bool ArraySpeciesCreate(JSContext* cx, HandleObject origArray,
                                uint64_t length, MutableHandleObject arr) {
   MOZ_ASSERT(length < DOUBLE_INTEGRAL_PRECISION_LIMIT);
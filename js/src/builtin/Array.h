@@ -186,6 +186,11 @@ extern JSString* ArrayToSource(JSContext* cx, HandleObject obj);
 extern bool IsCrossRealmArrayConstructor(JSContext* cx, const Value& v,
                                          bool* result);
 
+// Returns true if ArraySpeciesCreate for |origArray| is known to create an
+// ordinary Array from the current realm without running any script. False
+// means the full species lookup has to be performed.
+extern bool IsArraySpeciesDefault(JSContext* cx, HandleObject origArray);
+
 extern bool ObjectMayHaveExtraIndexedProperties(JSObject* obj);
 
 // JS::IsArray has multiple overloads, use js::IsArrayFromJit to disambiguate.
@@ -907,6 +907,11 @@ function ArraySpeciesCreate(originalArray, length) {
     if (!IsArray(originalArray))
         return std_Array(length);
 
+    // Fast path when the constructor and @@species lookups are known to
+    // produce this realm's Array constructor.
+    if (IsArraySpeciesDefault(originalArray))
+        return std_Array(length);
+
     // Step 5.a.
     var C = originalArray.constructor;
 
@@ -412,6 +412,27 @@ class CycleDetector {
   bool appended_;
 };
 
+/*
+ * Fast path for reading a property of a plain object: if |id| is an own data
+ * property with a slot, load it directly instead of going through the generic
+ * property get. Returns false, without side effects, when the slow path must
+ * be taken.
+ */
+static bool GetOwnDataPropertyPure(JSObject* obj, jsid id, Value* vp) {
+  if (!obj->is<PlainObject>()) {
+    return false;
+  }
+
+  NativeObject* nobj = &obj->as<NativeObject>();
+  Shape* shape = nobj->lookupPure(id);
+  if (!shape || !shape->isDataProperty()) {
+    return false;
+  }
+
+  *vp = nobj->getSlot(shape->slot());
+  return true;
+}
+
 /* ES5 15.12.3 JO. */
 static bool JO(JSContext* cx, HandleObject obj, StringifyContext* scx) {
   /*
@@ -486,7 +507,8 @@ static bool JO(JSContext* cx, HandleObject obj, StringifyContext* scx) {
                  prop.shape()->isDataDescriptor());
     }
 #endif  // DEBUG
-    if (!GetProperty(cx, obj, obj, id, &outputValue)) {
+    if (!GetOwnDataPropertyPure(obj, id, outputValue.address()) &&
+        !GetProperty(cx, obj, obj, id, &outputValue)) {
       return false;
     }
     if (!PreprocessValue(cx, obj, HandleId(id), &outputValue, scx)) {
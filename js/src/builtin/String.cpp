@@ -1867,6 +1867,14 @@ static int Matcher(const TextChar* text, uint32_t textlen, const PatChar* pat,
     }
 
     i = static_cast<uint32_t>(pos - text);
+
+    // Reject most false first-char hits by also checking the last char before
+    // comparing the whole pattern.
+    if (text[i + patlen - 1] != pat[patlen - 1]) {
+      i += 1;
+      continue;
+    }
+
     if (InnerMatch::match(pat + 1, text + i + 1, extent)) {
       return i;
     }
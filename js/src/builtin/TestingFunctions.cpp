@@ -40,11 +40,13 @@
 #  include "irregexp/RegExpEngine.h"
 #  include "irregexp/RegExpParser.h"
 #endif
+#include "frontend/Frontend2.h"  // js::frontend::Jsparagus
 #include "gc/Allocator.h"
 #include "gc/Zone.h"
 #include "jit/BaselineJIT.h"
 #include "jit/InlinableNatives.h"
 #include "jit/JitRealm.h"
+#include "jit/ProcessExecutableMemory.h"
 #include "js/Array.h"        // JS::NewArrayObject
 #include "js/ArrayBuffer.h"  // JS::{DetachArrayBuffer,GetArrayBufferLengthAndData,NewArrayBufferWithContents}
 #include "js/CharacterEncoding.h"
@@ -572,7 +574,10 @@ static bool MinorGC(JSContext* cx, unsigned argc, Value* vp) {
   _("pretenureGroupThreshold", JSGC_PRETENURE_GROUP_THRESHOLD, true)         \
   _("zoneAllocDelayKB", JSGC_ZONE_ALLOC_DELAY_KB, true)                      \
   _("mallocThresholdBase", JSGC_MALLOC_THRESHOLD_BASE, true)                 \
-  _("mallocGrowthFactor", JSGC_MALLOC_GROWTH_FACTOR, true)
+  _("mallocGrowthFactor", JSGC_MALLOC_GROWTH_FACTOR, true)                   \
+  _("nurseryPauseTargetUS", JSGC_NURSERY_PAUSE_TARGET_US, true)              \
+  _("decommitFreeArenas", JSGC_DECOMMIT_FREE_ARENAS, true)                   \
+  _("stringDeduplication", JSGC_STRING_DEDUPLICATION, true)
 
 static const struct ParamInfo {
   const char* name;
@@ -3056,6 +3061,79 @@ static bool testingFunc_inIon(JSContext* cx, unsigned argc, Value* vp) {
   return true;
 }
 
+static bool GetJitReprotectStats(JSContext* cx, unsigned argc, Value* vp) {
+  CallArgs args = CallArgsFromVp(argc, vp);
+
+  jit::ReprotectStats stats = jit::GetReprotectStats();
+
+  RootedObject obj(cx, JS_NewPlainObject(cx));
+  if (!obj) {
+    return false;
+  }
+
+  RootedValue value(cx, NumberValue(double(stats.count)));
+  if (!JS_DefineProperty(cx, obj, "count", value, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  value = NumberValue(double(stats.bytes));
+  if (!JS_DefineProperty(cx, obj, "bytes", value, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  value = NumberValue(stats.time.ToMilliseconds());
+  if (!JS_DefineProperty(cx, obj, "time", value, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  args.rval().setObject(*obj);
+  return true;
+}
+
+static bool GetJitBailoutStats(JSContext* cx, unsigned argc, Value* vp) {
+  CallArgs args = CallArgsFromVp(argc, vp);
+
+  RootedObject obj(cx, JS_NewPlainObject(cx));
+  if (!obj) {
+    return false;
+  }
+
+  RootedObject bailouts(cx, JS_NewPlainObject(cx));
+  if (!bailouts) {
+    return false;
+  }
+
+  jit::JitRuntime* jrt = cx->runtime()->jitRuntime();
+  RootedValue value(cx);
+  if (jrt) {
+    for (size_t i = 0; i < jit::BailoutKindCount; i++) {
+      jit::BailoutKind kind = jit::BailoutKind(i);
+      uint64_t count = jrt->bailoutCount(kind);
+      if (!count) {
+        continue;
+      }
+      value = NumberValue(double(count));
+      if (!JS_DefineProperty(cx, bailouts, jit::BailoutKindString(kind), value,
+                             JSPROP_ENUMERATE)) {
+        return false;
+      }
+    }
+  }
+
+  value = ObjectValue(*bailouts);
+  if (!JS_DefineProperty(cx, obj, "bailouts", value, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  value = NumberValue(jrt ? double(jrt->ionInvalidationCount()) : 0.0);
+  if (!JS_DefineProperty(cx, obj, "invalidations", value, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  args.rval().setObject(*obj);
+  return true;
+}
+
 bool js::testingFunc_assertFloat32(JSContext* cx, unsigned argc, Value* vp) {
   CallArgs args = CallArgsFromVp(argc, vp);
   if (args.length() != 2) {
@@ -3601,6 +3679,31 @@ static bool HelperThreadCount(JSContext* cx, unsigned argc, Value* vp) {
   return true;
 }
 
+static bool RustFrontendFallbackCounts(JSContext* cx, unsigned argc,
+                                       Value* vp) {
+  CallArgs args = CallArgsFromVp(argc, vp);
+
+  RootedObject counts(cx, JS_NewPlainObject(cx));
+  if (!counts) {
+    return false;
+  }
+
+  using frontend::Jsparagus;
+  using frontend::SmooshFallbackReason;
+
+  for (size_t i = 0; i < size_t(SmooshFallbackReason::Limit); i++) {
+    auto reason = SmooshFallbackReason(i);
+    RootedValue count(cx, NumberValue(Jsparagus::fallbackCount(reason)));
+    if (!JS_DefineProperty(cx, counts, Jsparagus::fallbackReasonName(reason),
+                           count, JSPROP_ENUMERATE)) {
+      return false;
+    }
+  }
+
+  args.rval().setObject(*counts);
+  return true;
+}
+
 static bool EnableShapeConsistencyChecks(JSContext* cx, unsigned argc,
                                          Value* vp) {
   CallArgs args = CallArgsFromVp(argc, vp);
@@ -6716,6 +6819,17 @@ gc::ZealModeHelpText),
 "  compilation to occur in the future. Conversely, a truthy value means that we are either in\n"
 "  ion or that there is litle or no chance of ion ever compiling the current script."),
 
+    JS_FN_HELP("jitReprotectStats", GetJitReprotectStats, 0, 0,
+"jitReprotectStats()",
+"  Return an object with the number of JIT code protection changes made by this\n"
+"  process, the number of bytes they covered and the total time (in ms) spent\n"
+"  in the system calls."),
+
+    JS_FN_HELP("jitBailoutStats", GetJitBailoutStats, 0, 0,
+"jitBailoutStats()",
+"  Return an object with the number of Ion bailouts of each kind taken in this\n"
+"  runtime, keyed by bailout kind name, and the number of Ion invalidations."),
+
     JS_FN_HELP("assertJitStackInvariants", TestingFunc_assertJitStackInvariants, 0, 0,
 "assertJitStackInvariants()",
 "  Iterates the Jit stack and check that stack invariants hold."),
@@ -6761,6 +6875,12 @@ gc::ZealModeHelpText),
 "helperThreadCount()",
 "  Returns the number of helper threads available for off-thread tasks."),
 
+    JS_FN_HELP("rustFrontendFallbackCounts", RustFrontendFallbackCounts, 0, 0,
+"rustFrontendFallbackCounts()",
+"  Returns an object mapping each reason for falling back from the Rust\n"
+"  frontend to the C++ frontend to the number of compilations in this process\n"
+"  that fell back for that reason."),
+
     JS_FN_HELP("enableShapeConsistencyChecks", EnableShapeConsistencyChecks, 0, 0,
 "enableShapeConsistencyChecks()",
 "  Enable some slow Shape assertions.\n"),
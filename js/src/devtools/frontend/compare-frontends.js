@@ -0,0 +1,91 @@
+/* -*- Mode: javascript; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Compile a corpus of scripts with both the C++ and the Rust frontend, and
+// print one tab-separated line per script, followed by totals.
+//
+// Usage:
+//   js compare-frontends.js [-n ITERATIONS] file1.js file2.js ...
+//
+// Times are the minimum over ITERATIONS compilations (default 5), in
+// milliseconds.  Scripts the Rust frontend doesn't support are reported as
+// "unsupported" and excluded from the totals.
+
+let iterations = 5;
+let files = [];
+for (let i = 0; i < scriptArgs.length; i++) {
+  if (scriptArgs[i] === "-n") {
+    iterations = Number(scriptArgs[++i]);
+  } else {
+    files.push(scriptArgs[i]);
+  }
+}
+
+if (files.length === 0) {
+  print("usage: compare-frontends.js [-n ITERATIONS] FILE...");
+  quit(1);
+}
+
+function measure(code) {
+  let best = null;
+  for (let i = 0; i < iterations; i++) {
+    let result = compareFrontends(code);
+    if (!best) {
+      best = result;
+      continue;
+    }
+    best.cpp.time = Math.min(best.cpp.time, result.cpp.time);
+    if (best.rust) {
+      best.rust.time = Math.min(best.rust.time, result.rust.time);
+    }
+  }
+  return best;
+}
+
+let totals = { cpp: 0, rust: 0, cppBytecode: 0, rustBytecode: 0 };
+let supported = 0;
+let mismatches = 0;
+
+print(["file", "cpp ms", "rust ms", "cpp bytes", "rust bytes",
+       "atoms", "disassembly"].join("\t"));
+
+for (let file of files) {
+  let result = measure(os.file.readFile(file));
+  if (!result.rust) {
+    print([file, result.cpp.time.toFixed(3), "unsupported"].join("\t"));
+    continue;
+  }
+
+  supported++;
+  totals.cpp += result.cpp.time;
+  totals.rust += result.rust.time;
+  totals.cppBytecode += result.cpp.bytecodeLength;
+  totals.rustBytecode += result.rust.bytecodeLength;
+
+  let dis = "n/a";
+  if ("disassemblyMatches" in result) {
+    dis = result.disassemblyMatches ? "same" : "DIFFERENT";
+    if (!result.disassemblyMatches) {
+      mismatches++;
+    }
+  }
+
+  print([file,
+         result.cpp.time.toFixed(3), result.rust.time.toFixed(3),
+         result.cpp.bytecodeLength, result.rust.bytecodeLength,
+         result.rust.atoms, dis].join("\t"));
+}
+
+print("");
+print(`supported: ${supported}/${files.length}`);
+print(`total cpp ms: ${totals.cpp.toFixed(3)}, rust ms: ${totals.rust.toFixed(3)}`);
+print(`total cpp bytes: ${totals.cppBytecode}, rust bytes: ${totals.rustBytecode}`);
+print(`disassembly mismatches: ${mismatches}`);
+
+let fallbacks = rustFrontendFallbackCounts();
+print("fallbacks: " + Object.keys(fallbacks)
+                            .filter(k => fallbacks[k])
+                            .map(k => `${k}=${fallbacks[k]}`)
+                            .join(", "));
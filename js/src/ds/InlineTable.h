@@ -219,6 +219,15 @@ class InlineTable : private AllocPolicy {
     inlCount_ = 0;
   }
 
+  void clearAndCompact() {
+    clear();
+    table_.clearAndCompact();
+  }
+
+  size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+    return table_.shallowSizeOfExcludingThis(mallocSizeOf);
+  }
+
   MOZ_ALWAYS_INLINE
   Ptr lookup(const Lookup& l) {
     MOZ_ASSERT(keyNonZero(l));
@@ -476,6 +485,12 @@ class InlineMap {
 
   void clear() { impl_.clear(); }
 
+  void clearAndCompact() { impl_.clearAndCompact(); }
+
+  size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+    return impl_.sizeOfExcludingThis(mallocSizeOf);
+  }
+
   Range all() const { return impl_.all(); }
 
   MOZ_ALWAYS_INLINE
@@ -580,6 +595,12 @@ class InlineSet {
 
   void clear() { impl_.clear(); }
 
+  void clearAndCompact() { impl_.clearAndCompact(); }
+
+  size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+    return impl_.sizeOfExcludingThis(mallocSizeOf);
+  }
+
   Range all() const { return impl_.all(); }
 
   MOZ_ALWAYS_INLINE
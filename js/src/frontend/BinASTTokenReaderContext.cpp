@@ -1245,6 +1245,11 @@ JS::Result<HuffmanLookup> BinASTTokenReaderContext::BitBuffer::getHuffmanLookup(
     // data are stored in the lowest indices, `bytes` is big endian.
     MOZ_TRY((owner.readBuf<Compression::No, EndOfFilePolicy::BestEffort>(
         bytes, readLen)));
+    if (readLen == 0) {
+      // We're at the end of the stream: there is nothing to merge, and the
+      // shifts below would be by 64 bits, which is UB for a uint64_t.
+      return HuffmanLookup(bits_, bitLength_);
+    }
     // Combine `bytes` array into `newBits`
     uint64_t newBits = (static_cast<uint64_t>(bytes[0]) << 56) |
                        (static_cast<uint64_t>(bytes[1]) << 48) |
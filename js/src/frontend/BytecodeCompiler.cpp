@@ -212,26 +212,36 @@ static JSScript* CreateGlobalScript(CompilationInfo& compilationInfo,
   return compilationInfo.script;
 }
 
+template <typename Unit>
+static JSScript* CompileGlobalScriptImpl(CompilationInfo& compilationInfo,
+                                         GlobalSharedContext& globalsc,
+                                         JS::SourceText<Unit>& srcBuf) {
+  if (compilationInfo.options.tryRustFrontend) {
+    bool unimplemented = false;
+    RootedScript script(compilationInfo.cx,
+                        Jsparagus::compileGlobalScript(compilationInfo, srcBuf,
+                                                       &unimplemented));
+    if (!unimplemented) {
+      if (script) {
+        tellDebuggerAboutCompiledScript(compilationInfo.cx, script);
+      }
+      return script;
+    }
+  }
+
+  return CreateGlobalScript(compilationInfo, globalsc, srcBuf);
+}
+
 JSScript* frontend::CompileGlobalScript(CompilationInfo& compilationInfo,
                                         GlobalSharedContext& globalsc,
                                         JS::SourceText<char16_t>& srcBuf) {
-  return CreateGlobalScript(compilationInfo, globalsc, srcBuf);
+  return CompileGlobalScriptImpl(compilationInfo, globalsc, srcBuf);
 }
 
 JSScript* frontend::CompileGlobalScript(CompilationInfo& compilationInfo,
                                         GlobalSharedContext& globalsc,
                                         JS::SourceText<Utf8Unit>& srcBuf) {
-  if (compilationInfo.cx->options().tryRustFrontend()) {
-    bool unimplemented = false;
-    auto script = Jsparagus::compileGlobalScript(compilationInfo, srcBuf, &unimplemented);
-    if (!unimplemented) {
-      return script;
-    }
-
-    fprintf(stderr, "Falling back!\n");
-  }
-
-  return CreateGlobalScript(compilationInfo, globalsc, srcBuf);
+  return CompileGlobalScriptImpl(compilationInfo, globalsc, srcBuf);
 }
 
 template <typename Unit>
@@ -1053,6 +1063,10 @@ static bool CompileLazyFunctionImpl(JSContext* cx, Handle<LazyScript*> lazy,
 
   CheckFlagsOnDelazification(lazy->immutableFlags(), script->immutableFlags());
 
+  if (cx->runtime()->recordDelazifications) {
+    lazy->scriptSource()->recordDelazification(lazy->toStringStart());
+  }
+
   delazificationCompletion.complete();
   assertException.reset();
   return true;
@@ -8112,11 +8112,13 @@ bool BytecodeEmitter::emitConditionalExpression(
 // ObjLiteral writer. We immediately rule out class bodies. Then, we ensure
 // that for each `prop: value` pair, the key is a constant name or numeric
 // index, there is no accessor specified, and the value can be encoded by an
-// ObjLiteral instruction (constant number, string, boolean, null/undefined).
+// ObjLiteral instruction (constant number, string, boolean, null/undefined,
+// or, if |allowNested|, a nested literal satisfying the same conditions).
 void BytecodeEmitter::isPropertyListObjLiteralCompatible(ListNode* obj,
                                                          PropListType type,
                                                          bool* withValues,
-                                                         bool* withoutValues) {
+                                                         bool* withoutValues,
+                                                         bool allowNested) {
   if (type == ClassBody) {
     *withValues = false;
     *withoutValues = false;
@@ -8175,7 +8177,7 @@ void BytecodeEmitter::isPropertyListObjLiteralCompatible(ListNode* obj,
       break;
     }
 
-    if (!isRHSObjLiteralCompatible(value)) {
+    if (!isRHSObjLiteralCompatible(value, allowNested)) {
       valuesOK = false;
     }
   }
@@ -8189,12 +8191,13 @@ void BytecodeEmitter::isPropertyListObjLiteralCompatible(ListNode* obj,
   *withoutValues = keysOK;
 }
 
-bool BytecodeEmitter::isArrayObjLiteralCompatible(ParseNode* arrayHead) {
+bool BytecodeEmitter::isArrayObjLiteralCompatible(ParseNode* arrayHead,
+                                                  bool allowNested) {
   for (ParseNode* elem = arrayHead; elem; elem = elem->pn_next) {
     if (elem->isKind(ParseNodeKind::Spread)) {
       return false;
     }
-    if (!isRHSObjLiteralCompatible(elem)) {
+    if (!isRHSObjLiteralCompatible(elem, allowNested)) {
       return false;
     }
   }
@@ -8533,6 +8536,31 @@ bool BytecodeEmitter::emitPropertyListObjLiteral(ListNode* obj,
   bool noValues = flags.contains(ObjLiteralFlag::NoValues);
   bool singleton = flags.contains(ObjLiteralFlag::Singleton);
 
+  if (!emitObjLiteralProperties(&data, obj, noValues)) {
+    return false;
+  }
+
+  uint32_t gcThingIndex = 0;
+  if (!perScriptData().gcThingList().append(std::move(data), &gcThingIndex)) {
+    return false;
+  }
+
+  bool isInnerSingleton = flags.contains(ObjLiteralFlag::IsInnerSingleton);
+
+  JSOp op = singleton
+                ? JSOp::Object
+                : isInnerSingleton ? JSOp::NewObjectWithGroup : JSOp::NewObject;
+  bool success = emitIndexOp(op, gcThingIndex);
+  if (!success) {
+    return false;
+  }
+
+  bytecodeSection().setStackDepth(stackDepth + 1);
+  return true;
+}
+
+bool BytecodeEmitter::emitObjLiteralProperties(ObjLiteralCreationData* data,
+                                               ListNode* obj, bool noValues) {
   for (ParseNode* propdef : obj->contents()) {
     MOZ_ASSERT(propdef->is<BinaryNode>());
     BinaryNode* prop = &propdef->as<BinaryNode>();
@@ -8541,10 +8569,15 @@ bool BytecodeEmitter::emitPropertyListObjLiteral(ListNode* obj,
 
     if (key->is<NameNode>()) {
       uint32_t propNameIndex = 0;
-      if (!data.addAtom(key->as<NameNode>().atom(), &propNameIndex)) {
+      if (!data->addAtom(key->as<NameNode>().atom(), &propNameIndex)) {
+        return false;
+      }
+      // Only reachable with huge nested literals.
+      if (!ObjLiteralWriter::atomIndexInRange(propNameIndex)) {
+        ReportAllocationOverflow(cx);
         return false;
       }
-      data.writer().setPropName(propNameIndex);
+      data->writer().setPropName(propNameIndex);
     } else {
       MOZ_ASSERT(key->is<NumericLiteral>());
       double numValue = key->as<NumericLiteral>().value();
@@ -8554,37 +8587,21 @@ bool BytecodeEmitter::emitPropertyListObjLiteral(ListNode* obj,
       MOZ_ASSERT(numIsInt);
       MOZ_ASSERT(
           ObjLiteralWriter::arrayIndexInRange(i));  // checked previously.
-      data.writer().setPropIndex(i);
+      data->writer().setPropIndex(i);
     }
 
     if (noValues) {
-      if (!data.writer().propWithUndefinedValue()) {
+      if (!data->writer().propWithUndefinedValue()) {
         return false;
       }
     } else {
       ParseNode* value = prop->right();
-      if (!emitObjLiteralValue(&data, value)) {
+      if (!emitObjLiteralValue(data, value)) {
         return false;
       }
     }
   }
 
-  uint32_t gcThingIndex = 0;
-  if (!perScriptData().gcThingList().append(std::move(data), &gcThingIndex)) {
-    return false;
-  }
-
-  bool isInnerSingleton = flags.contains(ObjLiteralFlag::IsInnerSingleton);
-
-  JSOp op = singleton
-                ? JSOp::Object
-                : isInnerSingleton ? JSOp::NewObjectWithGroup : JSOp::NewObject;
-  bool success = emitIndexOp(op, gcThingIndex);
-  if (!success) {
-    return false;
-  }
-
-  bytecodeSection().setStackDepth(stackDepth + 1);
   return true;
 }
 
@@ -8620,7 +8637,33 @@ bool BytecodeEmitter::emitObjLiteralArray(ParseNode* arrayHead, bool isCow) {
   return true;
 }
 
-bool BytecodeEmitter::isRHSObjLiteralCompatible(ParseNode* value) {
+bool BytecodeEmitter::isRHSObjLiteralCompatible(ParseNode* value,
+                                                bool allowNested) {
+  if (allowNested) {
+    // Nested literals are checked recursively. If we're too deep, just say
+    // no: the generic path will report the overrecursion if need be.
+    if (value->isKind(ParseNodeKind::ArrayExpr)) {
+      ListNode* array = &value->as<ListNode>();
+      return !array->hasNonConstInitializer() &&
+             CheckRecursionLimitDontReport(cx) &&
+             isArrayObjLiteralCompatible(array->head(),
+                                         /* allowNested = */ true);
+    }
+    if (value->isKind(ParseNodeKind::ObjectExpr)) {
+      ListNode* obj = &value->as<ListNode>();
+      if (obj->hasNonConstInitializer() ||
+          !CheckRecursionLimitDontReport(cx)) {
+        return false;
+      }
+      bool withValues = false;
+      bool withoutValues = false;
+      isPropertyListObjLiteralCompatible(obj, ObjectLiteral, &withValues,
+                                         &withoutValues,
+                                         /* allowNested = */ true);
+      return withValues;
+    }
+  }
+
   return value->isKind(ParseNodeKind::NumberExpr) ||
          value->isKind(ParseNodeKind::TrueExpr) ||
          value->isKind(ParseNodeKind::FalseExpr) ||
@@ -8632,7 +8675,7 @@ bool BytecodeEmitter::isRHSObjLiteralCompatible(ParseNode* value) {
 
 bool BytecodeEmitter::emitObjLiteralValue(ObjLiteralCreationData* data,
                                           ParseNode* value) {
-  MOZ_ASSERT(isRHSObjLiteralCompatible(value));
+  MOZ_ASSERT(isRHSObjLiteralCompatible(value, /* allowNested = */ true));
   if (value->isKind(ParseNodeKind::NumberExpr)) {
     double numValue = value->as<NumericLiteral>().value();
     int32_t i = 0;
@@ -8670,6 +8713,31 @@ bool BytecodeEmitter::emitObjLiteralValue(ObjLiteralCreationData* data,
     if (!data->writer().propWithAtomValue(valueAtomIndex)) {
       return false;
     }
+  } else if (value->isKind(ParseNodeKind::ArrayExpr)) {
+    // Nested literals get the flags they would have had as inner objects of
+    // a singleton: arrays are plain (non-COW) arrays, and objects have their
+    // group determined by their property names.
+    ObjLiteralWriter::NestedState state;
+    if (!data->writer().beginNested(ObjLiteralFlag::Array, &state)) {
+      return false;
+    }
+    data->writer().beginDenseArrayElements();
+    for (ParseNode* elem : value->as<ListNode>().contents()) {
+      if (!emitObjLiteralValue(data, elem)) {
+        return false;
+      }
+    }
+    data->writer().endNested(state);
+  } else if (value->isKind(ParseNodeKind::ObjectExpr)) {
+    ObjLiteralWriter::NestedState state;
+    if (!data->writer().beginNested(ObjLiteralFlag::SpecificGroup, &state)) {
+      return false;
+    }
+    if (!emitObjLiteralProperties(data, &value->as<ListNode>(),
+                                  /* noValues = */ false)) {
+      return false;
+    }
+    data->writer().endNested(state);
   } else {
     MOZ_CRASH("Unexpected parse node");
   }
@@ -8933,8 +9001,9 @@ MOZ_NEVER_INLINE bool BytecodeEmitter::emitObject(ListNode* objNode,
 
   bool useObjLiteral = false;
   bool useObjLiteralValues = false;
-  isPropertyListObjLiteralCompatible(objNode, ObjectLiteral,
-                                     &useObjLiteralValues, &useObjLiteral);
+  isPropertyListObjLiteralCompatible(
+      objNode, ObjectLiteral, &useObjLiteralValues, &useObjLiteral,
+      /* allowNested = */ isSingletonContext && !isInner);
 
   // We can't rely on the ObjLiteral-constructed object's values to be used if
   // we're only using ObjLiteral to build a template for JSOp::NewObject instead
@@ -9053,7 +9122,8 @@ bool BytecodeEmitter::emitArrayLiteral(ListNode* array) {
     static const size_t MinElementsForCopyOnWrite = 5;
     if (emitterMode != BytecodeEmitter::SelfHosting &&
         (array->count() >= MinElementsForCopyOnWrite || isSingleton) &&
-        isArrayObjLiteralCompatible(array->head())) {
+        isArrayObjLiteralCompatible(array->head(),
+                                    /* allowNested = */ isSingleton)) {
       return emitObjLiteralArray(array->head(), /* isCow = */ !isSingleton);
     }
   }
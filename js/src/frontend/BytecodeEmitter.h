@@ -497,22 +497,28 @@ struct MOZ_STACK_CLASS BytecodeEmitter {
 
   // Can we use the object-literal writer either in singleton-object mode (with
   // values) or in template mode (field names only, no values) for the property
-  // list?
+  // list? If |allowNested|, values may be nested object and array literals.
   void isPropertyListObjLiteralCompatible(ListNode* obj, PropListType type,
-                                          bool* withValues,
-                                          bool* withoutValues);
-  bool isArrayObjLiteralCompatible(ParseNode* arrayHead);
+                                          bool* withValues, bool* withoutValues,
+                                          bool allowNested = false);
+  bool isArrayObjLiteralCompatible(ParseNode* arrayHead,
+                                   bool allowNested = false);
 
   MOZ_MUST_USE bool emitPropertyList(ListNode* obj, PropertyEmitter& pe,
                                      PropListType type, bool isInner = false);
 
   MOZ_MUST_USE bool emitPropertyListObjLiteral(ListNode* obj, PropListType type,
                                                ObjLiteralFlags flags);
+  MOZ_MUST_USE bool emitObjLiteralProperties(ObjLiteralCreationData* data,
+                                             ListNode* obj, bool noValues);
 
   MOZ_MUST_USE bool emitObjLiteralArray(ParseNode* arrayHead, bool isCow);
 
-  // Is a field value OBJLITERAL-compatible?
-  MOZ_MUST_USE bool isRHSObjLiteralCompatible(ParseNode* value);
+  // Is a field value OBJLITERAL-compatible? Nested object and array literals
+  // are only compatible if |allowNested|, which must only be set when the
+  // result is used as the JSOp::Object of a run-once script.
+  MOZ_MUST_USE bool isRHSObjLiteralCompatible(ParseNode* value,
+                                              bool allowNested = false);
 
   MOZ_MUST_USE bool emitObjLiteralValue(ObjLiteralCreationData* data,
                                         ParseNode* value);
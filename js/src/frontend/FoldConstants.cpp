@@ -1281,6 +1281,284 @@ static bool FoldAdd(JSContext* cx, FullParseHandler* handler,
   return true;
 }
 
+// Literal kinds whose comparisons and string conversions can be computed at
+// parse time.
+enum class LiteralType { Number, String, Boolean, Null, Undefined, Unknown };
+
+static LiteralType GetLiteralType(ParseNode* pn) {
+  switch (pn->getKind()) {
+    case ParseNodeKind::NumberExpr:
+      return LiteralType::Number;
+
+    case ParseNodeKind::StringExpr:
+    case ParseNodeKind::TemplateStringExpr:
+      return LiteralType::String;
+
+    case ParseNodeKind::TrueExpr:
+    case ParseNodeKind::FalseExpr:
+      return LiteralType::Boolean;
+
+    case ParseNodeKind::NullExpr:
+      return LiteralType::Null;
+
+    case ParseNodeKind::RawUndefinedExpr:
+      return LiteralType::Undefined;
+
+    default:
+      return LiteralType::Unknown;
+  }
+}
+
+// ToNumber(pn) for a literal whose type is known.
+static bool LiteralToNumber(JSContext* cx, ParseNode* pn, double* result) {
+  switch (GetLiteralType(pn)) {
+    case LiteralType::Number:
+      *result = pn->as<NumericLiteral>().value();
+      return true;
+
+    case LiteralType::String:
+      return StringToNumber(cx, pn->as<NameNode>().atom(), result);
+
+    case LiteralType::Boolean:
+      *result = double(pn->isKind(ParseNodeKind::TrueExpr));
+      return true;
+
+    case LiteralType::Null:
+      *result = 0;
+      return true;
+
+    case LiteralType::Undefined:
+      *result = GenericNaN();
+      return true;
+
+    case LiteralType::Unknown:
+      break;
+  }
+  MOZ_CRASH("unexpected literal type");
+}
+
+// ToString(pn) for a literal whose type is known.
+static JSAtom* LiteralToAtom(JSContext* cx, ParseNode* pn) {
+  switch (GetLiteralType(pn)) {
+    case LiteralType::Number:
+      return pn->as<NumericLiteral>().toAtom(cx);
+
+    case LiteralType::String:
+      return pn->as<NameNode>().atom();
+
+    case LiteralType::Boolean:
+      return pn->isKind(ParseNodeKind::TrueExpr) ? cx->names().true_
+                                                 : cx->names().false_;
+
+    case LiteralType::Null:
+      return cx->names().null;
+
+    case LiteralType::Undefined:
+      return cx->names().undefined;
+
+    case LiteralType::Unknown:
+      break;
+  }
+  MOZ_CRASH("unexpected literal type");
+}
+
+// Compute |left <op> right| for two literals.  Sets *folded to false if the
+// result can't be determined at parse time.
+static bool ComputeComparison(JSContext* cx, ParseNodeKind kind,
+                              ParseNode* left, ParseNode* right, bool* folded,
+                              bool* result) {
+  *folded = false;
+
+  LiteralType leftType = GetLiteralType(left);
+  LiteralType rightType = GetLiteralType(right);
+  if (leftType == LiteralType::Unknown || rightType == LiteralType::Unknown) {
+    return true;
+  }
+
+  bool bothStrings =
+      leftType == LiteralType::String && rightType == LiteralType::String;
+
+  switch (kind) {
+    case ParseNodeKind::StrictEqExpr:
+    case ParseNodeKind::StrictNeExpr:
+    case ParseNodeKind::EqExpr:
+    case ParseNodeKind::NeExpr: {
+      bool isStrict = kind == ParseNodeKind::StrictEqExpr ||
+                      kind == ParseNodeKind::StrictNeExpr;
+      auto isNullish = [](LiteralType type) {
+        return type == LiteralType::Null || type == LiteralType::Undefined;
+      };
+
+      bool equal;
+      if (leftType == rightType) {
+        // Atoms are unique, so string equality is pointer equality.
+        if (bothStrings) {
+          equal = left->as<NameNode>().atom() == right->as<NameNode>().atom();
+        } else if (leftType == LiteralType::Number) {
+          equal = left->as<NumericLiteral>().value() ==
+                  right->as<NumericLiteral>().value();
+        } else {
+          equal = left->getKind() == right->getKind();
+        }
+      } else if (isStrict) {
+        equal = false;
+      } else if (isNullish(leftType) || isNullish(rightType)) {
+        // |null == undefined|, but neither is loosely equal to any other
+        // primitive.
+        equal = isNullish(leftType) && isNullish(rightType);
+      } else {
+        // Mixed numbers, strings and booleans compare as numbers.
+        double l, r;
+        if (!LiteralToNumber(cx, left, &l) || !LiteralToNumber(cx, right, &r)) {
+          return false;
+        }
+        equal = l == r;
+      }
+
+      bool isEq =
+          kind == ParseNodeKind::StrictEqExpr || kind == ParseNodeKind::EqExpr;
+      *result = isEq ? equal : !equal;
+      *folded = true;
+      return true;
+    }
+
+    case ParseNodeKind::LtExpr:
+    case ParseNodeKind::LeExpr:
+    case ParseNodeKind::GtExpr:
+    case ParseNodeKind::GeExpr: {
+      if (bothStrings) {
+        int32_t cmp = CompareAtoms(left->as<NameNode>().atom(),
+                                   right->as<NameNode>().atom());
+        *result = kind == ParseNodeKind::LtExpr   ? cmp < 0
+                  : kind == ParseNodeKind::LeExpr ? cmp <= 0
+                  : kind == ParseNodeKind::GtExpr ? cmp > 0
+                                                  : cmp >= 0;
+      } else {
+        // NaN operands make every relational comparison false, which the
+        // double comparisons below already get right.
+        double l, r;
+        if (!LiteralToNumber(cx, left, &l) || !LiteralToNumber(cx, right, &r)) {
+          return false;
+        }
+        *result = kind == ParseNodeKind::LtExpr   ? l < r
+                  : kind == ParseNodeKind::LeExpr ? l <= r
+                  : kind == ParseNodeKind::GtExpr ? l > r
+                                                  : l >= r;
+      }
+      *folded = true;
+      return true;
+    }
+
+    default:
+      MOZ_CRASH("unexpected comparison kind");
+  }
+}
+
+static bool FoldComparison(JSContext* cx, FullParseHandler* handler,
+                           ParseNode** nodePtr) {
+  ListNode* node = &(*nodePtr)->as<ListNode>();
+  MOZ_ASSERT(node->isKind(ParseNodeKind::StrictEqExpr) ||
+             node->isKind(ParseNodeKind::StrictNeExpr) ||
+             node->isKind(ParseNodeKind::EqExpr) ||
+             node->isKind(ParseNodeKind::NeExpr) ||
+             node->isKind(ParseNodeKind::LtExpr) ||
+             node->isKind(ParseNodeKind::LeExpr) ||
+             node->isKind(ParseNodeKind::GtExpr) ||
+             node->isKind(ParseNodeKind::GeExpr));
+  MOZ_ASSERT(node->count() >= 2);
+
+  // Comparisons are left-associative, so fold leading literal operands
+  // together one pair at a time:
+  //
+  //   (1 < 2 < 3)  becomes  (true < 3)  becomes  true
+  ParseNodeKind kind = node->getKind();
+  ParseNode** elem = node->unsafeHeadReference();
+  ParseNode** next = &(*elem)->pn_next;
+  while (*next) {
+    bool folded, result;
+    if (!ComputeComparison(cx, kind, *elem, *next, &folded, &result)) {
+      return false;
+    }
+    if (!folded) {
+      break;
+    }
+
+    TokenPos pos((*elem)->pn_pos.begin, (*next)->pn_pos.end);
+    if (!TryReplaceNode(elem, handler->newBooleanLiteral(result, pos))) {
+      return false;
+    }
+
+    (*elem)->pn_next = (*next)->pn_next;
+    next = &(*elem)->pn_next;
+    node->unsafeDecrementCount();
+  }
+
+  if (node->count() == 1) {
+    MOZ_ASSERT(node->head() == *elem);
+    MOZ_ASSERT((*elem)->isKind(ParseNodeKind::TrueExpr) ||
+               (*elem)->isKind(ParseNodeKind::FalseExpr));
+
+    if (!TryReplaceNode(nodePtr, *elem)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool FoldTemplateStringList(JSContext* cx, FullParseHandler* handler,
+                                   ParseNode** nodePtr) {
+  ListNode* node = &(*nodePtr)->as<ListNode>();
+  MOZ_ASSERT(node->isKind(ParseNodeKind::TemplateStringListExpr));
+
+  // Only fold templates whose substitutions are all literals:
+  //
+  //   `a${1}b${true}`  becomes  "a1btrue"
+  for (ParseNode* item : node->contents()) {
+    if (GetLiteralType(item) == LiteralType::Unknown) {
+      return true;
+    }
+  }
+
+  RootedString combination(cx, cx->names().empty);
+  RootedString tmp(cx);
+  for (ParseNode* item : node->contents()) {
+    tmp = LiteralToAtom(cx, item);
+    if (!tmp) {
+      return false;
+    }
+    combination = ConcatStrings<CanGC>(cx, combination, tmp);
+    if (!combination) {
+      return false;
+    }
+  }
+
+  JSAtom* atom = AtomizeString(cx, combination);
+  if (!atom) {
+    return false;
+  }
+  return TryReplaceNode(nodePtr, handler->newStringLiteral(atom, node->pn_pos));
+}
+
+static bool FoldVoid(JSContext* cx, FullParseHandler* handler,
+                     ParseNode** nodePtr) {
+  UnaryNode* node = &(*nodePtr)->as<UnaryNode>();
+  MOZ_ASSERT(node->isKind(ParseNodeKind::VoidExpr));
+
+  // |void <literal>| is just |undefined|.  Leave |void function() {}| alone:
+  // dropping the function node isn't worth the bookkeeping.
+  ParseNode* expr = node->kid();
+  if (GetLiteralType(expr) != LiteralType::Unknown ||
+      expr->isKind(ParseNodeKind::BigIntExpr)) {
+    if (!TryReplaceNode(nodePtr,
+                        handler->newRawUndefinedLiteral(node->pn_pos))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 class FoldVisitor : public RewritingParseNodeVisitor<FoldVisitor> {
   using Base = RewritingParseNodeVisitor;
 
@@ -1359,6 +1637,47 @@ class FoldVisitor : public RewritingParseNodeVisitor<FoldVisitor> {
     return Base::visitUrshExpr(pn) && FoldBinaryArithmetic(cx_, handler, &pn);
   }
 
+  bool visitStrictEqExpr(ParseNode*& pn) {
+    return Base::visitStrictEqExpr(pn) && FoldComparison(cx_, handler, &pn);
+  }
+
+  bool visitEqExpr(ParseNode*& pn) {
+    return Base::visitEqExpr(pn) && FoldComparison(cx_, handler, &pn);
+  }
+
+  bool visitStrictNeExpr(ParseNode*& pn) {
+    return Base::visitStrictNeExpr(pn) && FoldComparison(cx_, handler, &pn);
+  }
+
+  bool visitNeExpr(ParseNode*& pn) {
+    return Base::visitNeExpr(pn) && FoldComparison(cx_, handler, &pn);
+  }
+
+  bool visitLtExpr(ParseNode*& pn) {
+    return Base::visitLtExpr(pn) && FoldComparison(cx_, handler, &pn);
+  }
+
+  bool visitLeExpr(ParseNode*& pn) {
+    return Base::visitLeExpr(pn) && FoldComparison(cx_, handler, &pn);
+  }
+
+  bool visitGtExpr(ParseNode*& pn) {
+    return Base::visitGtExpr(pn) && FoldComparison(cx_, handler, &pn);
+  }
+
+  bool visitGeExpr(ParseNode*& pn) {
+    return Base::visitGeExpr(pn) && FoldComparison(cx_, handler, &pn);
+  }
+
+  bool visitTemplateStringListExpr(ParseNode*& pn) {
+    return Base::visitTemplateStringListExpr(pn) &&
+           FoldTemplateStringList(cx_, handler, &pn);
+  }
+
+  bool visitVoidExpr(ParseNode*& pn) {
+    return Base::visitVoidExpr(pn) && FoldVoid(cx_, handler, &pn);
+  }
+
   bool visitAndExpr(ParseNode*& pn) {
     // Note that this does result in the unfortunate fact that dead arms of this
     // node get constant folded. The same goes for visitOr and visitCoalesce.
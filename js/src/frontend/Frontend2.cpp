@@ -6,22 +6,41 @@
 
 #include "frontend/Frontend2.h"
 
-#include "mozilla/Span.h"  // mozilla::{Span, MakeSpan}
-
-#include <stddef.h>  // size_t
-#include <stdint.h>  // uint8_t, uint32_t
+#include "mozilla/Atomics.h"        // mozilla::Atomic
+#include "mozilla/CheckedInt.h"     // mozilla::CheckedInt
+#include "mozilla/HashFunctions.h"  // mozilla::{AddToHash, HashString}
+#include "mozilla/MemoryReporting.h"  // mozilla::MallocSizeOf
+#include "mozilla/RefPtr.h"         // RefPtr
+#include "mozilla/SHA1.h"           // mozilla::SHA1Sum
+#include "mozilla/Span.h"           // mozilla::{Span, MakeSpan}
+#include "mozilla/TextUtils.h"      // mozilla::{IsAscii, Utf16ValidUpTo}
+#include "mozilla/Utf8.h"           // mozilla::ConvertUtf16toUtf8
+
+#include <algorithm>  // std::min
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint8_t, uint32_t, UINT32_MAX
+#include <string.h>   // memcmp, memcpy
 
 #include "jsapi.h"
 
+#include "ds/LifoAlloc.h"                  // LifoAllocScope
 #include "frontend-rs/frontend-rs.h"  // CVec, JsparagusResult, JsparagusCompileOptions, free_jsparagus, run_jsparagus
 #include "frontend/CompilationInfo.h"      // CompilationInfo
 #include "frontend/SourceNotes.h"          // jssrcnote
 #include "gc/Rooting.h"                    // RootedScriptSourceObject
+#include "jit/JitSpewer.h"                 // JitSpewEnabled, JitSpewPrinter
+#include "js/AllocPolicy.h"                // SystemAllocPolicy
+#include "js/HashTable.h"                  // HashSet
 #include "js/HeapAPI.h"                    // JS::GCCellPtr
+#include "js/RefCounted.h"                 // AtomicRefCounted
 #include "js/RootingAPI.h"                 // JS::Handle
 #include "js/TypeDecls.h"                  // Rooted{Script,Value,String,Object}
-#include "vm/JSAtom.h"                     // AtomizeUTF8Chars
+#include "js/Vector.h"                     // Vector
+#include "threading/ExclusiveData.h"       // ExclusiveData
+#include "vm/BytecodeUtil.h"               // GetBytecodeLength, JOF_OPTYPE
+#include "vm/JSAtom.h"                     // Atomize, AtomizeUTF8Chars
 #include "vm/JSScript.h"                   // JSScript
+#include "vm/MutexIDs.h"                   // mutexid
 
 #include "vm/JSContext-inl.h"  // AutoKeepAtoms (used by BytecodeCompiler)
 
@@ -35,14 +54,139 @@ namespace js {
 
 namespace frontend {
 
+// Identifies the source and the options of a Rust frontend compilation.
+//
+// The source is identified by its SHA-1 digest and length, so that cache
+// entries don't need to keep a copy of it.  The only other input to
+// run_jsparagus is JsparagusCompileOptions, so its fields are the rest of the
+// key.  Everything else in the compile options, such as the filename and the
+// starting position, is only used when the result is instantiated.
+struct SmooshCompileKey {
+  mozilla::SHA1Sum::Hash digest;
+  size_t length = 0;
+  bool noScriptRval = false;
+  HashNumber hash = 0;
+
+  SmooshCompileKey(const uint8_t* bytes, size_t length,
+                   const JsparagusCompileOptions& options)
+      : length(length), noScriptRval(options.no_script_rval) {
+    mozilla::SHA1Sum sum;
+    while (length > 0) {
+      uint32_t chunk = uint32_t(std::min(length, size_t(UINT32_MAX)));
+      sum.update(bytes, chunk);
+      bytes += chunk;
+      length -= chunk;
+    }
+    sum.finish(digest);
+
+    // The first bytes of the digest are as good a hash as any.
+    HashNumber digestHash;
+    memcpy(&digestHash, digest, sizeof(digestHash));
+    hash = mozilla::AddToHash(digestHash, this->length, noScriptRval);
+  }
+
+  bool operator==(const SmooshCompileKey& other) const {
+    return hash == other.hash && length == other.length &&
+           noScriptRval == other.noScriptRval &&
+           memcmp(digest, other.digest, sizeof(digest)) == 0;
+  }
+};
+
+// The parts of a JsparagusResult that SmooshScriptStencil instantiates, copied
+// out of the buffers owned by the Rust frontend so that they can be shared by
+// later compilations of the same source, along with the key identifying the
+// source and the options.
+//
+// This is immutable once created, and can be used by several threads at once.
+class SmooshCompileResult : public AtomicRefCounted<SmooshCompileResult> {
+  SmooshCompileKey key_;
+
+  Vector<uint8_t, 0, SystemAllocPolicy> bytecode_;
+
+  // All strings, concatenated, and the offset of the end of each string.
+  Vector<char, 0, SystemAllocPolicy> stringChars_;
+  Vector<uint32_t, 0, SystemAllocPolicy> stringEnds_;
+
+  uint32_t maximumStackDepth_ = 0;
+  uint32_t numICEntries_ = 0;
+  uint32_t numBytecodeTypeSets_ = 0;
+
+ public:
+  explicit SmooshCompileResult(const SmooshCompileKey& key) : key_(key) {}
+
+  static RefPtr<SmooshCompileResult> create(const JsparagusResult& jsparagus,
+                                            const SmooshCompileKey& key) {
+    RefPtr<SmooshCompileResult> result = js_new<SmooshCompileResult>(key);
+    if (!result) {
+      return nullptr;
+    }
+
+    if (!result->bytecode_.append(jsparagus.bytecode.data,
+                                  jsparagus.bytecode.len)) {
+      return nullptr;
+    }
+
+    size_t natoms = jsparagus.strings.len;
+    if (!result->stringEnds_.reserve(natoms)) {
+      return nullptr;
+    }
+    for (size_t i = 0; i < natoms; i++) {
+      const CVec<uint8_t>& string = jsparagus.strings.data[i];
+      if (!result->stringChars_.append(
+              reinterpret_cast<const char*>(string.data), string.len)) {
+        return nullptr;
+      }
+      result->stringEnds_.infallibleAppend(result->stringChars_.length());
+    }
+
+    result->maximumStackDepth_ = jsparagus.maximum_stack_depth;
+    result->numICEntries_ = jsparagus.num_ic_entries;
+    result->numBytecodeTypeSets_ = jsparagus.num_type_sets;
+
+    return result;
+  }
+
+  const SmooshCompileKey& key() const { return key_; }
+
+  mozilla::Span<const uint8_t> bytecode() const {
+    return mozilla::MakeSpan(bytecode_.begin(), bytecode_.length());
+  }
+
+  uint32_t natoms() const { return stringEnds_.length(); }
+
+  mozilla::Span<const char> string(uint32_t index) const {
+    uint32_t start = index == 0 ? 0 : stringEnds_[index - 1];
+    return mozilla::MakeSpan(stringChars_.begin() + start,
+                             stringEnds_[index] - start);
+  }
+
+  uint32_t maximumStackDepth() const { return maximumStackDepth_; }
+  uint32_t numICEntries() const { return numICEntries_; }
+  uint32_t numBytecodeTypeSets() const { return numBytecodeTypeSets_; }
+
+  size_t sizeOfIncludingThis() const {
+    return sizeof(*this) + bytecode_.capacity() + stringChars_.capacity() +
+           stringEnds_.capacity() * sizeof(uint32_t);
+  }
+
+  size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+    return mallocSizeOf(this) +
+           bytecode_.sizeOfExcludingThis(mallocSizeOf) +
+           stringChars_.sizeOfExcludingThis(mallocSizeOf) +
+           stringEnds_.sizeOfExcludingThis(mallocSizeOf);
+  }
+};
+
 class SmooshScriptStencil : public ScriptStencil {
-  const JsparagusResult& jsparagus_;
+  const SmooshCompileResult& result_;
 
-  void init() {
-    lineno = 1;
-    column = 0;
+  void init(const JS::ReadOnlyCompileOptions& options) {
+    // JsparagusResult doesn't carry source notes yet, so every op maps to the
+    // script's starting position, as given by the embedding.
+    lineno = options.lineno;
+    column = options.column;
 
-    natoms = jsparagus_.strings.len;
+    natoms = result_.natoms();
 
     ngcthings = 1;
 
@@ -52,10 +196,10 @@ class SmooshScriptStencil : public ScriptStencil {
 
     mainOffset = 0;
     nfixed = 0;
-    nslots = nfixed + jsparagus_.maximum_stack_depth;
+    nslots = nfixed + result_.maximumStackDepth();
     bodyScopeIndex = 0;
-    numICEntries = jsparagus_.num_ic_entries;
-    numBytecodeTypeSets = jsparagus_.num_type_sets;
+    numICEntries = result_.numICEntries();
+    numBytecodeTypeSets = result_.numBytecodeTypeSets();
 
     strict = false;
     bindingsAccessedDynamically = false;
@@ -67,14 +211,15 @@ class SmooshScriptStencil : public ScriptStencil {
     needsFunctionEnvironmentObjects = false;
     hasModuleGoal = false;
 
-    code = mozilla::MakeSpan(jsparagus_.bytecode.data, jsparagus_.bytecode.len);
+    code = result_.bytecode();
     MOZ_ASSERT(notes.IsEmpty());
   }
 
  public:
-  explicit SmooshScriptStencil(const JsparagusResult& jsparagus)
-      : jsparagus_(jsparagus) {
-    init();
+  SmooshScriptStencil(const SmooshCompileResult& result,
+                      const JS::ReadOnlyCompileOptions& options)
+      : result_(result) {
+    init(options);
   }
 
   virtual bool finishGCThings(JSContext* cx,
@@ -85,8 +230,21 @@ class SmooshScriptStencil : public ScriptStencil {
 
   virtual bool initAtomMap(JSContext* cx, GCPtrAtom* atoms) const {
     for (uint32_t i = 0; i < natoms; i++) {
-      const CVec<uint8_t>& string = jsparagus_.strings.data[i];
-      JSAtom* atom = AtomizeUTF8Chars(cx, (const char*)string.data, string.len);
+      mozilla::Span<const char> string = result_.string(i);
+
+      // Nearly all identifiers and string literals are ASCII.  These can be
+      // atomized as Latin-1, which hashes and copies the bytes directly
+      // instead of first decoding them to compute the length, the smallest
+      // encoding, and the hash, and then decoding them again to copy.
+      //
+      // Both paths look up the permanent atoms before the runtime's atoms
+      // table.
+      JSAtom* atom;
+      if (mozilla::IsAscii(string)) {
+        atom = Atomize(cx, string.Elements(), string.Length());
+      } else {
+        atom = AtomizeUTF8Chars(cx, string.Elements(), string.Length());
+      }
       if (!atom) {
         return false;
       }
@@ -106,6 +264,56 @@ class SmooshScriptStencil : public ScriptStencil {
   virtual void finishInnerFunctions() const {}
 };
 
+// SmooshScriptStencil above only knows how to instantiate a top-level script
+// whose sole GC thing is the global scope, and which has no scope notes, try
+// notes or resume offsets, because JsparagusResult doesn't carry any of these
+// yet.  Check that the emitted bytecode doesn't need anything else, so that
+// any script which does falls back to the C++ frontend instead of being
+// instantiated with missing data.
+static bool CanInstantiateSmooshBytecode(const JsparagusResult& jsparagus,
+                                         SmooshFallbackReason* reason) {
+  jsbytecode* pc = jsparagus.bytecode.data;
+  jsbytecode* end = pc + jsparagus.bytecode.len;
+  size_t natoms = jsparagus.strings.len;
+
+  while (pc < end) {
+    MOZ_RELEASE_ASSERT(*pc < JSOP_LIMIT);
+    JSOp op = JSOp(*pc);
+    unsigned length = GetBytecodeLength(pc);
+    MOZ_RELEASE_ASSERT(length <= size_t(end - pc));
+
+    switch (JOF_OPTYPE(op)) {
+      case JOF_ATOM:
+        MOZ_RELEASE_ASSERT(GET_UINT32_INDEX(pc) < natoms);
+        break;
+      case JOF_OBJECT:
+      case JOF_REGEXP:
+      case JOF_BIGINT:
+      case JOF_CLASS_CTOR:
+        *reason = SmooshFallbackReason::GCThing;
+        return false;
+      case JOF_SCOPE:
+        *reason = SmooshFallbackReason::Scope;
+        return false;
+      case JOF_RESUMEINDEX:
+      case JOF_TABLESWITCH:
+        *reason = SmooshFallbackReason::ResumeOffset;
+        return false;
+      default:
+        break;
+    }
+
+    if (op == JSOp::Try || op == JSOp::TryDestructuring) {
+      *reason = SmooshFallbackReason::Try;
+      return false;
+    }
+
+    pc += length;
+  }
+
+  return true;
+}
+
 // Free given JsparagusResult on leaving scope.
 class AutoFreeJsparagusResult {
   JsparagusResult* result_;
@@ -121,6 +329,276 @@ class AutoFreeJsparagusResult {
   }
 };
 
+// Process-wide cache of Rust frontend output, keyed by the source and the
+// options passed to run_jsparagus.  Embeddings often evaluate the
+// same bootstrap scripts over and over again, in many workers; each
+// compilation after the first instantiates the cached bytecode and atoms
+// without parsing.
+//
+// Only results that SmooshScriptStencil can instantiate are cached.  Once the
+// cache holds more than MaxSize bytes, it's simply cleared.  It's also cleared
+// by shrinking GCs, see GCRuntime::purgeRuntime.
+class SmooshCompileCache {
+  struct Hasher {
+    using Lookup = SmooshCompileKey;
+    static HashNumber hash(const Lookup& lookup) { return lookup.hash; }
+    static bool match(const RefPtr<SmooshCompileResult>& entry,
+                      const Lookup& lookup) {
+      return entry->key() == lookup;
+    }
+  };
+
+  using Set =
+      HashSet<RefPtr<SmooshCompileResult>, Hasher, SystemAllocPolicy>;
+
+  static const size_t MaxSize = 16 * 1024 * 1024;
+
+  Set set_;
+  size_t size_ = 0;
+
+ public:
+  RefPtr<SmooshCompileResult> lookup(const SmooshCompileKey& lookup) const {
+    if (Set::Ptr p = set_.lookup(lookup)) {
+      return *p;
+    }
+    return nullptr;
+  }
+
+  void clear() {
+    set_.clear();
+    size_ = 0;
+  }
+
+  size_t count() const { return set_.count(); }
+
+  size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+    size_t n = set_.shallowSizeOfExcludingThis(mallocSizeOf);
+    for (Set::Range r = set_.all(); !r.empty(); r.popFront()) {
+      n += r.front()->sizeOfIncludingThis(mallocSizeOf);
+    }
+    return n;
+  }
+
+  // Failure to add an entry isn't an error.
+  void put(const SmooshCompileKey& lookup,
+           const RefPtr<SmooshCompileResult>& result) {
+    size_t size = result->sizeOfIncludingThis();
+    if (size > MaxSize) {
+      return;
+    }
+    if (size_ + size > MaxSize) {
+      clear();
+    }
+
+    Set::AddPtr p = set_.lookupForAdd(lookup);
+    if (p) {
+      // Another thread compiled the same source meanwhile.
+      return;
+    }
+    if (set_.add(p, result)) {
+      size_ += size;
+    }
+  }
+};
+
+static ExclusiveData<SmooshCompileCache>* sCompileCache = nullptr;
+
+bool InitSmooshCompileCache() {
+  MOZ_ASSERT(!sCompileCache, "we should be initializing only once");
+
+  sCompileCache =
+      js_new<ExclusiveData<SmooshCompileCache>>(mutexid::SmooshCompileCache);
+  return !!sCompileCache;
+}
+
+void FinishSmooshCompileCache() {
+  js_delete(sCompileCache);
+  sCompileCache = nullptr;
+}
+
+static mozilla::Atomic<uint32_t, mozilla::Relaxed>
+    sFallbackCounts[size_t(SmooshFallbackReason::Limit)];
+
+static void CountFallback(SmooshFallbackReason reason, bool countFallbacks) {
+  if (countFallbacks) {
+    sFallbackCounts[size_t(reason)]++;
+  }
+}
+
+/* static */
+void Jsparagus::clearCompileCache() { sCompileCache->lock()->clear(); }
+
+/* static */
+size_t Jsparagus::compileCacheCount() { return sCompileCache->lock()->count(); }
+
+/* static */
+size_t Jsparagus::sizeOfCompileCache(mozilla::MallocSizeOf mallocSizeOf) {
+  auto cache = sCompileCache->lock();
+  return mallocSizeOf(sCompileCache) + cache->sizeOfExcludingThis(mallocSizeOf);
+}
+
+/* static */
+uint32_t Jsparagus::fallbackCount(SmooshFallbackReason reason) {
+  MOZ_ASSERT(reason < SmooshFallbackReason::Limit);
+  return sFallbackCounts[size_t(reason)];
+}
+
+/* static */
+const char* Jsparagus::fallbackReasonName(SmooshFallbackReason reason) {
+  switch (reason) {
+#define REASON_NAME(name, str)       \
+  case SmooshFallbackReason::name: \
+    return str;
+    FOR_EACH_SMOOSH_FALLBACK_REASON(REASON_NAME)
+#undef REASON_NAME
+    case SmooshFallbackReason::Limit:
+      break;
+  }
+  MOZ_CRASH("Bad SmooshFallbackReason");
+}
+
+template <typename Unit>
+static bool IsIdentifierStartUnit(Unit c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+         c == '$' || c >= 0x80;
+}
+
+template <typename Unit>
+static bool IsIdentifierPartUnit(Unit c) {
+  return IsIdentifierStartUnit(c) || (c >= '0' && c <= '9');
+}
+
+template <typename Unit, size_t N>
+static bool WordEquals(const Unit* word, size_t length,
+                       const char (&keyword)[N]) {
+  if (length != N - 1) {
+    return false;
+  }
+  for (size_t i = 0; i < N - 1; i++) {
+    if (word[i] != Unit(keyword[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Quickly scan the source for syntax that SmooshScriptStencil can't represent
+// yet, so that such scripts go directly to the C++ frontend instead of being
+// parsed twice.
+//
+// This isn't a tokenizer: string literals and comments are skipped, but
+// everything else (including template and RegExp literals) is scanned as
+// code.  A false positive only means we use the C++ frontend for a script the
+// Rust frontend could have handled, and a false negative means run_jsparagus
+// reports |unimplemented| as it did before this scan existed.
+//
+// |Unit| is uint8_t for UTF-8 source and char16_t for UTF-16 source.  Only
+// ASCII units are significant, so both are scanned without decoding.
+template <typename Unit>
+static bool PrescanForUnsupportedSyntax(const Unit* units, size_t length,
+                                        SmooshFallbackReason* reason) {
+  const Unit* p = units;
+  const Unit* end = units + length;
+
+  while (p < end) {
+    Unit c = *p;
+
+    if (IsIdentifierStartUnit(c)) {
+      const Unit* word = p;
+      while (p < end && IsIdentifierPartUnit(*p)) {
+        p++;
+      }
+      size_t wordLength = p - word;
+
+      if (WordEquals(word, wordLength, "function")) {
+        *reason = SmooshFallbackReason::Function;
+        return true;
+      }
+      if (WordEquals(word, wordLength, "try")) {
+        *reason = SmooshFallbackReason::Try;
+        return true;
+      }
+      if (WordEquals(word, wordLength, "class")) {
+        *reason = SmooshFallbackReason::Class;
+        return true;
+      }
+      if (WordEquals(word, wordLength, "let") ||
+          WordEquals(word, wordLength, "const")) {
+        *reason = SmooshFallbackReason::LexicalDeclaration;
+        return true;
+      }
+      continue;
+    }
+
+    if (c >= '0' && c <= '9') {
+      // Skip numeric literals, so that suffixes like the `e` in `1e3` or the
+      // `x` in `0xff` aren't mistaken for identifiers.
+      while (p < end && IsIdentifierPartUnit(*p)) {
+        p++;
+      }
+      continue;
+    }
+
+    if (c == '=' && p + 1 < end && p[1] == '>') {
+      *reason = SmooshFallbackReason::Function;
+      return true;
+    }
+
+    if (c == '"' || c == '\'') {
+      // Unterminated literals and trailing backslashes must not step past
+      // |end|.
+      p++;
+      while (p < end && *p != c && *p != '\n') {
+        if (*p == '\\' && end - p >= 2) {
+          p += 2;
+        } else {
+          p++;
+        }
+      }
+      if (p < end) {
+        p++;
+      }
+      continue;
+    }
+
+    if (c == '/' && p + 1 < end) {
+      if (p[1] == '/') {
+        p += 2;
+        while (p < end && *p != '\n') {
+          p++;
+        }
+        continue;
+      }
+      if (p[1] == '*') {
+        p += 2;
+        while (p + 1 < end && !(p[0] == '*' && p[1] == '/')) {
+          p++;
+        }
+        p = end - p >= 2 ? p + 2 : end;
+        continue;
+      }
+    }
+
+    p++;
+  }
+
+  return false;
+}
+
+/* static */
+bool Jsparagus::prescanForUnsupportedSyntax(const uint8_t* units,
+                                            size_t length,
+                                            SmooshFallbackReason* reason) {
+  return PrescanForUnsupportedSyntax(units, length, reason);
+}
+
+/* static */
+bool Jsparagus::prescanForUnsupportedSyntax(const char16_t* units,
+                                            size_t length,
+                                            SmooshFallbackReason* reason) {
+  return PrescanForUnsupportedSyntax(units, length, reason);
+}
+
 void ReportVisageCompileError(JSContext* cx, ErrorMetadata&& metadata,
                               int errorNumber, ...) {
   va_list args;
@@ -130,81 +608,207 @@ void ReportVisageCompileError(JSContext* cx, ErrorMetadata&& metadata,
   va_end(args);
 }
 
-/* static */
-JSScript* Jsparagus::compileGlobalScript(CompilationInfo& compilationInfo,
-                                         JS::SourceText<Utf8Unit>& srcBuf,
+// Check the options and the source for anything the Rust frontend or
+// SmooshScriptStencil doesn't support yet.
+template <typename Unit>
+static bool CanTrySmoosh(const JS::ReadOnlyCompileOptions& options,
+                         const Unit* units, size_t length,
+                         SmooshFallbackReason* reason) {
+  // The stencil below always uses the empty global scope, so anything that
+  // needs a different enclosing scope must go through the C++ frontend.
+  if (options.nonSyntacticScope) {
+    *reason = SmooshFallbackReason::NonSyntacticScope;
+    return false;
+  }
+
+  return !PrescanForUnsupportedSyntax(units, length, reason);
+}
+
+// Compile the UTF-8 text |bytes|, which is either the content of |srcBuf| or
+// its transcoding to UTF-8.  |srcBuf| is the source retained by the script.
+template <typename Unit>
+static JSScript* CompileGlobalScriptImpl(CompilationInfo& compilationInfo,
+                                         JS::SourceText<Unit>& srcBuf,
+                                         const uint8_t* bytes, size_t length,
+                                         bool countFallbacks,
                                          bool* unimplemented) {
   // FIXME: check info members and return with *unimplemented = true
   //        if any field doesn't match to run_jsparagus.
 
-  auto bytes = reinterpret_cast<const uint8_t*>(srcBuf.get());
-  size_t length = srcBuf.length();
-
+  const auto& options = compilationInfo.options;
   JSContext* cx = compilationInfo.cx;
 
-  const auto& options = compilationInfo.options;
   JsparagusCompileOptions compileOptions;
   compileOptions.no_script_rval = options.noScriptRval;
 
-  JsparagusResult jsparagus = run_jsparagus(bytes, length, &compileOptions);
-  AutoFreeJsparagusResult afjr(&jsparagus);
-
-  if (jsparagus.error.data) {
-    *unimplemented = false;
-    ErrorMetadata metadata;
-    metadata.filename = "<unknown>";
-    metadata.lineNumber = 1;
-    metadata.columnNumber = 0;
-    metadata.isMuted = false;
-    ReportVisageCompileError(
-        cx, std::move(metadata), JSMSG_VISAGE_COMPILE_ERROR,
-        reinterpret_cast<const char*>(jsparagus.error.data));
-    return nullptr;
+  SmooshCompileKey key(bytes, length, compileOptions);
+  RefPtr<SmooshCompileResult> result = sCompileCache->lock()->lookup(key);
+
+  if (!result) {
+    // run_jsparagus doesn't touch the GC heap or the JSContext, so this is
+    // safe to run on helper thread contexts.  Only the GC-thing instantiation
+    // below needs the (possibly off-thread parse) realm, and anything
+    // allocated there is merged into the target realm by
+    // FinishOffThreadScript.
+    JsparagusResult jsparagus = run_jsparagus(bytes, length, &compileOptions);
+    AutoFreeJsparagusResult afjr(&jsparagus);
+
+    if (jsparagus.error.data) {
+      *unimplemented = false;
+      ErrorMetadata metadata;
+      metadata.filename =
+          options.filename() ? options.filename() : "<unknown>";
+      // The error doesn't carry its offset yet, so report the start of the
+      // script rather than a fixed line 1.
+      metadata.lineNumber = options.lineno;
+      metadata.columnNumber = options.column;
+      metadata.isMuted = options.mutedErrors();
+      ReportVisageCompileError(
+          cx, std::move(metadata), JSMSG_VISAGE_COMPILE_ERROR,
+          reinterpret_cast<const char*>(jsparagus.error.data));
+      return nullptr;
+    }
+
+    if (jsparagus.unimplemented) {
+      CountFallback(SmooshFallbackReason::Unimplemented, countFallbacks);
+      *unimplemented = true;
+      return nullptr;
+    }
+
+    SmooshFallbackReason reason;
+    if (!CanInstantiateSmooshBytecode(jsparagus, &reason)) {
+      CountFallback(reason, countFallbacks);
+      *unimplemented = true;
+      return nullptr;
+    }
+
+    result = SmooshCompileResult::create(jsparagus, key);
+    if (!result) {
+      *unimplemented = false;
+      ReportOutOfMemory(cx);
+      return nullptr;
+    }
+
+    sCompileCache->lock()->put(key, result);
   }
 
-  if (jsparagus.unimplemented) {
-    *unimplemented = true;
+  *unimplemented = false;
+
+  // Use the source object created by CompilationInfo::init.  For off-thread
+  // compilation it is registered with the ParseTask, which finishes its
+  // initialization once the parse realm has been merged.
+  RootedScriptSourceObject sso(cx, compilationInfo.sourceObject);
+  MOZ_ASSERT(sso);
+
+  if (!compilationInfo.assignSource(srcBuf)) {
     return nullptr;
   }
 
-  *unimplemented = false;
+  // Script extents are in code units of the retained source.
+  uint32_t sourceLength = srcBuf.length();
+  RootedScript script(
+      cx, JSScript::Create(cx, cx->global(), options, sso, 0, sourceLength, 0,
+                           sourceLength, options.lineno, options.column));
+  if (!script) {
+    return nullptr;
+  }
 
-  RootedScriptSourceObject sso(cx,
-                               frontend::CreateScriptSourceObject(cx, options));
-  if (!sso) {
+  SmooshScriptStencil stencil(*result, options);
+  if (!JSScript::fullyInitFromStencil(cx, script, stencil)) {
     return nullptr;
   }
 
-  RootedObject proto(cx);
-  if (!GetFunctionPrototype(cx, GeneratorKind::NotGenerator,
-                            FunctionAsyncKind::SyncFunction, &proto)) {
+#ifdef JS_JITSPEW
+  if (jit::JitSpewEnabled(jit::JitSpew_Smoosh)) {
+    Sprinter sprinter(cx);
+    if (!sprinter.init()) {
+      return nullptr;
+    }
+    if (!Disassemble(cx, script, true, &sprinter,
+                     DisassembleSkeptically::Yes)) {
+      return nullptr;
+    }
+    jit::JitSpewPrinter().put(sprinter.string());
+    jit::JitSpewPrinter().put("\n");
+  }
+#endif
+
+  compilationInfo.script = script;
+  return script;
+}
+
+/* static */
+JSScript* Jsparagus::compileGlobalScript(CompilationInfo& compilationInfo,
+                                         JS::SourceText<Utf8Unit>& srcBuf,
+                                         bool* unimplemented,
+                                         bool countFallbacks) {
+  auto bytes = reinterpret_cast<const uint8_t*>(srcBuf.get());
+  size_t length = srcBuf.length();
+
+  SmooshFallbackReason reason;
+  if (!CanTrySmoosh(compilationInfo.options, bytes, length, &reason)) {
+    CountFallback(reason, countFallbacks);
+    *unimplemented = true;
     return nullptr;
   }
 
-  RootedScript script(cx, JSScript::Create(cx, cx->global(), options, sso, 0,
-                                           length, 0, length, 1, 0));
+  return CompileGlobalScriptImpl(compilationInfo, srcBuf, bytes, length,
+                                 countFallbacks, unimplemented);
+}
+
+/* static */
+JSScript* Jsparagus::compileGlobalScript(CompilationInfo& compilationInfo,
+                                         JS::SourceText<char16_t>& srcBuf,
+                                         bool* unimplemented,
+                                         bool countFallbacks) {
+  const char16_t* chars = srcBuf.get();
+  size_t length = srcBuf.length();
 
-  SmooshScriptStencil stencil(jsparagus);
-  if (!JSScript::fullyInitFromStencil(cx, script, stencil)) {
+  // Scan the UTF-16 text directly, so that scripts which would fall back
+  // anyway aren't transcoded.
+  SmooshFallbackReason reason;
+  if (!CanTrySmoosh(compilationInfo.options, chars, length, &reason)) {
+    CountFallback(reason, countFallbacks);
+    *unimplemented = true;
     return nullptr;
   }
 
-#if defined(DEBUG) || defined(JS_JITSPEW)
-  Sprinter sprinter(cx);
-  if (!sprinter.init()) {
+  // Lone surrogates can't be represented in UTF-8, and replacing them would
+  // change the value of string literals containing them.
+  if (mozilla::Utf16ValidUpTo(mozilla::MakeSpan(chars, length)) != length) {
+    CountFallback(SmooshFallbackReason::LoneSurrogate, countFallbacks);
+    *unimplemented = true;
     return nullptr;
   }
-  if (!Disassemble(cx, script, true, &sprinter, DisassembleSkeptically::Yes)) {
+
+  // run_jsparagus only accepts UTF-8, so transcode into a temporary buffer.
+  // The SIMD transcoder needs up to three bytes per code unit.
+  JSContext* cx = compilationInfo.cx;
+  mozilla::CheckedInt<size_t> utf8Capacity(length);
+  utf8Capacity *= 3;
+  if (!utf8Capacity.isValid()) {
+    ReportAllocationOverflow(cx);
     return nullptr;
   }
-  printf("%s\n", sprinter.string());
-  if (!Disassemble(cx, script, true, &sprinter, DisassembleSkeptically::No)) {
+
+  // Allocate the buffer from the context's temporary LifoAlloc, which is kept
+  // across compilations (and reported by the memory reporters), rather than
+  // paying for a malloc/free pair on every compile.  The scope releases it as
+  // soon as the compilation is done.
+  LifoAllocScope utf8Scope(&cx->tempLifoAlloc());
+  char* utf8 =
+      utf8Scope.alloc().newArrayUninitialized<char>(utf8Capacity.value());
+  if (!utf8) {
+    ReportOutOfMemory(cx);
     return nullptr;
   }
-  // (don't bother printing it)
-#endif
+  size_t utf8Length = mozilla::ConvertUtf16toUtf8(
+      mozilla::MakeSpan(chars, length),
+      mozilla::MakeSpan(utf8, utf8Capacity.value()));
 
-  return script;
+  return CompileGlobalScriptImpl(compilationInfo, srcBuf,
+                                 reinterpret_cast<const uint8_t*>(utf8),
+                                 utf8Length, countFallbacks, unimplemented);
 }
 
 bool RustParseScript(JSContext* cx, const uint8_t* bytes, size_t length) {
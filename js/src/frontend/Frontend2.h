@@ -7,7 +7,8 @@
 #ifndef frontend_Frontend2_h
 #define frontend_Frontend2_h
 
-#include "mozilla/Utf8.h"  // mozilla::Utf8Unit
+#include "mozilla/MemoryReporting.h"  // mozilla::MallocSizeOf
+#include "mozilla/Utf8.h"             // mozilla::Utf8Unit
 
 #include <stddef.h>  // size_t
 #include <stdint.h>  // uint8_t
@@ -28,15 +29,75 @@ namespace frontend {
 
 class GlobalScriptInfo;
 
+// Reasons for falling back from the Rust frontend to the C++ frontend.
+//
+// `NonSyntacticScope`, `Function`, `Try`, `Class` and `LexicalDeclaration` are
+// detected before calling into the Rust frontend, so that the source is parsed
+// only once for them.  `GCThing`, `Scope` and `ResumeOffset` are detected by
+// checking the emitted bytecode for data that can't be instantiated yet.
+// `LoneSurrogate` is for UTF-16 source which can't be transcoded to UTF-8
+// losslessly.  `Unimplemented` is reported by the Rust frontend itself.
+#define FOR_EACH_SMOOSH_FALLBACK_REASON(MACRO)   \
+  MACRO(NonSyntacticScope, "nonSyntacticScope") \
+  MACRO(Function, "function")                   \
+  MACRO(Try, "try")                             \
+  MACRO(Class, "class")                         \
+  MACRO(LexicalDeclaration, "lexical")          \
+  MACRO(GCThing, "gcThing")                     \
+  MACRO(Scope, "scope")                         \
+  MACRO(ResumeOffset, "resumeOffset")           \
+  MACRO(LoneSurrogate, "loneSurrogate")         \
+  MACRO(Unimplemented, "unimplemented")
+
+enum class SmooshFallbackReason : uint8_t {
+#define DEFINE_REASON(name, str) name,
+  FOR_EACH_SMOOSH_FALLBACK_REASON(DEFINE_REASON)
+#undef DEFINE_REASON
+      Limit
+};
+
 // This is declarated as a class mostly to solve dependency around `friend`
 // declarations in the simple way.
 class Jsparagus {
  public:
+  // If |countFallbacks| is false, falling back isn't recorded in
+  // fallbackCount(), so that testing functions don't skew the statistics of
+  // real compilations.
   static JSScript* compileGlobalScript(
       CompilationInfo& compilationInfo, JS::SourceText<mozilla::Utf8Unit>& srcBuf,
-      bool* unimplemented);
+      bool* unimplemented, bool countFallbacks = true);
+  static JSScript* compileGlobalScript(CompilationInfo& compilationInfo,
+                                       JS::SourceText<char16_t>& srcBuf,
+                                       bool* unimplemented,
+                                       bool countFallbacks = true);
+
+  // Check the UTF-8 or UTF-16 source for syntax which always falls back to
+  // the C++ frontend.  If any is found, return true and set |*reason|.
+  static bool prescanForUnsupportedSyntax(const uint8_t* units, size_t length,
+                                          SmooshFallbackReason* reason);
+  static bool prescanForUnsupportedSyntax(const char16_t* units,
+                                          size_t length,
+                                          SmooshFallbackReason* reason);
+
+  // Drop everything from the process-wide cache of Rust frontend output.
+  // This is done by shrinking GCs.
+  static void clearCompileCache();
+
+  // The number of entries in the cache, and the memory used by it.
+  static size_t compileCacheCount();
+  static size_t sizeOfCompileCache(mozilla::MallocSizeOf mallocSizeOf);
+
+  // Number of compilations, across all runtimes in the process, that fell
+  // back to the C++ frontend for the given reason.
+  static uint32_t fallbackCount(SmooshFallbackReason reason);
+  static const char* fallbackReasonName(SmooshFallbackReason reason);
 };
 
+// Create and destroy the process-wide cache of Rust frontend output, from
+// JS_Init and JS_ShutDown.
+MOZ_MUST_USE bool InitSmooshCompileCache();
+void FinishSmooshCompileCache();
+
 // Use the Rust frontend to parse and free the generated AST. Returns true if no
 // error were detected while parsing.
 MOZ_MUST_USE bool RustParseScript(JSContext* cx, const uint8_t* bytes,
@@ -7,6 +7,10 @@
 #ifndef frontend_NameCollections_h
 #define frontend_NameCollections_h
 
+#include "mozilla/MemoryReporting.h"
+
+#include <algorithm>
+
 #include "ds/InlineTable.h"
 #include "frontend/NameAnalysisTypes.h"
 #include "js/Vector.h"
@@ -57,6 +61,35 @@ class CollectionPool {
     recyclable_.clearAndFree();
   }
 
+  // Free all but |keep| collections, and the dynamic storage of the ones that
+  // are kept.  None of the collections may be in use.
+  void purgeAllBut(size_t keep) {
+    MOZ_ASSERT(recyclable_.length() == all_.length());
+
+    keep = std::min(keep, all_.length());
+    for (size_t i = keep; i < all_.length(); i++) {
+      js_delete(asRepresentative(all_[i]));
+    }
+    all_.shrinkTo(keep);
+
+    recyclable_.clear();
+    for (size_t i = 0; i < keep; i++) {
+      ConcreteCollectionPool::compact(asRepresentative(all_[i]));
+      recyclable_.infallibleAppend(all_[i]);
+    }
+  }
+
+  size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+    size_t n = all_.sizeOfExcludingThis(mallocSizeOf) +
+               recyclable_.sizeOfExcludingThis(mallocSizeOf);
+    for (void* const* it = all_.begin(); it != all_.end(); ++it) {
+      RepresentativeCollection* collection = asRepresentative(*it);
+      n += mallocSizeOf(collection) +
+           collection->sizeOfExcludingThis(mallocSizeOf);
+    }
+    return n;
+  }
+
   // Fallibly aquire one of the supported collection types from the pool.
   template <typename Collection>
   Collection* acquire(JSContext* cx) {
@@ -164,6 +197,8 @@ class InlineTablePool
     static_assert(mozilla::IsPod<typename Table::Table::Entry>::value,
                   "Only tables with POD values are usable in the pool.");
   }
+
+  static void compact(RepresentativeTable* table) { table->clearAndCompact(); }
 };
 
 template <typename RepresentativeVector>
@@ -183,6 +218,8 @@ class VectorPool : public CollectionPool<RepresentativeVector,
             sizeof(typename RepresentativeVector::ElementType),
         "Only vectors with same-sized elements are usable in the pool.");
   }
+
+  static void compact(RepresentativeVector* vector) { vector->clearAndFree(); }
 };
 
 class NameCollectionPool {
@@ -238,6 +275,24 @@ class NameCollectionPool {
       vectorPool_.purgeAll();
     }
   }
+
+  // Like purge, but keep enough empty collections for a few small
+  // compilations (event handlers, Function bodies and the like), so that they
+  // don't have to allocate them again after every GC.
+  void trim() {
+    if (!hasActiveCompilation()) {
+      mapPool_.purgeAllBut(RetainedCollections);
+      vectorPool_.purgeAllBut(RetainedCollections);
+    }
+  }
+
+  size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+    return mapPool_.sizeOfExcludingThis(mallocSizeOf) +
+           vectorPool_.sizeOfExcludingThis(mallocSizeOf);
+  }
+
+ private:
+  static const size_t RetainedCollections = 32;
 };
 
 #define POOLED_COLLECTION_PTR_METHODS(N, T)                                   \
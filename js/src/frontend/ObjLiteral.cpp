@@ -7,6 +7,9 @@
 
 #include "frontend/ObjLiteral.h"
 #include "mozilla/DebugOnly.h"
+
+#include "jsfriendapi.h"  // CheckRecursionLimit
+
 #include "js/RootingAPI.h"
 #include "vm/JSAtom.h"
 #include "vm/JSObject.h"
@@ -18,7 +21,8 @@
 
 namespace js {
 
-static void InterpretObjLiteralValue(ObjLiteralAtomVector& atoms,
+static bool InterpretObjLiteralValue(JSContext* cx,
+                                     ObjLiteralAtomVector& atoms,
                                      const ObjLiteralInsn& insn,
                                      MutableHandleValue propVal) {
   switch (insn.getOp()) {
@@ -42,9 +46,19 @@ static void InterpretObjLiteralValue(ObjLiteralAtomVector& atoms,
     case ObjLiteralOpcode::False:
       propVal.setBoolean(false);
       break;
+    case ObjLiteralOpcode::Nested: {
+      JSObject* obj = InterpretObjLiteral(cx, atoms, insn.getNestedInsns(),
+                                          insn.getNestedFlags());
+      if (!obj) {
+        return false;
+      }
+      propVal.setObject(*obj);
+      break;
+    }
     default:
       MOZ_CRASH("Unexpected object-literal instruction opcode");
   }
+  return true;
 }
 
 static JSObject* InterpretObjLiteralObj(
@@ -76,8 +90,8 @@ static JSObject* InterpretObjLiteralObj(
 
     if (noValues) {
       propVal.setUndefined();
-    } else {
-      InterpretObjLiteralValue(atoms, insn, &propVal);
+    } else if (!InterpretObjLiteralValue(cx, atoms, insn, &propVal)) {
+      return nullptr;
     }
 
     if (!properties.append(IdValuePair(propId, propVal))) {
@@ -127,7 +141,9 @@ static JSObject* InterpretObjLiteralArray(
     MOZ_ASSERT(insn.isValid());
 
     propVal.setUndefined();
-    InterpretObjLiteralValue(atoms, insn, &propVal);
+    if (!InterpretObjLiteralValue(cx, atoms, insn, &propVal)) {
+      return nullptr;
+    }
     if (!elements.append(propVal)) {
       return nullptr;
     }
@@ -149,6 +165,11 @@ static JSObject* InterpretObjLiteralArray(
 JSObject* InterpretObjLiteral(JSContext* cx, ObjLiteralAtomVector& atoms,
                               mozilla::Span<const uint8_t> literalInsns,
                               ObjLiteralFlags flags) {
+  // Nested literals are interpreted recursively.
+  if (!CheckRecursionLimit(cx)) {
+    return nullptr;
+  }
+
   return flags.contains(ObjLiteralFlag::Array)
              ? InterpretObjLiteralArray(cx, atoms, literalInsns, flags)
              : InterpretObjLiteralObj(cx, atoms, literalInsns, flags);
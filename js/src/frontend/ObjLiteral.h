@@ -54,7 +54,12 @@
  * conditions; in brief, we can represent object literals with "primitive"
  * (numeric, boolean, string, null/undefined) values, and "normal"
  * (non-computed) object names. We can also represent arrays with the same
- * value restrictions. We cannot represent nested objects. We use ObjLiteral in
+ * value restrictions. In a singleton context (see below), values may also be
+ * nested object and array literals obeying the same restrictions: these are
+ * encoded inline in the parent's instruction stream (see
+ * `ObjLiteralOpcode::Nested`), so that a large tree of literal data, such as
+ * a configuration table, becomes one compact blob that is instantiated in a
+ * single pass rather than by per-property bytecode. We use ObjLiteral in
  * two different ways:
  *
  * - To build a template object, when we can support the properties but not the
@@ -152,7 +157,11 @@ enum class ObjLiteralOpcode : uint8_t {
   True = 5,
   False = 6,
 
-  MAX = False,
+  // A nested object or array. The argument holds the nested literal's flags
+  // and the length in bytes of its instructions, which follow immediately.
+  Nested = 7,
+
+  MAX = Nested,
 };
 
 // Flags that are associated with a sequence of object-literal instructions.
@@ -193,6 +202,10 @@ inline bool ObjLiteralOpcodeHasAtomArg(ObjLiteralOpcode op) {
   return op == ObjLiteralOpcode::ConstAtom;
 }
 
+inline bool ObjLiteralOpcodeHasNestedArg(ObjLiteralOpcode op) {
+  return op == ObjLiteralOpcode::Nested;
+}
+
 struct ObjLiteralReaderBase;
 
 // Property name (as an atom index) or an integer index.  Only used for
@@ -251,6 +264,10 @@ struct ObjLiteralWriterBase {
   // If set, the atom index field is an array index, not an atom index.
   static const uint32_t INDEXED_PROP = 0x00800000;
   static const int OP_SHIFT = 24;
+  // A Nested instruction's argument holds the nested instructions' length in
+  // the low bits and the nested literal's flags in the high bits.
+  static const uint64_t NESTED_LENGTH_MASK = 0xffffffff;
+  static const int NESTED_FLAGS_SHIFT = 32;
 
  protected:
   Vector<uint8_t, 64> code_;
@@ -297,6 +314,23 @@ struct ObjLiteralWriterBase {
   MOZ_MUST_USE bool pushAtomArg(uint32_t atomIndex) {
     return pushRawData(atomIndex);
   }
+
+  MOZ_MUST_USE bool pushNestedArg(ObjLiteralFlags flags, uint32_t length) {
+    uint64_t data = (uint64_t(flags.serialize()) << NESTED_FLAGS_SHIFT) |
+                    uint64_t(length);
+    return pushRawData(data);
+  }
+
+  // Patch the length of a nested literal's instructions, once they are all
+  // written. |argOffset| is the offset of the Nested instruction's argument.
+  void patchNestedLength(uint32_t argOffset, uint32_t length) {
+    uint64_t data;
+    mozilla::NativeEndian::copyAndSwapFromLittleEndian(
+        &data, reinterpret_cast<const void*>(&code_[argOffset]), 1);
+    data = (data & ~uint64_t(NESTED_LENGTH_MASK)) | uint64_t(length);
+    mozilla::NativeEndian::copyAndSwapToLittleEndian(
+        reinterpret_cast<void*>(&code_[argOffset]), &data, 1);
+  }
 };
 
 // An object-literal instruction writer. This class, held by the bytecode
@@ -357,9 +391,39 @@ struct ObjLiteralWriter : private ObjLiteralWriterBase {
     return pushOpAndName(ObjLiteralOpcode::False, nextKey_);
   }
 
+  // Begin a nested object or array as the value of the next property. The
+  // nested literal's keys and values are written with the usual methods, and
+  // then endNested must be called with the same |state|.
+  struct NestedState {
+    ObjLiteralFlags flags;
+    ObjLiteralKey key;
+    uint32_t argOffset;
+  };
+
+  MOZ_MUST_USE bool beginNested(ObjLiteralFlags flags, NestedState* state) {
+    if (!pushOpAndName(ObjLiteralOpcode::Nested, nextKey_)) {
+      return false;
+    }
+    state->flags = flags_;
+    state->key = nextKey_;
+    state->argOffset = curOffset();
+    if (!pushNestedArg(flags, 0)) {
+      return false;
+    }
+    flags_ = flags;
+    return true;
+  }
+  void endNested(const NestedState& state) {
+    uint32_t insnsOffset = state.argOffset + sizeof(uint64_t);
+    patchNestedLength(state.argOffset, curOffset() - insnsOffset);
+    flags_ = state.flags;
+    nextKey_ = state.key;
+  }
+
   static bool arrayIndexInRange(int32_t i) {
     return i >= 0 && static_cast<uint32_t>(i) <= ATOM_INDEX_MASK;
   }
+  static bool atomIndexInRange(uint32_t i) { return i <= ATOM_INDEX_MASK; }
 
  private:
   ObjLiteralFlags flags_;
@@ -424,6 +488,23 @@ struct ObjLiteralReaderBase {
   MOZ_MUST_USE bool readAtomArg(uint32_t* atomIndex) {
     return readRawData(atomIndex);
   }
+
+  MOZ_MUST_USE bool readNestedArg(ObjLiteralFlags* flags,
+                                  mozilla::Span<const uint8_t>* insns) {
+    uint64_t data;
+    if (!readRawData(&data)) {
+      return false;
+    }
+    flags->deserialize(static_cast<uint8_t>(
+        data >> ObjLiteralWriterBase::NESTED_FLAGS_SHIFT));
+    size_t length = data & ObjLiteralWriterBase::NESTED_LENGTH_MASK;
+    const uint8_t* p = nullptr;
+    if (!readBytes(length, &p)) {
+      return false;
+    }
+    *insns = mozilla::Span<const uint8_t>(p, length);
+    return true;
+  }
 };
 
 // A single object-literal instruction, creating one property on an object.
@@ -438,6 +519,8 @@ struct ObjLiteralInsn {
     uint32_t atomIndex;
     uint64_t raw;
   } arg_;
+  ObjLiteralFlags nestedFlags_;
+  mozilla::Span<const uint8_t> nestedInsns_;
 
  public:
   ObjLiteralInsn() : op_(ObjLiteralOpcode::INVALID), arg_(0) {}
@@ -458,6 +541,16 @@ struct ObjLiteralInsn {
     MOZ_ASSERT(hasAtomIndex());
     arg_.atomIndex = atomIndex;
   }
+  ObjLiteralInsn(ObjLiteralOpcode op, ObjLiteralKey key,
+                 ObjLiteralFlags nestedFlags,
+                 mozilla::Span<const uint8_t> nestedInsns)
+      : op_(op),
+        key_(key),
+        arg_(0),
+        nestedFlags_(nestedFlags),
+        nestedInsns_(nestedInsns) {
+    MOZ_ASSERT(hasNested());
+  }
   ObjLiteralInsn(const ObjLiteralInsn& other) : ObjLiteralInsn() {
     *this = other;
   }
@@ -465,6 +558,8 @@ struct ObjLiteralInsn {
     op_ = other.op_;
     key_ = other.key_;
     arg_.raw = other.arg_.raw;
+    nestedFlags_ = other.nestedFlags_;
+    nestedInsns_ = other.nestedInsns_;
     return *this;
   }
 
@@ -489,6 +584,10 @@ struct ObjLiteralInsn {
     MOZ_ASSERT(isValid());
     return ObjLiteralOpcodeHasAtomArg(op_);
   }
+  bool hasNested() const {
+    MOZ_ASSERT(isValid());
+    return ObjLiteralOpcodeHasNestedArg(op_);
+  }
 
   JS::Value getConstValue() const {
     MOZ_ASSERT(isValid());
@@ -500,6 +599,16 @@ struct ObjLiteralInsn {
     MOZ_ASSERT(hasAtomIndex());
     return arg_.atomIndex;
   };
+  ObjLiteralFlags getNestedFlags() const {
+    MOZ_ASSERT(isValid());
+    MOZ_ASSERT(hasNested());
+    return nestedFlags_;
+  }
+  mozilla::Span<const uint8_t> getNestedInsns() const {
+    MOZ_ASSERT(isValid());
+    MOZ_ASSERT(hasNested());
+    return nestedInsns_;
+  }
 };
 
 // A reader that parses a sequence of object-literal instructions out of the
@@ -531,6 +640,15 @@ struct ObjLiteralReader : private ObjLiteralReaderBase {
       *insn = ObjLiteralInsn(op, key, atomIndex);
       return true;
     }
+    if (ObjLiteralOpcodeHasNestedArg(op)) {
+      ObjLiteralFlags flags;
+      mozilla::Span<const uint8_t> insns;
+      if (!readNestedArg(&flags, &insns)) {
+        return false;
+      }
+      *insn = ObjLiteralInsn(op, key, flags, insns);
+      return true;
+    }
     *insn = ObjLiteralInsn(op, key);
     return true;
   }
@@ -2853,6 +2853,12 @@ bool Parser<FullParseHandler, Unit>::trySyntaxParseInnerFunction(
       break;
     }
 
+    // Likewise for functions that an earlier run over this source has seen
+    // delazified.
+    if (options().isEagerFunction(toStringStart)) {
+      break;
+    }
+
     SyntaxParser* syntaxParser = getSyntaxParser();
     if (!syntaxParser) {
       break;
@@ -2368,9 +2368,72 @@ static const uint8_t firstCharKinds[] = {
 static_assert(LastCharKind < (1 << (sizeof(firstCharKinds[0]) * 8)),
               "Elements of firstCharKinds[] are too small");
 
+// Masks for examining the code units packed into a uint64_t all at once.
+template <typename Unit>
+struct CodeUnitLanes;
+
+template <>
+struct CodeUnitLanes<Utf8Unit> {
+  static constexpr uint64_t Ones = 0x0101010101010101;
+  static constexpr uint64_t HighBits = 0x8080808080808080;
+  static constexpr uint64_t NonAsciiBits = 0x8080808080808080;
+};
+
+template <>
+struct CodeUnitLanes<char16_t> {
+  static constexpr uint64_t Ones = 0x0001000100010001;
+  static constexpr uint64_t HighBits = 0x8000800080008000;
+  static constexpr uint64_t NonAsciiBits = 0xFF80FF80FF80FF80;
+};
+
+// Whether any code unit in |word| is equal to the ASCII |c|.  This is exact
+// (not merely a conservative approximation) for the word as a whole.
+template <typename Unit>
+static MOZ_ALWAYS_INLINE bool AnyCodeUnitEquals(uint64_t word, char c) {
+  using Lanes = CodeUnitLanes<Unit>;
+  uint64_t v = word ^ (Lanes::Ones * uint8_t(c));
+  return ((v - Lanes::Ones) & ~v & Lanes::HighBits) != 0;
+}
+
+// Count the code units at the start of [units, limit) that are ASCII but not
+// '\n' or '\r', examining a word's worth of code units at a time.  These can
+// be skipped without any further processing in a single-line comment.
+template <typename Unit>
+static size_t CountAsciiNonLineBreakUnits(const Unit* units,
+                                          const Unit* limit) {
+  constexpr size_t UnitsPerWord = sizeof(uint64_t) / sizeof(Unit);
+
+  const Unit* p = units;
+  while (PointerRangeSize(p, limit) >= UnitsPerWord) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    if ((word & CodeUnitLanes<Unit>::NonAsciiBits) != 0 ||
+        AnyCodeUnitEquals<Unit>(word, '\n') ||
+        AnyCodeUnitEquals<Unit>(word, '\r')) {
+      break;
+    }
+    p += UnitsPerWord;
+  }
+
+  while (p < limit) {
+    char16_t unit = CodeUnitValue(*p);
+    if (unit >= 0x80 || unit == '\n' || unit == '\r') {
+      break;
+    }
+    p++;
+  }
+
+  return PointerRangeSize(units, p);
+}
+
 template <>
 void SourceUnits<char16_t>::consumeRestOfSingleLineComment() {
   while (MOZ_LIKELY(!atEnd())) {
+    skipCodeUnits(CountAsciiNonLineBreakUnits(ptr, limit_));
+    if (atEnd()) {
+      return;
+    }
+
     char16_t unit = peekCodeUnit();
     if (IsLineTerminator(unit)) {
       return;
@@ -2383,6 +2446,11 @@ void SourceUnits<char16_t>::consumeRestOfSingleLineComment() {
 template <>
 void SourceUnits<Utf8Unit>::consumeRestOfSingleLineComment() {
   while (MOZ_LIKELY(!atEnd())) {
+    skipCodeUnits(CountAsciiNonLineBreakUnits(ptr, limit_));
+    if (atEnd()) {
+      return;
+    }
+
     const Utf8Unit unit = peekCodeUnit();
     if (IsSingleUnitLineTerminator(unit)) {
       return;
@@ -2408,6 +2476,43 @@ void SourceUnits<Utf8Unit>::consumeRestOfSingleLineComment() {
   }
 }
 
+// Count the code units at the start of [units, limit) that a string or
+// template literal body contributes unchanged: ASCII code units other than
+// the closing delimiter, '\\', line breaks and, in templates, '$'.  Like
+// CountAsciiNonLineBreakUnits, this examines a word's worth of code units at a
+// time, and finishes the run one code unit at a time.
+template <typename Unit>
+static size_t CountPlainLiteralUnits(const Unit* units, const Unit* limit,
+                                     char untilChar, bool parsingTemplate) {
+  constexpr size_t UnitsPerWord = sizeof(uint64_t) / sizeof(Unit);
+
+  const Unit* p = units;
+  while (PointerRangeSize(p, limit) >= UnitsPerWord) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    if ((word & CodeUnitLanes<Unit>::NonAsciiBits) != 0 ||
+        AnyCodeUnitEquals<Unit>(word, untilChar) ||
+        AnyCodeUnitEquals<Unit>(word, '\\') ||
+        AnyCodeUnitEquals<Unit>(word, '\n') ||
+        AnyCodeUnitEquals<Unit>(word, '\r') ||
+        (parsingTemplate && AnyCodeUnitEquals<Unit>(word, '$'))) {
+      break;
+    }
+    p += UnitsPerWord;
+  }
+
+  while (p < limit) {
+    char16_t unit = CodeUnitValue(*p);
+    if (unit >= 0x80 || unit == untilChar || unit == '\\' || unit == '\n' ||
+        unit == '\r' || (parsingTemplate && unit == '$')) {
+      break;
+    }
+    p++;
+  }
+
+  return PointerRangeSize(units, p);
+}
+
 template <typename Unit, class AnyCharsAccess>
 MOZ_MUST_USE MOZ_ALWAYS_INLINE bool
 TokenStreamSpecific<Unit, AnyCharsAccess>::matchInteger(
@@ -3356,11 +3461,43 @@ bool TokenStreamSpecific<Unit, AnyCharsAccess>::getStringOrTemplateToken(
     return;
   };
 
+  // Append the run of code units at the current position that need no
+  // processing, all at once.
+  auto appendPlainUnits = [this, untilChar, parsingTemplate]() {
+    const Unit* units = this->sourceUnits.addressOfNextCodeUnit();
+    size_t count = CountPlainLiteralUnits(units, this->sourceUnits.limit(),
+                                          untilChar, parsingTemplate);
+    if (count == 0) {
+      return true;
+    }
+
+    size_t length = this->charBuffer.length();
+    if (!this->charBuffer.growByUninitialized(count)) {
+      return false;
+    }
+    char16_t* dest = this->charBuffer.begin() + length;
+    for (size_t i = 0; i < count; i++) {
+      dest[i] = CodeUnitValue(units[i]);
+    }
+
+    this->sourceUnits.skipCodeUnits(count);
+    return true;
+  };
+
   // We need to detect any of these chars:  " or ', \n (or its
   // equivalents), \\, EOF.  Because we detect EOL sequences here and
   // put them back immediately, we can use getCodeUnit().
   int32_t unit;
-  while ((unit = getCodeUnit()) != untilChar) {
+  while (true) {
+    if (!appendPlainUnits()) {
+      return false;
+    }
+
+    unit = getCodeUnit();
+    if (unit == untilChar) {
+      break;
+    }
+
     if (unit == EOF) {
       ReportPrematureEndOfLiteral(JSMSG_EOF_BEFORE_END_OF_LITERAL);
       return false;
@@ -573,6 +573,16 @@ TenuredCell* ArenaLists::refillFreeListAndAllocate(
     return freeLists.setArenaAndAllocate(arena, thingKind);
   }
 
+  // Use an arena we reserved earlier, if there is one.
+  arena = reservedArenas(thingKind);
+  if (arena) {
+    MOZ_ASSERT(zone_->usedByHelperThread());
+    reservedArenas(thingKind) = arena->next;
+    MOZ_ASSERT(al.isCursorAtEnd());
+    al.insertBeforeCursor(arena);
+    return freeLists.setArenaAndAllocate(arena, thingKind);
+  }
+
   // Parallel threads have their own ArenaLists, but chunks are shared;
   // if we haven't already, take the GC lock now to avoid racing.
   if (maybeLock.isNothing()) {
@@ -595,9 +605,39 @@ TenuredCell* ArenaLists::refillFreeListAndAllocate(
   MOZ_ASSERT(al.isCursorAtEnd());
   al.insertBeforeCursor(arena);
 
+  // Helper threads parsing or decoding into their own zone allocate many
+  // arenas in quick succession. Take a few more while we hold the lock so
+  // they don't contend with the main thread for it as often.
+  if (zone_->usedByHelperThread()) {
+    reserveArenas(thingKind, checkThresholds, maybeLock.ref());
+  }
+
   return freeLists.setArenaAndAllocate(arena, thingKind);
 }
 
+void ArenaLists::reserveArenas(AllocKind thingKind,
+                               ShouldCheckThresholds checkThresholds,
+                               AutoLockGCBgAlloc& lock) {
+  MOZ_ASSERT(!reservedArenas(thingKind));
+
+  JSRuntime* rt = runtimeFromAnyThread();
+  for (size_t i = 0; i < HelperThreadReservedArenas; i++) {
+    Chunk* chunk = rt->gc.pickChunk(lock);
+    if (!chunk) {
+      return;
+    }
+
+    Arena* arena =
+        rt->gc.allocateArena(chunk, zone_, thingKind, checkThresholds, lock);
+    if (!arena) {
+      return;
+    }
+
+    arena->next = reservedArenas(thingKind);
+    reservedArenas(thingKind) = arena;
+  }
+}
+
 inline TenuredCell* FreeLists::setArenaAndAllocate(Arena* arena,
                                                    AllocKind kind) {
 #ifdef DEBUG
@@ -9,6 +9,8 @@
 
 #include "gc/ArenaList.h"
 
+#include <algorithm>
+
 #include "gc/Heap.h"
 #include "gc/Zone.h"
 
@@ -174,14 +176,29 @@ void js::gc::SortedArenaList::extractEmpty(Arena** empty) {
   }
 }
 
-js::gc::ArenaList js::gc::SortedArenaList::toArenaList() {
+js::gc::ArenaList js::gc::SortedArenaList::toArenaList(
+    bool preferDenselyFree) {
+  // Arenas with fewer than |sparseLimit| free things go last. A limit of one
+  // keeps every segment in order of increasing free space.
+  size_t sparseLimit = 1;
+  if (preferDenselyFree) {
+    sparseLimit = std::max(thingsPerArena_ / SparseArenaFreeDivisor, size_t(1));
+  }
+
   // Link the non-empty segment tails up to the non-empty segment heads.
   size_t tailIndex = 0;
-  for (size_t headIndex = 1; headIndex <= thingsPerArena_; ++headIndex) {
+  auto linkSegment = [&](size_t headIndex) {
     if (headAt(headIndex)) {
       segments[tailIndex].linkTo(headAt(headIndex));
       tailIndex = headIndex;
     }
+  };
+  for (size_t headIndex = sparseLimit; headIndex <= thingsPerArena_;
+       ++headIndex) {
+    linkSegment(headIndex);
+  }
+  for (size_t headIndex = 1; headIndex < sparseLimit; ++headIndex) {
+    linkSegment(headIndex);
   }
   // Point the tail of the final non-empty segment at null. Note that if
   // the list is empty, this will just set segments[0].head to null.
@@ -20,6 +20,8 @@
 
 namespace js {
 
+class AutoLockGC;
+class AutoLockGCBgAlloc;
 class Nursery;
 class TenuringTracer;
 
@@ -171,6 +173,10 @@ class SortedArenaList {
   static const size_t MaxThingsPerArena =
       (ArenaSize - ArenaHeaderSize) / MinThingSize;
 
+  // When preferring densely free arenas, arenas with less than this fraction
+  // of their things free are placed at the end of the list.
+  static const size_t SparseArenaFreeDivisor = 8;
+
   size_t thingsPerArena_;
   SortedArenaListSegment segments[MaxThingsPerArena + 1];
 
@@ -199,7 +205,13 @@ class SortedArenaList {
   // resulting ArenaList should be treated as read-only unless the
   // SortedArenaList is no longer needed: inserting or removing arenas would
   // invalidate the SortedArenaList.
-  inline ArenaList toArenaList();
+  //
+  // If |preferDenselyFree| is set, arenas with only a few free things are
+  // linked after all other non-full arenas. Allocation then fills arenas with
+  // plenty of free space first rather than taking a slow path for each arena
+  // holding one or two free cells. The result is no longer sorted by free
+  // space, so this must not be used when the list may be compacted.
+  inline ArenaList toArenaList(bool preferDenselyFree = false);
 };
 
 enum class ShouldCheckThresholds {
@@ -297,6 +309,17 @@ class ArenaLists {
   // released at the end of sweeping every sweep group.
   ZoneData<Arena*> savedEmptyArenas;
 
+  // Whether swept arenas should be ordered to prefer densely free arenas.
+  ZoneOrGCTaskData<bool> preferDenselyFreeArenas_;
+
+  // For zones used by helper threads, empty arenas that have been allocated
+  // ahead of time so that refilling a free list does not need to take the GC
+  // lock every time. These must be released before the zone is merged into
+  // another zone.
+  static const size_t HelperThreadReservedArenas = 4;
+  ZoneData<AllAllocKindArray<Arena*>> reservedArenas_;
+  Arena*& reservedArenas(AllocKind i) { return reservedArenas_.ref()[i]; }
+
  public:
   explicit ArenaLists(JS::Zone* zone);
   ~ArenaLists();
@@ -343,6 +366,7 @@ class ArenaLists {
   void queueForegroundThingsForSweep();
 
   void releaseForegroundSweptEmptyArenas();
+  void releaseReservedArenas(const AutoLockGC& lock);
 
   bool foregroundFinalize(JSFreeOp* fop, AllocKind thingKind,
                           js::SliceBudget& sliceBudget,
@@ -351,6 +375,12 @@ class ArenaLists {
 
   void setParallelAllocEnabled(bool enabled);
 
+  // Set whether arenas swept in the current GC should be ordered so that
+  // allocation prefers densely free arenas. See SortedArenaList::toArenaList.
+  void setPreferDenselyFreeArenas(bool enabled) {
+    preferDenselyFreeArenas_ = enabled;
+  }
+
  private:
   inline JSRuntime* runtime();
   inline JSRuntime* runtimeFromAnyThread();
@@ -365,6 +395,8 @@ class ArenaLists {
   TenuredCell* refillFreeListAndAllocate(FreeLists& freeLists,
                                          AllocKind thingKind,
                                          ShouldCheckThresholds checkThresholds);
+  void reserveArenas(AllocKind thingKind, ShouldCheckThresholds checkThresholds,
+                     AutoLockGCBgAlloc& lock);
 
   friend class GCRuntime;
   friend class js::Nursery;
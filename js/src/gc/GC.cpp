@@ -215,6 +215,7 @@
 
 #include "builtin/FinalizationGroupObject.h"
 #include "debugger/DebugAPI.h"
+#include "frontend/Frontend2.h"
 #include "gc/FindSCCs.h"
 #include "gc/FreeOp.h"
 #include "gc/GCInternals.h"
@@ -1476,6 +1477,12 @@ uint32_t GCRuntime::getParameter(JSGCParamKey key, const AutoLockGC& lock) {
       return tunables.mallocThresholdBase() / 1024 / 1024;
     case JSGC_MALLOC_GROWTH_FACTOR:
       return uint32_t(tunables.mallocGrowthFactor() * 100);
+    case JSGC_NURSERY_PAUSE_TARGET_US:
+      return uint32_t(tunables.nurseryPauseTarget().ToMicroseconds());
+    case JSGC_DECOMMIT_FREE_ARENAS:
+      return tunables.isDecommitFreeArenasEnabled();
+    case JSGC_STRING_DEDUPLICATION:
+      return tunables.isStringDeduplicationEnabled();
     default:
       MOZ_CRASH("Unknown parameter key");
   }
@@ -2367,6 +2374,7 @@ void GCRuntime::updateCellPointers(Zone* zone, AllocKinds kinds,
   ArenasToUpdate fgArenas(zone, fgKinds);
   ArenasToUpdate bgArenas(zone, bgKinds);
   Maybe<UpdatePointersTask> fgTask;
+  Maybe<UpdatePointersTask> helpTask;
   Maybe<UpdatePointersTask> bgTasks[MaxCellUpdateBackgroundTasks];
 
   size_t tasksStarted = 0;
@@ -2381,10 +2389,20 @@ void GCRuntime::updateCellPointers(Zone* zone, AllocKinds kinds,
       startTask(*bgTasks[i], gcstats::PhaseKind::COMPACT_UPDATE_CELLS, lock);
       tasksStarted++;
     }
+
+    if (tasksStarted) {
+      helpTask.emplace(this, &bgArenas, lock);
+    }
   }
 
   fgTask->runFromMainThread();
 
+  // Once the foreground kinds are done, help the background tasks with their
+  // remaining arenas rather than waiting for them to finish.
+  if (helpTask) {
+    helpTask->runFromMainThread();
+  }
+
   {
     AutoLockHelperThreadState lock;
 
@@ -2673,10 +2691,13 @@ ArenaLists::ArenaLists(Zone* zone)
       gcAccessorShapeArenasToUpdate(zone, nullptr),
       gcScriptArenasToUpdate(zone, nullptr),
       gcObjectGroupArenasToUpdate(zone, nullptr),
-      savedEmptyArenas(zone, nullptr) {
+      savedEmptyArenas(zone, nullptr),
+      preferDenselyFreeArenas_(zone, false),
+      reservedArenas_(zone) {
   for (auto i : AllAllocKinds()) {
     concurrentUse(i) = ConcurrentUse::None;
     arenaListsToSweep(i) = nullptr;
+    reservedArenas(i) = nullptr;
   }
 }
 
@@ -2702,6 +2723,7 @@ ArenaLists::~ArenaLists() {
   ReleaseArenaList(runtime(), incrementalSweptArenas.ref().head(), lock);
 
   ReleaseArenaList(runtime(), savedEmptyArenas, lock);
+  releaseReservedArenas(lock);
 }
 
 void ArenaLists::queueForForegroundSweep(JSFreeOp* fop,
@@ -2771,7 +2793,8 @@ void ArenaLists::backgroundFinalize(JSFreeOp* fop, Arena* listHead,
   ArenaList* al = &lists->arenaLists(thingKind);
 
   // Flatten |finalizedSorted| into a regular ArenaList.
-  ArenaList finalized = finalizedSorted.toArenaList();
+  ArenaList finalized =
+      finalizedSorted.toArenaList(lists->preferDenselyFreeArenas_);
 
   // We must take the GC lock to be able to safely modify the ArenaList;
   // however, this does not by itself make the changes visible to all threads,
@@ -2798,6 +2821,13 @@ void ArenaLists::releaseForegroundSweptEmptyArenas() {
   savedEmptyArenas = nullptr;
 }
 
+void ArenaLists::releaseReservedArenas(const AutoLockGC& lock) {
+  for (auto i : AllAllocKinds()) {
+    ReleaseArenaList(runtime(), reservedArenas(i), lock);
+    reservedArenas(i) = nullptr;
+  }
+}
+
 void ArenaLists::queueForegroundThingsForSweep() {
   gcShapeArenasToUpdate = arenaListsToSweep(AllocKind::SHAPE);
   gcAccessorShapeArenasToUpdate = arenaListsToSweep(AllocKind::ACCESSOR_SHAPE);
@@ -3129,19 +3159,72 @@ void GCRuntime::maybeGC() {
     return;
   }
 
+  if (scheduleZonesOverEagerTrigger()) {
+    startGC(GC_NORMAL, JS::GCReason::EAGER_ALLOC_TRIGGER);
+  }
+}
+
+bool GCRuntime::scheduleZonesOverEagerTrigger() {
   bool scheduledZones = false;
   for (ZonesIter zone(this, WithAtoms); !zone.done(); zone.next()) {
     if (checkEagerAllocTrigger(zone->gcHeapSize, zone->gcHeapThreshold) ||
         checkEagerAllocTrigger(zone->mallocHeapSize,
-                               zone->mallocHeapThreshold)) {
+                               zone->mallocHeapThreshold) ||
+        checkZoneHeapQuota(zone)) {
       zone->scheduleGC();
       scheduledZones = true;
     }
   }
 
-  if (scheduledZones) {
-    startGC(GC_NORMAL, JS::GCReason::EAGER_ALLOC_TRIGGER);
+  return scheduledZones;
+}
+
+JS::IdleGCWork GCRuntime::idleTimeGCWork(TimeStamp deadline) {
+  MOZ_ASSERT(CurrentThreadCanAccessRuntime(rt));
+  MOZ_ASSERT(!JS::RuntimeHeapIsBusy());
+
+  TimeStamp now = ReallyNow();
+  if (now >= deadline || rt->mainContextFromOwnThread()->suppressGC) {
+    return JS::IdleGCWork::None;
+  }
+
+  TimeDuration available = deadline - now;
+
+  // Slice budgets are in whole milliseconds, and a budget of zero means the
+  // default budget, so round down and don't run major GC slices at all when
+  // less than a millisecond is left.
+  int64_t millis = int64_t(available.ToMilliseconds());
+
+  // Finishing an incremental GC that is already in progress is the most
+  // useful thing we can do: its slices will otherwise run at allocation
+  // triggers or from the embedding's GC timer, and a slice also collects the
+  // nursery if that is needed.
+  if (isIncrementalGCInProgress()) {
+    if (millis == 0) {
+      return JS::IdleGCWork::None;
+    }
+    gcSlice(JS::GCReason::IDLE_TIME_COLLECTION, millis);
+    return JS::IdleGCWork::MajorSlice;
   }
+
+  // Collect the nursery if it's close to full and the last minor GC suggests
+  // this one will fit in the time available. Without a previous minor GC to
+  // go by we can't tell, so leave it.
+  TimeDuration previousMinorGC = nursery().previousGCDuration();
+  if (nursery().isEnabled() && nursery().shouldCollect() &&
+      !previousMinorGC.IsZero() && previousMinorGC < available) {
+    minorGC(JS::GCReason::IDLE_TIME_COLLECTION);
+    return JS::IdleGCWork::MinorGC;
+  }
+
+  // Otherwise start a major GC of any zones that are close to their triggers,
+  // limiting the first slice to the time available.
+  if (millis > 0 && scheduleZonesOverEagerTrigger()) {
+    startGC(GC_NORMAL, JS::GCReason::IDLE_TIME_COLLECTION, millis);
+    return JS::IdleGCWork::MajorSlice;
+  }
+
+  return JS::IdleGCWork::None;
 }
 
 bool GCRuntime::checkEagerAllocTrigger(const HeapSize& size,
@@ -3157,6 +3240,33 @@ bool GCRuntime::checkEagerAllocTrigger(const HeapSize& size,
   return true;
 }
 
+bool GCRuntime::checkZoneHeapQuota(Zone* zone) {
+  size_t quota = zone->gcHeapQuota;
+  if (!quota || !zone->canCollect()) {
+    return false;
+  }
+
+  // If the GC which the quota last triggered left the zone over its quota,
+  // collecting again straight away would find the same live data. Wait until
+  // the heap has grown by this factor over what that GC retained.
+  static const double QuotaRetriggerFactor = 1.5;
+
+  size_t triggerBytes = quota;
+  size_t retainedBytes = zone->gcHeapSize.retainedBytes();
+  if (zone->gcHeapQuotaTriggered && retainedBytes >= quota) {
+    triggerBytes = size_t(double(retainedBytes) * QuotaRetriggerFactor);
+  }
+
+  size_t usedBytes = zone->gcHeapSize.bytes();
+  if (usedBytes < triggerBytes) {
+    return false;
+  }
+
+  zone->gcHeapQuotaTriggered = true;
+  stats().recordTrigger(usedBytes, triggerBytes);
+  return true;
+}
+
 void GCRuntime::triggerFullGCForAtoms(JSContext* cx) {
   MOZ_ASSERT(fullGCForAtomsRequested_);
   MOZ_ASSERT(CurrentThreadCanAccessRuntime(rt));
@@ -3204,13 +3314,18 @@ void GCRuntime::startDecommit() {
     // it is dangerous to iterate the available list directly, as the active
     // thread could modify it concurrently. Instead, we build and pass an
     // explicit Vector containing the Chunks we want to visit.
+    //
+    // If decommitting free arenas has been disabled we skip this, but still
+    // run the task to release expired empty chunks.
     MOZ_ASSERT(availableChunks(lock).verify());
     availableChunks(lock).sort();
-    for (ChunkPool::Iter iter(availableChunks(lock)); !iter.done();
-         iter.next()) {
-      if (!toDecommit.append(iter.get())) {
-        // The OOM handler does a full, immediate decommit.
-        return onOutOfMallocMemory(lock);
+    if (tunables.isDecommitFreeArenasEnabled() || cleanUpEverything) {
+      for (ChunkPool::Iter iter(availableChunks(lock)); !iter.done();
+           iter.next()) {
+        if (!toDecommit.append(iter.get())) {
+          // The OOM handler does a full, immediate decommit.
+          return onOutOfMallocMemory(lock);
+        }
       }
     }
   }
@@ -3257,6 +3372,56 @@ void js::gc::BackgroundDecommitTask::run() {
   }
 }
 
+static const size_t MaxBackgroundSweepZoneTasks = 4;
+
+static size_t BackgroundSweepZoneTaskCount() {
+  if (!CanUseExtraThreads()) {
+    return 0;
+  }
+
+  // The task that owns the sweep also sweeps zones itself, so leave one CPU
+  // for it.
+  size_t targetTaskCount = HelperThreadState().cpuCount / 2;
+  if (targetTaskCount) {
+    targetTaskCount--;
+  }
+  return std::min(targetTaskCount, MaxBackgroundSweepZoneTasks);
+}
+
+namespace js {
+namespace gc {
+
+// Helper task that takes zones from a shared list and finalizes them until the
+// list is empty. The list is protected by the helper thread lock.
+class BackgroundSweepZonesTask
+    : public GCParallelTaskHelper<BackgroundSweepZonesTask> {
+  ZoneList& zones_;
+
+ public:
+  BackgroundSweepZonesTask(GCRuntime* gc, ZoneList& zones)
+      : GCParallelTaskHelper(gc), zones_(zones) {}
+
+  void run() { sweepZonesFromList(gc, zones_); }
+
+  static void sweepZonesFromList(GCRuntime* gc, ZoneList& zones) {
+    JSFreeOp fop(nullptr);
+    for (;;) {
+      Zone* zone;
+      {
+        AutoLockHelperThreadState lock;
+        if (zones.isEmpty()) {
+          return;
+        }
+        zone = zones.removeFront();
+      }
+      gc->sweepBackgroundZone(&fop, zone);
+    }
+  }
+};
+
+}  // namespace gc
+}  // namespace js
+
 void GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks) {
   freeBlocks.freeAll();
 
@@ -3264,47 +3429,103 @@ void GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks) {
     return;
   }
 
-  JSFreeOp fop(nullptr);
-
-  // Sweep zones in order. The atoms zone must be finalized last as other
-  // zones may have direct pointers into it.
+  // The atoms zone must be finalized last as other zones may have direct
+  // pointers into it. All other zones are independent and can be finalized in
+  // parallel.
+  Zone* atomsZone = nullptr;
+  ZoneList otherZones;
   while (!zones.isEmpty()) {
     Zone* zone = zones.removeFront();
-    Arena* emptyArenas = nullptr;
+    if (zone->isAtomsZone()) {
+      MOZ_ASSERT(!atomsZone);
+      atomsZone = zone;
+    } else {
+      otherZones.append(zone);
+    }
+  }
 
-    AutoSetThreadIsSweeping threadIsSweeping(zone);
+  sweepBackgroundZones(otherZones);
 
-    // We must finalize thing kinds in the order specified by
-    // BackgroundFinalizePhases.
-    for (auto phase : BackgroundFinalizePhases) {
-      for (auto kind : phase.kinds) {
-        Arena* arenas = zone->arenas.arenaListsToSweep(kind);
-        MOZ_RELEASE_ASSERT(uintptr_t(arenas) != uintptr_t(-1));
-        if (arenas) {
-          ArenaLists::backgroundFinalize(&fop, arenas, &emptyArenas);
-        }
+  if (atomsZone) {
+    JSFreeOp fop(nullptr);
+    sweepBackgroundZone(&fop, atomsZone);
+  }
+}
+
+void GCRuntime::sweepBackgroundZones(ZoneList& zones) {
+  if (zones.isEmpty()) {
+    return;
+  }
+
+  Maybe<BackgroundSweepZonesTask> tasks[MaxBackgroundSweepZoneTasks];
+  size_t tasksStarted = 0;
+
+  {
+    AutoLockHelperThreadState lock;
+
+    // Only start helpers if there is more than one zone to sweep.
+    if (zones.front()->nextZone() != nullptr) {
+      size_t taskCount = BackgroundSweepZoneTaskCount();
+      for (size_t i = 0; i < taskCount; i++) {
+        tasks[i].emplace(this, zones);
+        tasks[i]->startWithLockHeld(lock);
+        tasksStarted++;
       }
     }
+  }
 
-    // Release any arenas that are now empty.
-    //
-    // Periodically drop and reaquire the GC lock every so often to avoid
-    // blocking the main thread from allocating chunks.
-    //
-    // Also use this opportunity to periodically recalculate the GC thresholds
-    // as we free more memory.
-    static const size_t LockReleasePeriod = 32;
-
-    while (emptyArenas) {
-      AutoLockGC lock(this);
-      for (size_t i = 0; i < LockReleasePeriod && emptyArenas; i++) {
-        Arena* arena = emptyArenas;
-        emptyArenas = emptyArenas->next;
-        releaseArena(arena, lock);
+  // Sweep zones on this thread too, until the list is empty.
+  BackgroundSweepZonesTask::sweepZonesFromList(this, zones);
+
+  AutoLockHelperThreadState lock;
+  for (size_t i = 0; i < tasksStarted; i++) {
+    // This may be running on a helper thread, so we can't use
+    // joinWithLockHeld() which may try to run a dispatched task itself. All
+    // the work is done by this point so a task that has not started can simply
+    // be cancelled.
+    if (tasks[i]->isDispatched(lock)) {
+      tasks[i]->cancelDispatchedTask(lock);
+    } else {
+      tasks[i]->joinRunningOrFinishedTask(lock);
+    }
+  }
+}
+
+void GCRuntime::sweepBackgroundZone(JSFreeOp* fop, Zone* zone) {
+  Arena* emptyArenas = nullptr;
+
+  AutoSetThreadIsSweeping threadIsSweeping(zone);
+
+  // We must finalize thing kinds in the order specified by
+  // BackgroundFinalizePhases.
+  for (auto phase : BackgroundFinalizePhases) {
+    for (auto kind : phase.kinds) {
+      Arena* arenas = zone->arenas.arenaListsToSweep(kind);
+      MOZ_RELEASE_ASSERT(uintptr_t(arenas) != uintptr_t(-1));
+      if (arenas) {
+        ArenaLists::backgroundFinalize(fop, arenas, &emptyArenas);
       }
-      zone->updateGCThresholds(*this, invocationKind, lock);
     }
   }
+
+  // Release any arenas that are now empty.
+  //
+  // Periodically drop and reaquire the GC lock every so often to avoid
+  // blocking the main thread from allocating chunks.
+  //
+  // Also use this opportunity to periodically recalculate the GC thresholds
+  // as we free more memory.
+  static const size_t LockReleasePeriod = 32;
+
+  while (emptyArenas) {
+    AutoLockGC lock(this);
+    for (size_t i = 0; i < LockReleasePeriod && emptyArenas; i++) {
+      Arena* arena = emptyArenas;
+      emptyArenas = emptyArenas->next;
+      releaseArena(arena, lock);
+    }
+    zone->updateGCThresholds(*this, invocationKind, lock);
+  }
 }
 
 void GCRuntime::assertBackgroundSweepingFinished() {
@@ -3657,9 +3878,20 @@ void GCRuntime::purgeRuntime() {
   JSContext* cx = rt->mainContextFromOwnThread();
   queueUnusedLifoBlocksForFree(&cx->tempLifoAlloc());
   cx->interpreterStack().purge(rt);
-  cx->frontendCollectionPool().purge();
+  if (invocationKind == GC_SHRINK) {
+    cx->frontendCollectionPool().purge();
+  } else {
+    cx->frontendCollectionPool().trim();
+  }
 
   rt->caches().purge();
+  if (invocationKind == GC_SHRINK) {
+    rt->caches().uncompressedSourceCache.purge();
+
+    // The Rust frontend's compile cache is shared by all runtimes in the
+    // process and is bounded in size, so only drop it when memory is short.
+    frontend::Jsparagus::clearCompileCache();
+  }
 
   if (auto cache = rt->maybeThisRuntimeSharedImmutableStrings()) {
     cache->purge();
@@ -4845,12 +5077,90 @@ class ImmediateSweepWeakCacheTask
   }
 };
 
-void GCRuntime::updateAtomsBitmap() {
-  DenseBitmap marked;
-  if (atomMarking.computeBitmapFromChunkMarkBits(rt, marked)) {
+// Refines the atom marking bitmaps of collected zones taken from a shared
+// list. The list is protected by the helper thread lock.
+class RefineAtomBitmapsTask
+    : public GCParallelTaskHelper<RefineAtomBitmapsTask> {
+  Vector<Zone*, 0, SystemAllocPolicy>& zones_;
+  size_t& nextZone_;
+  const DenseBitmap& marked_;
+
+ public:
+  RefineAtomBitmapsTask(GCRuntime* gc,
+                        Vector<Zone*, 0, SystemAllocPolicy>& zones,
+                        size_t& nextZone, const DenseBitmap& marked)
+      : GCParallelTaskHelper(gc),
+        zones_(zones),
+        nextZone_(nextZone),
+        marked_(marked) {}
+
+  void run() {
+    for (;;) {
+      Zone* zone;
+      {
+        AutoLockHelperThreadState lock;
+        if (nextZone_ == zones_.length()) {
+          return;
+        }
+        zone = zones_[nextZone_++];
+      }
+      gc->atomMarking.refineZoneBitmapForCollectedZone(zone, marked_);
+    }
+  }
+};
+
+static const size_t MaxRefineAtomBitmapsTasks = 4;
+
+// Don't bother starting helper tasks for a small number of zones.
+static const size_t MinZonesForParallelAtomBitmapRefinement = 16;
+
+void GCRuntime::refineAtomBitmaps(const DenseBitmap& marked) {
+  Vector<Zone*, 0, SystemAllocPolicy> zones;
+  for (GCZonesIter zone(this); !zone.done(); zone.next()) {
+    if (!zone->isAtomsZone() && !zones.append(zone)) {
+      zones.clear();
+      break;
+    }
+  }
+
+  if (zones.length() < MinZonesForParallelAtomBitmapRefinement ||
+      !CanUseExtraThreads()) {
     for (GCZonesIter zone(this); !zone.done(); zone.next()) {
       atomMarking.refineZoneBitmapForCollectedZone(zone, marked);
     }
+    return;
+  }
+
+  size_t nextZone = 0;
+  size_t taskCount = std::min(HelperThreadState().cpuCount,
+                              MaxRefineAtomBitmapsTasks);
+  Maybe<RefineAtomBitmapsTask> tasks[MaxRefineAtomBitmapsTasks];
+
+  {
+    AutoLockHelperThreadState lock;
+    for (size_t i = 0; i < taskCount; i++) {
+      tasks[i].emplace(this, zones, nextZone, marked);
+      tasks[i]->startWithLockHeld(lock);
+    }
+  }
+
+  // Refine bitmaps on the main thread as well until all zones are done.
+  RefineAtomBitmapsTask mainThreadTask(this, zones, nextZone, marked);
+  mainThreadTask.runFromMainThread();
+
+  // These tasks run inside the UPDATE_ATOMS_BITMAP phase, so join them
+  // directly rather than with joinTask(), which would try to enter a child
+  // phase for them.
+  AutoLockHelperThreadState lock;
+  for (size_t i = 0; i < taskCount; i++) {
+    tasks[i]->joinWithLockHeld(lock);
+  }
+}
+
+void GCRuntime::updateAtomsBitmap() {
+  DenseBitmap marked;
+  if (atomMarking.computeBitmapFromChunkMarkBits(rt, marked)) {
+    refineAtomBitmaps(marked);
   } else {
     // Ignore OOM in computeBitmapFromChunkMarkBits. The
     // refineZoneBitmapForCollectedZone call can only remove atoms from the
@@ -5258,7 +5568,12 @@ IncrementalProgress GCRuntime::beginSweepingSweepGroup(JSFreeOp* fop,
   // Queue all GC things in all zones for sweeping, either on the foreground
   // or on the background thread.
 
+  // Shrinking GCs may compact, which relies on the arena lists being sorted
+  // by free space.
+  bool preferDenselyFreeArenas = invocationKind != GC_SHRINK;
+
   for (SweepGroupZonesIter zone(this); !zone.done(); zone.next()) {
+    zone->arenas.setPreferDenselyFreeArenas(preferDenselyFreeArenas);
     zone->arenas.queueForForegroundSweep(fop, ForegroundObjectFinalizePhase);
     zone->arenas.queueForForegroundSweep(fop, ForegroundNonObjectFinalizePhase);
     for (unsigned i = 0; i < ArrayLength(BackgroundFinalizePhases); ++i) {
@@ -5385,7 +5700,7 @@ bool ArenaLists::foregroundFinalize(JSFreeOp* fop, AllocKind thingKind,
   if (!FinalizeArenas(fop, &arenaListsToSweep(thingKind), sweepList, thingKind,
                       sliceBudget)) {
     incrementalSweptArenaKind = thingKind;
-    incrementalSweptArenas = sweepList.toArenaList();
+    incrementalSweptArenas = sweepList.toArenaList(preferDenselyFreeArenas_);
     return false;
   }
 
@@ -5394,7 +5709,7 @@ bool ArenaLists::foregroundFinalize(JSFreeOp* fop, AllocKind thingKind,
 
   sweepList.extractEmpty(&savedEmptyArenas.ref());
 
-  ArenaList finalized = sweepList.toArenaList();
+  ArenaList finalized = sweepList.toArenaList(preferDenselyFreeArenas_);
   arenaLists(thingKind) =
       finalized.insertListWithCursorAtEnd(arenaLists(thingKind));
 
@@ -7669,34 +7984,16 @@ void GCRuntime::mergeRealms(Realm* source, Realm* target) {
     group->realm_ = target;
   }
 
-  // Fixup zone pointers in source's zone to refer to target's zone.
-
-  bool targetZoneIsCollecting =
-      isIncrementalGCInProgress() && target->zone()->wasGCStarted();
-  for (auto thingKind : AllAllocKinds()) {
-    for (ArenaIter aiter(source->zone(), thingKind); !aiter.done();
-         aiter.next()) {
-      Arena* arena = aiter.get();
-      arena->zone = target->zone();
-      if (MOZ_UNLIKELY(targetZoneIsCollecting)) {
-        // If we are currently collecting the target zone then we must
-        // treat all merged things as if they were allocated during the
-        // collection.
-        for (ArenaCellIter iter(arena); !iter.done(); iter.next()) {
-          TenuredCell* cell = iter.getCell();
-          MOZ_ASSERT(!cell->isMarkedAny());
-          cell->markBlack();
-        }
-      }
-    }
-  }
-
   // The source should be the only realm in its zone.
   for (RealmsInZoneIter r(source->zone()); !r.done(); r.next()) {
     MOZ_ASSERT(r.get() == source);
   }
 
   // Merge the allocator, stats and UIDs in source's zone into target's zone.
+  // Adopting the arenas also fixes up their zone pointers, so that each arena
+  // header is only visited once while the main thread is blocked.
+  bool targetZoneIsCollecting =
+      isIncrementalGCInProgress() && target->zone()->wasGCStarted();
   target->zone()->arenas.adoptArenas(&source->zone()->arenas,
                                      targetZoneIsCollecting);
   target->zone()->addTenuredAllocsSinceMinorGC(
@@ -7845,9 +8142,12 @@ void ArenaLists::adoptArenas(ArenaLists* fromArenaLists,
   AutoLockGC lock(runtime());
 
   fromArenaLists->clearFreeLists();
+  fromArenaLists->releaseReservedArenas(lock);
 
   for (auto thingKind : AllAllocKinds()) {
     MOZ_ASSERT(fromArenaLists->concurrentUse(thingKind) == ConcurrentUse::None);
+    MOZ_ASSERT(!fromArenaLists->getFirstArenaToSweep(thingKind));
+    MOZ_ASSERT(!fromArenaLists->getFirstSweptArena(thingKind));
     ArenaList* fromList = &fromArenaLists->arenaLists(thingKind);
     ArenaList* toList = &arenaLists(thingKind);
     fromList->check();
@@ -7858,6 +8158,19 @@ void ArenaLists::adoptArenas(ArenaLists* fromArenaLists,
       next = fromArena->next;
 
       MOZ_ASSERT(!fromArena->isEmpty());
+      MOZ_ASSERT(fromArena->zone != zone_);
+
+      fromArena->zone = zone_;
+
+      // If the target zone is being collected then we must treat all merged
+      // things as if they were allocated during the collection.
+      if (MOZ_UNLIKELY(targetZoneIsCollecting)) {
+        for (ArenaCellIter iter(fromArena); !iter.done(); iter.next()) {
+          TenuredCell* cell = iter.getCell();
+          MOZ_ASSERT(!cell->isMarkedAny());
+          cell->markBlack();
+        }
+      }
 
       // If the target zone is being collected then we need to add the
       // arenas before the cursor because the collector assumes that the
@@ -8095,6 +8408,16 @@ JS_PUBLIC_API bool JS::IsGCScheduled(JSContext* cx) {
 
 JS_PUBLIC_API void JS::SkipZoneForGC(Zone* zone) { zone->unscheduleGC(); }
 
+JS_PUBLIC_API void JS::SetZoneGCHeapQuota(Zone* zone, size_t bytes) {
+  MOZ_ASSERT(!zone->isAtomsZone());
+  zone->gcHeapQuota = bytes;
+  zone->gcHeapQuotaTriggered = false;
+}
+
+JS_PUBLIC_API size_t JS::GetZoneGCHeapQuota(Zone* zone) {
+  return zone->gcHeapQuota;
+}
+
 JS_PUBLIC_API void JS::NonIncrementalGC(JSContext* cx,
                                         JSGCInvocationKind gckind,
                                         GCReason reason) {
@@ -8114,6 +8437,13 @@ JS_PUBLIC_API void JS::IncrementalGCSlice(JSContext* cx, GCReason reason,
   cx->runtime()->gc.gcSlice(reason, millis);
 }
 
+JS_PUBLIC_API JS::IdleGCWork JS::RunIdleTimeGCWork(JSContext* cx,
+                                                   TimeStamp deadline) {
+  AssertHeapIsIdle();
+  CHECK_THREAD(cx);
+  return cx->runtime()->gc.idleTimeGCWork(deadline);
+}
+
 JS_PUBLIC_API bool JS::IncrementalGCHasForegroundWork(JSContext* cx) {
   MOZ_ASSERT(!JS::RuntimeHeapIsBusy());
   CHECK_THREAD(cx);
@@ -8229,6 +8559,15 @@ JS::SetGCNurseryCollectionCallback(JSContext* cx,
   return cx->runtime()->gc.setNurseryCollectionCallback(callback);
 }
 
+JS_PUBLIC_API void JS::GetGCPauseHistogram(JSContext* cx,
+                                           GCPauseHistogram* histogram) {
+  *histogram = cx->runtime()->gc.stats().pauseHistogram();
+}
+
+JS_PUBLIC_API void JS::ResetGCPauseHistogram(JSContext* cx) {
+  cx->runtime()->gc.stats().resetPauseHistogram();
+}
+
 JS_PUBLIC_API void JS::SetLowMemoryState(JSContext* cx, bool newState) {
   return cx->runtime()->gc.setLowMemoryState(newState);
 }
@@ -300,6 +300,9 @@ class GCRuntime {
   void maybeGC();
   bool checkEagerAllocTrigger(const HeapSize& size,
                               const HeapThreshold& threshold);
+  bool checkZoneHeapQuota(Zone* zone);
+  bool scheduleZonesOverEagerTrigger();
+  JS::IdleGCWork idleTimeGCWork(mozilla::TimeStamp deadline);
   // The return value indicates whether a major GC was performed.
   bool gcIfRequested();
   void gc(JSGCInvocationKind gckind, JS::GCReason reason);
@@ -702,6 +705,7 @@ class GCRuntime {
   void markIncomingCrossCompartmentPointers(MarkColor color);
   IncrementalProgress beginSweepingSweepGroup(JSFreeOp* fop,
                                               SliceBudget& budget);
+  void refineAtomBitmaps(const DenseBitmap& marked);
   void updateAtomsBitmap();
   void sweepDebuggerOnMainThread(JSFreeOp* fop);
   void sweepJitDataOnMainThread(JSFreeOp* fop);
@@ -730,6 +734,8 @@ class GCRuntime {
   void startBackgroundFree();
   void freeFromBackgroundThread(AutoLockHelperThreadState& lock);
   void sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks);
+  void sweepBackgroundZones(ZoneList& zones);
+  void sweepBackgroundZone(JSFreeOp* fop, Zone* zone);
   void assertBackgroundSweepingFinished();
   bool shouldCompact();
   void beginCompactPhase();
@@ -1116,6 +1122,7 @@ class GCRuntime {
   js::Mutex lock;
 
   friend class BackgroundSweepTask;
+  friend class BackgroundSweepZonesTask;
   friend class BackgroundFreeTask;
 
   BackgroundAllocTask allocTask;
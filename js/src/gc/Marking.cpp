@@ -790,6 +790,11 @@ void GCMarker::markImplicitEdgesHelper(T markedThing) {
   MOZ_ASSERT(zone->isGCMarking());
   MOZ_ASSERT(!zone->isGCSweeping());
 
+  // Most zones have no pending weak keys, so avoid hashing every cell we mark.
+  if (zone->gcWeakKeys().count() == 0) {
+    return;
+  }
+
   auto p = zone->gcWeakKeys().get(markedThing);
   if (!p) {
     return;
@@ -2999,6 +3004,9 @@ void js::gc::StoreBuffer::MonoTypeBuffer<T>::trace(TenuringTracer& mover) {
   if (last_) {
     last_.trace(mover);
   }
+  for (size_t i = 0; i < bufferCount_; i++) {
+    buffer_[i].trace(mover);
+  }
   for (typename StoreSet::Range r = stores_.all(); !r.empty(); r.popFront()) {
     r.front().trace(mover);
   }
@@ -3423,6 +3431,46 @@ inline void js::TenuringTracer::insertIntoStringFixupList(
   *stringTail = nullptr;
 }
 
+/* static */
+HashNumber js::TenuringTracer::DeduplicationStringHasher::hash(JSString* str) {
+  JSLinearString& linear = str->asLinear();
+  JS::AutoCheckCannotGC nogc;
+  return linear.hasLatin1Chars()
+             ? mozilla::HashString(linear.latin1Chars(nogc), linear.length())
+             : mozilla::HashString(linear.twoByteChars(nogc),
+                                   linear.length());
+}
+
+/* static */
+bool js::TenuringTracer::DeduplicationStringHasher::match(JSString* key,
+                                                          JSString* lookup) {
+  return key->zone() == lookup->zone() &&
+         key->getAllocKind() == lookup->getAllocKind() &&
+         key->hasLatin1Chars() == lookup->hasLatin1Chars() &&
+         EqualStrings(&key->asLinear(), &lookup->asLinear());
+}
+
+// If string deduplication is enabled and |src| is identical to an inline
+// string already tenured by this collection, return that string.
+//
+// Only inline strings are considered. Their characters are stored in the cell
+// itself so they can never be the base of a dependent string or the owner of a
+// buffer that something else points to. Strings with a unique ID are skipped
+// as the ID can't be transferred to a cell that already has its own.
+JSString* js::TenuringTracer::maybeDeduplicateString(JSString* src) {
+  if (!stringDeDupSet || !src->isInline() ||
+      src->zone()->hasUniqueId(src)) {
+    return nullptr;
+  }
+
+  auto p = stringDeDupSet->lookup(src);
+  if (!p) {
+    return nullptr;
+  }
+
+  return *p;
+}
+
 JSString* js::TenuringTracer::moveToTenured(JSString* src) {
   MOZ_ASSERT(IsInsideNursery(src));
   MOZ_ASSERT(!src->zone()->usedByHelperThread());
@@ -3431,10 +3479,25 @@ JSString* js::TenuringTracer::moveToTenured(JSString* src) {
   Zone* zone = src->zone();
   zone->tenuredStrings++;
 
+  if (JSString* existing = maybeDeduplicateString(src)) {
+    // The existing string is already on the fixup list and inline strings have
+    // no children, so there is nothing more to do.
+    RelocationOverlay::fromCell(src)->forwardTo(existing);
+    deduplicatedStrings++;
+    gcTracer.tracePromoteToTenured(src, existing);
+    return existing;
+  }
+
   JSString* dst = allocTenured<JSString>(zone, dstKind);
   tenuredSize += moveStringToTenured(dst, src, dstKind);
   tenuredCells++;
 
+  // Failing to add the string only loses the chance to deduplicate against
+  // it, so ignore OOM here.
+  if (stringDeDupSet && dst->isInline() && !zone->hasUniqueId(src)) {
+    (void)stringDeDupSet->put(dst);
+  }
+
   RelocationOverlay* overlay = RelocationOverlay::fromCell(src);
   overlay->forwardTo(dst);
   insertIntoStringFixupList(overlay);
@@ -762,7 +762,12 @@ js::TenuringTracer::TenuringTracer(JSRuntime* rt, Nursery* nursery)
       stringHead(nullptr),
       stringTail(&stringHead),
       bigIntHead(nullptr),
-      bigIntTail(&bigIntHead) {}
+      bigIntTail(&bigIntHead),
+      deduplicatedStrings(0) {
+  if (rt->gc.tunables.isStringDeduplicationEnabled()) {
+    stringDeDupSet.emplace();
+  }
+}
 
 inline float js::Nursery::calcPromotionRate(bool* validForTenuring) const {
   float used = float(previousGC.nurseryUsedBytes);
@@ -815,6 +820,7 @@ void js::Nursery::renderProfileJSON(JSONPrinter& json) const {
   json.property("cells_tenured", previousGC.tenuredCells);
   json.property("strings_tenured",
                 stats().getStat(gcstats::STAT_STRINGS_TENURED));
+  json.property("strings_deduplicated", previousGC.deduplicatedStrings);
   json.property("bigints_tenured",
                 stats().getStat(gcstats::STAT_BIGINTS_TENURED));
   json.property("bytes_used", previousGC.nurseryUsedBytes);
@@ -1008,6 +1014,12 @@ void js::Nursery::collect(JS::GCReason reason) {
     previousGC.nurseryCommitted = committed();
     previousGC.tenuredBytes = 0;
     previousGC.tenuredCells = 0;
+    previousGC.deduplicatedStrings = 0;
+  }
+  previousGC.duration = ReallyNow() - startTimes_[ProfileKey::Total];
+  if (previousGC.nurseryUsedBytes) {
+    recentPromotionRate_ =
+        (recentPromotionRate_ + double(calcPromotionRate(nullptr))) / 2.0;
   }
 
   // Resize the nursery.
@@ -1185,6 +1197,7 @@ void js::Nursery::doCollection(JS::GCReason reason,
   previousGC.nurseryUsedBytes = initialNurseryUsedBytes;
   previousGC.tenuredBytes = mover.tenuredSize;
   previousGC.tenuredCells = mover.tenuredCells;
+  previousGC.deduplicatedStrings = mover.deduplicatedStrings;
 }
 
 float js::Nursery::doPretenuring(JSRuntime* rt, JS::GCReason reason,
@@ -1502,6 +1515,28 @@ void js::Nursery::maybeResizeNursery(JS::GCReason reason) {
       std::min(maxNurseryBytes, (CheckedInt<size_t>(capacity()) * 2).value());
   newCapacity = roundSize(mozilla::Clamp(newCapacity, lowLimit, highLimit));
 
+  // If there is a pause time target, don't grow past the size we expect to
+  // collect within it, and shrink towards it if we are already over.
+  size_t pauseLimit = maxNurseryBytes;
+  const TimeDuration pauseTarget = tunables().nurseryPauseTarget();
+  if (!pauseTarget.IsZero()) {
+    size_t bytes =
+        capacityForPauseTarget(pauseTarget, previousGC.duration,
+                               previousGC.tenuredBytes, recentPromotionRate_);
+    bytes = std::min(bytes, maxNurseryBytes);
+    pauseLimit = std::max(minNurseryBytes, roundSize(bytes));
+  }
+
+  if (capacity() > pauseLimit) {
+    newCapacity = roundSize(std::max(pauseLimit, lowLimit));
+    if (capacity() >= minNurseryBytes + SubChunkStep &&
+        newCapacity < capacity()) {
+      shrinkAllocableSpace(newCapacity);
+    }
+    return;
+  }
+  newCapacity = std::min(newCapacity, pauseLimit);
+
   if (capacity() < maxNurseryBytes && promotionRate > GrowThreshold &&
       newCapacity > capacity()) {
     growAllocableSpace(newCapacity);
@@ -1511,6 +1546,26 @@ void js::Nursery::maybeResizeNursery(JS::GCReason reason) {
   }
 }
 
+/* static */
+size_t js::Nursery::capacityForPauseTarget(TimeDuration pauseTarget,
+                                           TimeDuration duration,
+                                           size_t tenuredBytes,
+                                           double promotionRate) {
+  if (!tenuredBytes || duration.IsZero() || promotionRate <= 0.0) {
+    return SIZE_MAX;
+  }
+
+  // The pause for a nursery of |capacity| bytes is predicted as
+  // |capacity * promotionRate * secondsPerTenuredByte|.
+  double secondsPerTenuredByte = duration.ToSeconds() / double(tenuredBytes);
+  double capacity =
+      pauseTarget.ToSeconds() / (secondsPerTenuredByte * promotionRate);
+  if (capacity >= double(SIZE_MAX)) {
+    return SIZE_MAX;
+  }
+  return size_t(capacity);
+}
+
 bool js::Nursery::maybeResizeExact(JS::GCReason reason) {
   // Shrink the nursery to its minimum size if we ran out of memory or
   // received a memory pressure event.
@@ -9,11 +9,13 @@
 #define gc_Nursery_h
 
 #include "mozilla/EnumeratedArray.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/TimeStamp.h"
 
 #include "gc/GCParallelTask.h"
 #include "gc/Heap.h"
 #include "js/Class.h"
+#include "js/HashTable.h"
 #include "js/HeapAPI.h"
 #include "js/TracingAPI.h"
 #include "js/TypeDecls.h"
@@ -117,6 +119,23 @@ class TenuringTracer : public JSTracer {
   gc::RelocationOverlay* bigIntHead;
   gc::RelocationOverlay** bigIntTail;
 
+  // Hash inline strings by their characters, so that identical strings can be
+  // deduplicated as they are tenured.
+  struct DeduplicationStringHasher {
+    using Lookup = JSString*;
+    static HashNumber hash(JSString* str);
+    static bool match(JSString* key, JSString* lookup);
+  };
+  using StringDeduplicationSet =
+      HashSet<JSString*, DeduplicationStringHasher, SystemAllocPolicy>;
+
+  // The inline strings tenured by this collection, if string deduplication is
+  // enabled.
+  mozilla::Maybe<StringDeduplicationSet> stringDeDupSet;
+
+  // Number of strings forwarded to an existing tenured copy.
+  size_t deduplicatedStrings;
+
   TenuringTracer(JSRuntime* rt, Nursery* nursery);
 
  public:
@@ -145,6 +164,7 @@ class TenuringTracer : public JSTracer {
   inline JSObject* movePlainObjectToTenured(PlainObject* src);
   JSObject* moveToTenuredSlow(JSObject* src);
   JSString* moveToTenured(JSString* src);
+  JSString* maybeDeduplicateString(JSString* src);
   JS::BigInt* moveToTenured(JS::BigInt* src);
 
   size_t moveElementsToTenured(NativeObject* dst, NativeObject* src,
@@ -431,6 +451,21 @@ class Nursery {
 
   bool shouldCollect() const;
 
+  // The time taken by the most recent minor GC.
+  mozilla::TimeDuration previousGCDuration() const {
+    return previousGC.duration;
+  }
+
+  // Estimate the largest nursery that can be collected within |pauseTarget|.
+  // Tenuring dominates the time a minor GC takes, so this uses the cost of
+  // each byte tenured by the last collection and the recent promotion rate.
+  // Returns SIZE_MAX if the last collection didn't tenure anything, as there
+  // is nothing to estimate from and the pause doesn't depend on the size.
+  static size_t capacityForPauseTarget(mozilla::TimeDuration pauseTarget,
+                                       mozilla::TimeDuration duration,
+                                       size_t tenuredBytes,
+                                       double promotionRate);
+
   bool enableProfiling() const { return enableProfiling_; }
 
   bool addMapWithNurseryMemory(MapObject* obj) {
@@ -532,8 +567,14 @@ class Nursery {
     size_t nurseryUsedBytes = 0;
     size_t tenuredBytes = 0;
     size_t tenuredCells = 0;
+    size_t deduplicatedStrings = 0;
+    mozilla::TimeDuration duration;
   } previousGC;
 
+  // The fraction of used nursery bytes tenured, averaged over recent
+  // collections with a decay of one half per collection.
+  double recentPromotionRate_ = 0.0;
+
   // Calculate the promotion rate of the most recent minor GC.
   // The valid_for_tenuring parameter is used to return whether this
   // promotion rate is accurate enough (the nursery was full enough) to be
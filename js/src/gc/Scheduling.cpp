@@ -65,7 +65,12 @@ GCSchedulingTunables::GCSchedulingTunables()
       minLastDitchGCPeriod_(
           TimeDuration::FromSeconds(TuningDefaults::MinLastDitchGCPeriod)),
       mallocThresholdBase_(TuningDefaults::MallocThresholdBase),
-      mallocGrowthFactor_(TuningDefaults::MallocGrowthFactor) {}
+      mallocGrowthFactor_(TuningDefaults::MallocGrowthFactor),
+      nurseryPauseTarget_(TimeDuration::FromMicroseconds(
+          TuningDefaults::NurseryPauseTargetUS)),
+      decommitFreeArenasEnabled_(TuningDefaults::DecommitFreeArenasEnabled),
+      stringDeduplicationEnabled_(TuningDefaults::StringDeduplicationEnabled) {
+}
 
 bool GCSchedulingTunables::setParameter(JSGCParamKey key, uint32_t value,
                                         const AutoLockGC& lock) {
@@ -207,6 +212,15 @@ bool GCSchedulingTunables::setParameter(JSGCParamKey key, uint32_t value,
       mallocGrowthFactor_ = newGrowth;
       break;
     }
+    case JSGC_NURSERY_PAUSE_TARGET_US:
+      nurseryPauseTarget_ = TimeDuration::FromMicroseconds(value);
+      break;
+    case JSGC_DECOMMIT_FREE_ARENAS:
+      decommitFreeArenasEnabled_ = value != 0;
+      break;
+    case JSGC_STRING_DEDUPLICATION:
+      stringDeduplicationEnabled_ = value != 0;
+      break;
     default:
       MOZ_CRASH("Unknown GC parameter.");
   }
@@ -345,6 +359,16 @@ void GCSchedulingTunables::resetParameter(JSGCParamKey key,
     case JSGC_MALLOC_GROWTH_FACTOR:
       mallocGrowthFactor_ = TuningDefaults::MallocGrowthFactor;
       break;
+    case JSGC_NURSERY_PAUSE_TARGET_US:
+      nurseryPauseTarget_ =
+          TimeDuration::FromMicroseconds(TuningDefaults::NurseryPauseTargetUS);
+      break;
+    case JSGC_DECOMMIT_FREE_ARENAS:
+      decommitFreeArenasEnabled_ = TuningDefaults::DecommitFreeArenasEnabled;
+      break;
+    case JSGC_STRING_DEDUPLICATION:
+      stringDeduplicationEnabled_ = TuningDefaults::StringDeduplicationEnabled;
+      break;
     default:
       MOZ_CRASH("Unknown GC parameter.");
   }
@@ -419,6 +419,15 @@ static const size_t MallocThresholdBase = 38 * 1024 * 1024;
 /* JSGC_MALLOC_GROWTH_FACTOR */
 static const float MallocGrowthFactor = 1.5f;
 
+/* JSGC_NURSERY_PAUSE_TARGET_US */
+static const uint32_t NurseryPauseTargetUS = 0;
+
+/* JSGC_DECOMMIT_FREE_ARENAS */
+static const bool DecommitFreeArenasEnabled = true;
+
+/* JSGC_STRING_DEDUPLICATION */
+static const bool StringDeduplicationEnabled = false;
+
 }  // namespace TuningDefaults
 
 /*
@@ -579,6 +588,29 @@ class GCSchedulingTunables {
    */
   MainThreadOrGCTaskData<float> mallocGrowthFactor_;
 
+  /*
+   * JSGC_NURSERY_PAUSE_TARGET_US
+   *
+   * Target maximum minor GC duration used when resizing the nursery, or zero
+   * if there is no target.
+   */
+  MainThreadData<mozilla::TimeDuration> nurseryPauseTarget_;
+
+  /*
+   * JSGC_DECOMMIT_FREE_ARENAS
+   *
+   * Whether non-shrinking GCs decommit free arenas in chunks that are in use.
+   */
+  MainThreadData<bool> decommitFreeArenasEnabled_;
+
+  /*
+   * JSGC_STRING_DEDUPLICATION
+   *
+   * Whether minor GCs deduplicate identical inline strings as they are
+   * tenured.
+   */
+  MainThreadData<bool> stringDeduplicationEnabled_;
+
  public:
   GCSchedulingTunables();
 
@@ -629,6 +661,16 @@ class GCSchedulingTunables {
   size_t mallocThresholdBase() const { return mallocThresholdBase_; }
   float mallocGrowthFactor() const { return mallocGrowthFactor_; }
 
+  mozilla::TimeDuration nurseryPauseTarget() const {
+    return nurseryPauseTarget_;
+  }
+  bool isDecommitFreeArenasEnabled() const {
+    return decommitFreeArenasEnabled_;
+  }
+  bool isStringDeduplicationEnabled() const {
+    return stringDeduplicationEnabled_;
+  }
+
   MOZ_MUST_USE bool setParameter(JSGCParamKey key, uint32_t value,
                                  const AutoLockGC& lock);
   void resetParameter(JSGCParamKey key, const AutoLockGC& lock);
@@ -8,6 +8,7 @@
 
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Sprintf.h"
 #include "mozilla/TimeStamp.h"
 
@@ -1026,6 +1027,18 @@ void Statistics::endGC() {
   thresholdTriggered = false;
 }
 
+static void AddToHistogram(JS::GCDurationHistogram& histogram,
+                           TimeDuration duration) {
+  uint64_t us = uint64_t(std::max(duration.ToMicroseconds(), 0.0));
+  size_t bucket = us ? mozilla::FloorLog2(us) : 0;
+  bucket = std::min(bucket, JS::GCDurationHistogram::BucketCount - 1);
+
+  histogram.buckets[bucket]++;
+  histogram.count++;
+  histogram.totalMicroseconds += us;
+  histogram.maxMicroseconds = std::max(histogram.maxMicroseconds, us);
+}
+
 void Statistics::sendGCTelemetry() {
   JSRuntime* runtime = gc->rt;
   runtime->addTelemetry(JS_TELEMETRY_GC_IS_ZONE_GC,
@@ -1037,6 +1050,8 @@ void Statistics::sendGCTelemetry() {
   double markRate = markCount / markTime;
   runtime->addTelemetry(JS_TELEMETRY_GC_MARK_MS, markTime);
   runtime->addTelemetry(JS_TELEMETRY_GC_MARK_RATE, markRate);
+  pauseHistogram_.cellsMarked += markCount;
+  pauseHistogram_.markMicroseconds += uint64_t(markTotal.ToMicroseconds());
   runtime->addTelemetry(JS_TELEMETRY_GC_SWEEP_MS, t(phaseTimes[Phase::SWEEP]));
   if (gc->isCompactingGc()) {
     runtime->addTelemetry(JS_TELEMETRY_GC_COMPACT_MS,
@@ -1119,6 +1134,7 @@ void Statistics::sendGCTelemetry() {
 void Statistics::beginNurseryCollection(JS::GCReason reason) {
   count(COUNT_MINOR_GC);
   startingMinorGCNumber = gc->minorGCCount();
+  nurseryCollectionStart_ = ReallyNow();
   if (nurseryCollectionCallback) {
     (*nurseryCollectionCallback)(
         context(), JS::GCNurseryProgress::GC_NURSERY_COLLECTION_START, reason);
@@ -1126,6 +1142,9 @@ void Statistics::beginNurseryCollection(JS::GCReason reason) {
 }
 
 void Statistics::endNurseryCollection(JS::GCReason reason) {
+  AddToHistogram(pauseHistogram_.minorGCs,
+                 ReallyNow() - nurseryCollectionStart_);
+
   if (nurseryCollectionCallback) {
     (*nurseryCollectionCallback)(
         context(), JS::GCNurseryProgress::GC_NURSERY_COLLECTION_END, reason);
@@ -1192,6 +1211,7 @@ void Statistics::endSlice() {
     writeLogMessage("end slice");
 
     sendSliceTelemetry(slice);
+    AddToHistogram(pauseHistogram_.majorSlices, slice.duration());
 
     sliceCount_++;
   }
@@ -250,6 +250,9 @@ struct Statistics {
   TimeDuration clearMaxGCPauseAccumulator();
   TimeDuration getMaxGCPauseSinceClear();
 
+  const JS::GCPauseHistogram& pauseHistogram() const { return pauseHistogram_; }
+  void resetPauseHistogram() { pauseHistogram_ = JS::GCPauseHistogram(); }
+
   PhaseKind currentPhaseKind() const;
 
   static const size_t MAX_SUSPENDED_PHASES = MAX_PHASE_NESTING * 3;
@@ -432,6 +435,10 @@ struct Statistics {
   ProfileDurations totalTimes_;
   uint64_t sliceCount_;
 
+  /* Pause data exposed through JS::GetGCPauseHistogram. */
+  JS::GCPauseHistogram pauseHistogram_;
+  TimeStamp nurseryCollectionStart_;
+
   JSContext* context();
 
   Phase currentPhase() const;
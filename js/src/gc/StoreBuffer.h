@@ -78,6 +78,16 @@ class StoreBuffer {
      */
     T last_;
 
+    /*
+     * Recent stores that have not yet been added to the canonical set. These
+     * may contain duplicates, which are removed in bulk when the buffer is
+     * sunk, so that loops storing to a handful of locations don't pay for a
+     * hash insert on every store.
+     */
+    const static size_t BufferSize = 64;
+    T buffer_[BufferSize];
+    size_t bufferCount_;
+
     StoreBuffer* owner_;
 
     JS::GCReason gcReason_;
@@ -86,10 +96,11 @@ class StoreBuffer {
     const static size_t MaxEntries = 48 * 1024 / sizeof(T);
 
     explicit MonoTypeBuffer(StoreBuffer* owner, JS::GCReason reason)
-        : last_(T()), owner_(owner), gcReason_(reason) {}
+        : last_(T()), bufferCount_(0), owner_(owner), gcReason_(reason) {}
 
     void clear() {
       last_ = T();
+      bufferCount_ = 0;
       stores_.clear();
     }
 
@@ -106,24 +117,57 @@ class StoreBuffer {
         last_ = T();
         return;
       }
+      for (size_t i = 0; i < bufferCount_;) {
+        if (buffer_[i] == v) {
+          buffer_[i] = buffer_[--bufferCount_];
+        } else {
+          i++;
+        }
+      }
       stores_.remove(v);
     }
 
-    /* Move any buffered stores to the canonical store set. */
+    /* Move the last store into the buffer of recent stores. */
     void sinkStore() {
       if (last_) {
-        AutoEnterOOMUnsafeRegion oomUnsafe;
-        if (!stores_.put(last_)) {
-          oomUnsafe.crash("Failed to allocate for MonoTypeBuffer::put.");
+        if (bufferCount_ == BufferSize) {
+          sinkBuffer();
         }
+        buffer_[bufferCount_++] = last_;
       }
       last_ = T();
 
-      if (MOZ_UNLIKELY(stores_.count() > MaxEntries)) {
+      if (MOZ_UNLIKELY(stores_.count() + bufferCount_ > MaxEntries)) {
         owner_->setAboutToOverflow(gcReason_);
       }
     }
 
+    /*
+     * Move the buffered stores to the canonical store set. Sorting brings
+     * duplicate (or, for slots, overlapping) stores together so they can be
+     * merged before they are hashed.
+     */
+    void sinkBuffer() {
+      AutoEnterOOMUnsafeRegion oomUnsafe;
+      if (!stores_.reserve(stores_.count() + bufferCount_)) {
+        oomUnsafe.crash("Failed to allocate for MonoTypeBuffer::put.");
+      }
+
+      std::sort(buffer_, buffer_ + bufferCount_);
+
+      T* end = buffer_ + bufferCount_;
+      for (T* p = buffer_; p != end;) {
+        T edge = *p++;
+        while (p != end && MergeEdges(edge, *p)) {
+          p++;
+        }
+        if (!stores_.put(edge)) {
+          oomUnsafe.crash("Failed to allocate for MonoTypeBuffer::put.");
+        }
+      }
+      bufferCount_ = 0;
+    }
+
     /* Trace the source of all edges in the store buffer. */
     void trace(TenuringTracer& mover);
 
@@ -131,7 +175,9 @@ class StoreBuffer {
       return stores_.shallowSizeOfExcludingThis(mallocSizeOf);
     }
 
-    bool isEmpty() const { return last_ == T() && stores_.empty(); }
+    bool isEmpty() const {
+      return last_ == T() && bufferCount_ == 0 && stores_.empty();
+    }
 
    private:
     MonoTypeBuffer(const MonoTypeBuffer& other) = delete;
@@ -255,6 +301,7 @@ class StoreBuffer {
     bool operator!=(const CellPtrEdge& other) const {
       return edge != other.edge;
     }
+    bool operator<(const CellPtrEdge& other) const { return edge < other.edge; }
 
     bool maybeInRememberedSet(const Nursery& nursery) const {
       MOZ_ASSERT(IsInsideNursery(*edge));
@@ -279,6 +326,7 @@ class StoreBuffer {
     explicit ValueEdge(JS::Value* v) : edge(v) {}
     bool operator==(const ValueEdge& other) const { return edge == other.edge; }
     bool operator!=(const ValueEdge& other) const { return edge != other.edge; }
+    bool operator<(const ValueEdge& other) const { return edge < other.edge; }
 
     Cell* deref() const {
       return edge->isGCThing() ? static_cast<Cell*>(edge->toGCThing())
@@ -329,6 +377,15 @@ class StoreBuffer {
 
     bool operator!=(const SlotsEdge& other) const { return !(*this == other); }
 
+    // Order by object and kind, then by start index, so that sorting brings
+    // overlapping ranges together.
+    bool operator<(const SlotsEdge& other) const {
+      if (objectAndKind_ != other.objectAndKind_) {
+        return objectAndKind_ < other.objectAndKind_;
+      }
+      return start_ < other.start_;
+    }
+
     // True if this SlotsEdge range overlaps with the other SlotsEdge range,
     // false if they do not overlap.
     bool overlaps(const SlotsEdge& other) const {
@@ -378,6 +435,20 @@ class StoreBuffer {
     } Hasher;
   };
 
+  // Merge |b| into |a| if it is redundant with it. Called on adjacent entries
+  // of a sorted buffer.
+  template <typename Edge>
+  static bool MergeEdges(Edge& a, const Edge& b) {
+    return a == b;
+  }
+  static bool MergeEdges(SlotsEdge& a, const SlotsEdge& b) {
+    if (!a.overlaps(b)) {
+      return false;
+    }
+    a.merge(b);
+    return true;
+  }
+
   template <typename Buffer, typename Edge>
   void unput(Buffer& buffer, const Edge& edge) {
     MOZ_ASSERT(!JS::RuntimeHeapIsBusy());
@@ -398,6 +398,12 @@ void Zone::discardJitCode(JSFreeOp* fop,
       continue;
     }
 
+    // Ion code which lasted until it was discarded compiled successfully, so
+    // forget about any invalidations before it.
+    if (script->hasIonScript()) {
+      jitScript->resetIonInvalidationCount();
+    }
+
     jit::FinishInvalidation(fop, script);
 
     // Discard baseline script if it's not marked as active.
@@ -180,6 +180,13 @@ class ZoneAllocator : public JS::shadow::Zone,
   // the current GC.
   MainThreadData<size_t> gcDelayBytes;
 
+  // Embedder supplied limit on the GC heap size of this zone, or zero if there
+  // is none. See JS::SetZoneGCHeapQuota.
+  MainThreadData<size_t> gcHeapQuota;
+
+  // Whether reaching |gcHeapQuota| has triggered a GC since it was set.
+  MainThreadData<bool> gcHeapQuotaTriggered;
+
   // Amount of malloc data owned by GC things in this zone, including external
   // allocations supplied by JS::AddAssociatedMemory.
   gc::HeapSize mallocHeapSize;
@@ -271,6 +271,7 @@ bool jit::EnsureHasEnvironmentObjects(JSContext* cx, AbstractFramePtr fp) {
 }
 
 void jit::CheckFrequentBailouts(JSContext* cx, JSScript* script,
+                                JSScript* innerScript,
                                 BailoutKind bailoutKind) {
   if (script->hasIonScript()) {
     // Invalidate if this script keeps bailing out without invalidation. Next
@@ -288,9 +289,21 @@ void jit::CheckFrequentBailouts(JSContext* cx, JSScript* script,
         script->setHadFrequentBailouts();
       }
 
+      // Remember that the bailout happened in an inlined frame, so that the
+      // recompilation can keep the call instead of inlining it again.
+      if (bailoutKind != Bailout_FirstExecution && innerScript != script &&
+          !innerScript->hadFrequentBailoutsWhenInlined()) {
+        JitSpew(JitSpew_IonInvalidate,
+                "  Frequent bailouts in %s:%u:%u inlined into %s:%u:%u",
+                innerScript->filename(), innerScript->lineno(),
+                innerScript->column(), script->filename(), script->lineno(),
+                script->column());
+        innerScript->setHadFrequentBailoutsWhenInlined();
+      }
+
       JitSpew(JitSpew_IonInvalidate, "Invalidating due to too many bailouts");
 
-      Invalidate(cx, script);
+      InvalidateAfterDeoptimization(cx, script);
     }
   }
 }
@@ -227,7 +227,7 @@ MOZ_MUST_USE bool ExceptionHandlerBailout(JSContext* cx,
 MOZ_MUST_USE bool FinishBailoutToBaseline(BaselineBailoutInfo* bailoutInfoArg);
 
 void CheckFrequentBailouts(JSContext* cx, JSScript* script,
-                           BailoutKind bailoutKind);
+                           JSScript* innerScript, BailoutKind bailoutKind);
 
 }  // namespace jit
 }  // namespace js
@@ -1699,7 +1699,7 @@ static void InvalidateAfterBailout(JSContext* cx, HandleScript outerScript,
   MOZ_ASSERT(!outerScript->ionScript()->invalidated());
 
   JitSpew(JitSpew_BaselineBailouts, "Invalidating due to %s", reason);
-  Invalidate(cx, outerScript);
+  InvalidateAfterDeoptimization(cx, outerScript);
 }
 
 static void HandleBoundsCheckFailure(JSContext* cx, HandleScript outerScript,
@@ -1716,7 +1716,7 @@ static void HandleBoundsCheckFailure(JSContext* cx, HandleScript outerScript,
 
   InvalidateAfterBailout(cx, outerScript, "bounds check failure");
   if (innerScript->hasIonScript()) {
-    Invalidate(cx, innerScript);
+    InvalidateAfterDeoptimization(cx, innerScript);
   }
 }
 
@@ -1761,7 +1761,7 @@ static void HandleLexicalCheckFailure(JSContext* cx, HandleScript outerScript,
 
   InvalidateAfterBailout(cx, outerScript, "lexical check failure");
   if (innerScript->hasIonScript()) {
-    Invalidate(cx, innerScript);
+    InvalidateAfterDeoptimization(cx, innerScript);
   }
 }
 
@@ -1991,6 +1991,7 @@ bool jit::FinishBailoutToBaseline(BaselineBailoutInfo* bailoutInfoArg) {
   }
 
   BailoutKind bailoutKind = *bailoutInfo->bailoutKind;
+  cx->runtime()->jitRuntime()->noteBailout(bailoutKind);
   JitSpew(JitSpew_BaselineBailouts,
           "  Restored outerScript=(%s:%u:%u,%u) innerScript=(%s:%u:%u,%u) "
           "(bailoutKind=%u)",
@@ -2065,6 +2066,6 @@ bool jit::FinishBailoutToBaseline(BaselineBailoutInfo* bailoutInfoArg) {
       MOZ_CRASH("Unknown bailout kind!");
   }
 
-  CheckFrequentBailouts(cx, outerScript, bailoutKind);
+  CheckFrequentBailouts(cx, outerScript, innerScript, bailoutKind);
   return true;
 }
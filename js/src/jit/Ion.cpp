@@ -177,7 +177,11 @@ JitRuntime::JitRuntime()
       ionBailAfter_(0),
 #endif
       numFinishedBuilders_(0),
-      ionLazyLinkListSize_(0) {
+      ionLazyLinkListSize_(0),
+      ionInvalidationCount_(0) {
+  for (uint64_t& count : bailoutCounts_.ref()) {
+    count = 0;
+  }
 }
 
 JitRuntime::~JitRuntime() {
@@ -459,6 +463,9 @@ void jit::FinishOffThreadBuilder(JSRuntime* runtime, IonBuilder* builder,
     AbortReasonOr<Ok> status = builder->getOffThreadStatus();
     if (status.isErr() && status.unwrapErr() == AbortReason::Disable) {
       script->disableIon();
+    } else if (status.isErr() &&
+               status.unwrapErr() == AbortReason::CompileTimeBudget) {
+      script->resetWarmUpCounterToDelayIonCompilation();
     }
   }
 
@@ -2747,13 +2754,32 @@ void jit::InvalidateAll(JSFreeOp* fop, Zone* zone) {
 
 static void ClearIonScriptAfterInvalidation(JSContext* cx, JSScript* script,
                                             IonScript* ionScript,
-                                            bool resetUses) {
+                                            bool resetUses, bool deoptimized) {
   // Null out the JitScript's IonScript pointer. The caller is responsible for
   // destroying the IonScript using the invalidation count mechanism.
   DebugOnly<IonScript*> clearedIonScript =
       script->jitScript()->clearIonScript(cx->defaultFreeOp(), script);
   MOZ_ASSERT(clearedIonScript == ionScript);
 
+  // Count every invalidation, whatever its cause, for jitBailoutStats().
+  cx->runtime()->jitRuntime()->noteIonInvalidation();
+
+  // Scripts which keep getting invalidated are unlikely to stabilize, so
+  // stop compiling them instead of paying for another Ion compilation.
+  JitScript* jitScript = script->jitScript();
+  if (deoptimized) {
+    jitScript->incIonInvalidationCount();
+  }
+  uint32_t threshold = JitOptions.ionInvalidationThreshold;
+  if (threshold && jitScript->ionInvalidationCount() >= threshold) {
+    JitSpew(JitSpew_IonInvalidate,
+            "  Disabling Ion compilation of %s:%u:%u after %u invalidations",
+            script->filename(), script->lineno(), script->column(),
+            jitScript->ionInvalidationCount());
+    script->disableIon();
+    return;
+  }
+
   // Wait for the scripts to get warm again before doing another
   // compile, unless we are recompiling *because* a script got hot
   // (resetUses is false).
@@ -2764,7 +2790,7 @@ static void ClearIonScriptAfterInvalidation(JSContext* cx, JSScript* script,
 
 void jit::Invalidate(TypeZone& types, JSFreeOp* fop,
                      const RecompileInfoVector& invalid, bool resetUses,
-                     bool cancelOffThread) {
+                     bool cancelOffThread, bool deoptimized) {
   JitSpew(JitSpew_IonInvalidate, "Start invalidation.");
 
   // Add an invalidation reference to all invalidated IonScripts to indicate
@@ -2815,7 +2841,8 @@ void jit::Invalidate(TypeZone& types, JSFreeOp* fop,
       // jitScript->ionScript_ now. We don't want to do this unconditionally
       // because maybeIonScriptToInvalidate depends on script->ionScript() (we
       // would leak the IonScript if |invalid| contains duplicates).
-      ClearIonScriptAfterInvalidation(cx, info.script(), ionScript, resetUses);
+      ClearIonScriptAfterInvalidation(cx, info.script(), ionScript, resetUses,
+                                      deoptimized);
     }
 
     ionScript->decrementInvalidationCount(fop);
@@ -2830,15 +2857,16 @@ void jit::Invalidate(TypeZone& types, JSFreeOp* fop,
   // the stack.
   for (const RecompileInfo& info : invalid) {
     if (IonScript* ionScript = info.maybeIonScriptToInvalidate(types)) {
-      ClearIonScriptAfterInvalidation(cx, info.script(), ionScript, resetUses);
+      ClearIonScriptAfterInvalidation(cx, info.script(), ionScript, resetUses,
+                                      deoptimized);
     }
   }
 }
 
 void jit::Invalidate(JSContext* cx, const RecompileInfoVector& invalid,
-                     bool resetUses, bool cancelOffThread) {
+                     bool resetUses, bool cancelOffThread, bool deoptimized) {
   jit::Invalidate(cx->zone()->types, cx->runtime()->defaultFreeOp(), invalid,
-                  resetUses, cancelOffThread);
+                  resetUses, cancelOffThread, deoptimized);
 }
 
 void jit::IonScript::invalidate(JSContext* cx, JSScript* script, bool resetUses,
@@ -2859,7 +2887,7 @@ void jit::IonScript::invalidate(JSContext* cx, JSScript* script, bool resetUses,
 }
 
 void jit::Invalidate(JSContext* cx, JSScript* script, bool resetUses,
-                     bool cancelOffThread) {
+                     bool cancelOffThread, bool deoptimized) {
   MOZ_ASSERT(script->hasIonScript());
 
   if (cx->runtime()->geckoProfiler().enabled()) {
@@ -2889,7 +2917,12 @@ void jit::Invalidate(JSContext* cx, JSScript* script, bool resetUses,
   MOZ_RELEASE_ASSERT(scripts.reserve(1));
   scripts.infallibleEmplaceBack(script, script->ionScript()->compilationId());
 
-  Invalidate(cx, scripts, resetUses, cancelOffThread);
+  Invalidate(cx, scripts, resetUses, cancelOffThread, deoptimized);
+}
+
+void jit::InvalidateAfterDeoptimization(JSContext* cx, JSScript* script) {
+  Invalidate(cx, script, /* resetUses = */ true, /* cancelOffThread = */ true,
+             /* deoptimized = */ true);
 }
 
 void jit::FinishInvalidation(JSFreeOp* fop, JSScript* script) {
@@ -32,6 +32,7 @@ enum class AbortReason : uint8_t {
   Alloc,
   Inlining,
   PreliminaryObjects,
+  CompileTimeBudget,
   Disable,
   Error,
   NoAbort
@@ -185,13 +186,23 @@ static inline bool IsErrorStatus(JitExecStatus status) {
 struct EnterJitData;
 
 // Walk the stack and invalidate active Ion frames for the invalid scripts.
+//
+// |deoptimized| is set when the Ion code made an assumption which turned out
+// to be wrong, after a bailout or a type change. Only such invalidations count
+// towards JitOptions.ionInvalidationThreshold; others, such as replacing code
+// at link time or invalidating for the Debugger, don't.
 void Invalidate(TypeZone& types, JSFreeOp* fop,
                 const RecompileInfoVector& invalid, bool resetUses = true,
-                bool cancelOffThread = true);
+                bool cancelOffThread = true, bool deoptimized = false);
 void Invalidate(JSContext* cx, const RecompileInfoVector& invalid,
-                bool resetUses = true, bool cancelOffThread = true);
+                bool resetUses = true, bool cancelOffThread = true,
+                bool deoptimized = false);
 void Invalidate(JSContext* cx, JSScript* script, bool resetUses = true,
-                bool cancelOffThread = true);
+                bool cancelOffThread = true, bool deoptimized = false);
+
+// Invalidate |script| after a bailout showed that its Ion code made a wrong
+// assumption.
+void InvalidateAfterDeoptimization(JSContext* cx, JSScript* script);
 
 class IonBuilder;
 class MIRGenerator;
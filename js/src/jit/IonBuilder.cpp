@@ -1195,7 +1195,19 @@ void IonBuilder::runTask() {
   AutoTraceLog logCompile(logger, TraceLogger_IonCompilation);
 
   jit::JitContext jctx(realm->runtime(), realm, &alloc());
+
+  if (uint32_t budget = JitOptions.ionCompileTimeBudgetMs) {
+    setCompileTimeBudget(mozilla::TimeDuration::FromMilliseconds(budget));
+  }
+
   setBackgroundCodegen(jit::CompileBackEnd(this));
+
+  // The build may have been slow only because the helper threads were busy,
+  // so don't disable Ion for the script. FinishOffThreadBuilder makes it warm
+  // up again before it is retried.
+  if (exceededCompileTimeBudget() && getOffThreadStatus().isOk()) {
+    setOffThreadStatus(mozilla::Err(AbortReason::CompileTimeBudget));
+  }
 }
 
 void IonBuilder::rewriteParameter(uint32_t slotIdx, MDefinition* param) {
@@ -4379,6 +4391,7 @@ IonBuilder::InliningResult IonBuilder::inlineScriptedCall(CallInfo& callInfo,
 
       case AbortReason::Alloc:
       case AbortReason::Inlining:
+      case AbortReason::CompileTimeBudget:
       case AbortReason::Error:
         return Err(result.unwrapErr());
 
@@ -4616,6 +4629,16 @@ IonBuilder::InliningDecision IonBuilder::makeInliningDecision(
 
   IonBuilder* outerBuilder = outermostBuilder();
 
+  // If we are recompiling because of frequent bailouts and the callee caused
+  // bailouts while inlined before, keep the call so the callee's bailouts
+  // don't invalidate the whole compilation again.
+  if (outerBuilder->info().hadFrequentBailouts() &&
+      targetScript->hadFrequentBailoutsWhenInlined()) {
+    trackOptimizationOutcome(TrackedOutcome::CantInlineGeneric);
+    return DontInline(targetScript,
+                      "Vetoed: callee bailed out frequently when inlined");
+  }
+
   // Cap the total bytecode length we inline under a single script, to avoid
   // excessive inlining in pathological cases.
   size_t totalBytecodeLength =
@@ -14330,6 +14353,11 @@ AbortReasonOr<MDefinition*> IonBuilder::addLexicalCheck(MDefinition* input) {
     return constant(UndefinedValue());
   }
 
+  // A value which already passed a lexical check can't be uninitialized.
+  if (input->isLexicalCheck()) {
+    return input;
+  }
+
   if (input->type() == MIRType::Value) {
     lexicalCheck = MLexicalCheck::New(alloc(), input);
     current->add(lexicalCheck);
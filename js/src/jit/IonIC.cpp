@@ -212,7 +212,7 @@ bool IonGetPropertyIC::update(JSContext* cx, HandleScript outerScript,
 
     // Do not re-invalidate if the lookup already caused invalidation.
     if (outerScript->hasIonScript()) {
-      Invalidate(cx, outerScript);
+      InvalidateAfterDeoptimization(cx, outerScript);
     }
 
     // We will redo the potentially effectful lookup in Baseline.
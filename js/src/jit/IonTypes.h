@@ -183,6 +183,10 @@ enum BailoutKind {
   Bailout_IonExceptionDebugMode
 };
 
+// Number of BailoutKind values. Keep in sync with the last entry above.
+static const size_t BailoutKindCount =
+    size_t(Bailout_IonExceptionDebugMode) + 1;
+
 inline const char* BailoutKindString(BailoutKind kind) {
   switch (kind) {
     // Normal bailouts.
@@ -150,6 +150,11 @@ DefaultJitOptions::DefaultJitOptions() {
   // Toggles whether functions may be entered at loop headers.
   SET_DEFAULT(osr, true);
 
+  // Whether to ask the kernel to back the executable memory region with
+  // transparent huge pages, to reduce iTLB misses for large amounts of JIT
+  // code. Only used on Linux, when the region is reserved at startup.
+  SET_DEFAULT(hugePagesForCode, false);
+
   // Whether to enable extra code to perform dynamic validations.
   SET_DEFAULT(runExtraChecks, false);
 
@@ -181,6 +186,17 @@ DefaultJitOptions::DefaultJitOptions() {
   // Duplicated in all.js - ensure both match.
   SET_DEFAULT(frequentBailoutThreshold, 10);
 
+  // Number of times a script's IonScript may be invalidated by bailouts or
+  // type changes before we stop wasting compilations on it and forbid Ion
+  // compilation. 0 disables this.
+  SET_DEFAULT(ionInvalidationThreshold, 0);
+
+  // Number of type-inference invalidations after which a script has to warm
+  // up again before it is recompiled. Below this, the script keeps its
+  // warm-up count and is recompiled off-thread as soon as Baseline code next
+  // checks it. 0 disables eager recompilation.
+  SET_DEFAULT(ionEagerRecompileThreshold, 0);
+
   // Whether to run all debug checks in debug builds.
   // Disabling might make it more enjoyable to run JS in debug builds.
   SET_DEFAULT(fullDebugChecks, true);
@@ -218,6 +234,11 @@ DefaultJitOptions::DefaultJitOptions() {
   SET_DEFAULT(ionMaxLocalsAndArgs, 10 * 1000);
   SET_DEFAULT(ionMaxLocalsAndArgsMainThread, 256);
 
+  // Time in milliseconds an off-thread Ion compilation may spend in the
+  // backend before it is cancelled. The script has to warm up again before it
+  // is recompiled. 0 means no limit.
+  SET_DEFAULT(ionCompileTimeBudgetMs, 0);
+
   // Force the used register allocator instead of letting the optimization
   // pass decide.
   const char* forcedRegisterAllocatorEnv = "JIT_OPTION_forcedRegisterAllocator";
@@ -67,6 +67,7 @@ struct DefaultJitOptions {
   bool fullDebugChecks;
   bool limitScriptSize;
   bool osr;
+  bool hugePagesForCode;
   bool wasmFoldOffsets;
   bool wasmDelayTier2;
 #ifdef JS_TRACE_LOGGING
@@ -85,6 +86,8 @@ struct DefaultJitOptions {
   uint32_t fullIonWarmUpThreshold;
   uint32_t exceptionBailoutThreshold;
   uint32_t frequentBailoutThreshold;
+  uint32_t ionInvalidationThreshold;
+  uint32_t ionEagerRecompileThreshold;
   uint32_t maxStackArgs;
   uint32_t osrPcMismatchesBeforeRecompile;
   uint32_t smallFunctionMaxBytecodeLength_;
@@ -98,6 +101,7 @@ struct DefaultJitOptions {
   uint32_t ionMaxScriptSizeMainThread;
   uint32_t ionMaxLocalsAndArgs;
   uint32_t ionMaxLocalsAndArgsMainThread;
+  uint32_t ionCompileTimeBudgetMs;
   uint32_t wasmBatchBaselineThreshold;
   uint32_t wasmBatchIonThreshold;
   uint32_t wasmBatchCraneliftThreshold;
@@ -242,6 +242,12 @@ class JitRuntime {
   // Counter used to help dismbiguate stubs in CacheIR
   MainThreadData<uint64_t> disambiguationId_;
 
+  // Number of bailouts of each kind and of Ion invalidations in this runtime,
+  // kept in all builds so deoptimization storms can be diagnosed without
+  // JitSpew.
+  MainThreadData<mozilla::Array<uint64_t, BailoutKindCount>> bailoutCounts_;
+  MainThreadData<uint64_t> ionInvalidationCount_;
+
  private:
   bool generateTrampolines(JSContext* cx);
   bool generateBaselineICFallbackCode(JSContext* cx);
@@ -310,6 +316,17 @@ class JitRuntime {
     return IonCompilationId(nextCompilationId_++);
   }
 
+  void noteBailout(BailoutKind kind) {
+    MOZ_ASSERT(size_t(kind) < BailoutKindCount);
+    bailoutCounts_.ref()[kind]++;
+  }
+  uint64_t bailoutCount(BailoutKind kind) const {
+    MOZ_ASSERT(size_t(kind) < BailoutKindCount);
+    return bailoutCounts_.ref()[kind];
+  }
+  void noteIonInvalidation() { ionInvalidationCount_++; }
+  uint64_t ionInvalidationCount() const { return ionInvalidationCount_; }
+
   uint8_t* allocateIonOsrTempData(size_t size);
   void freeIonOsrTempData();
 
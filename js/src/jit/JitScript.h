@@ -196,6 +196,11 @@ class alignas(uintptr_t) JitScript final {
   // The size of this allocation.
   uint32_t allocBytes_ = 0;
 
+  // Number of times this script's IonScript has been invalidated by bailouts
+  // or type changes since its code last survived until a GC. Used to stop
+  // recompiling scripts that keep invalidating.
+  uint32_t ionInvalidationCount_ = 0;
+
   struct Flags {
     // Flag set when discarding JIT code to indicate this script is on the stack
     // and type information and JIT code should not be discarded.
@@ -412,6 +417,10 @@ class alignas(uintptr_t) JitScript final {
   }
 
   uint32_t warmUpCount() const { return warmUpCount_; }
+
+  uint32_t ionInvalidationCount() const { return ionInvalidationCount_; }
+  void incIonInvalidationCount() { ionInvalidationCount_++; }
+  void resetIonInvalidationCount() { ionInvalidationCount_ = 0; }
   uint32_t* addressOfWarmUpCount() {
     return reinterpret_cast<uint32_t*>(&warmUpCount_);
   }
@@ -66,6 +66,8 @@ namespace jit {
   _(CFG)                                   \
   /* Spew Tracelogger summary stats */     \
   _(ScriptStats)                           \
+  /* Rust frontend compiled bytecode */    \
+  _(Smoosh)                                \
                                            \
   /* BASELINE COMPILER SPEW */             \
                                            \
@@ -11,6 +11,7 @@
 // containing MIR.
 
 #include "mozilla/Atomics.h"
+#include "mozilla/TimeStamp.h"
 
 #include <stdarg.h>
 
@@ -102,10 +103,29 @@ class MIRGenerator {
   bool safeForMinorGC() const { return safeForMinorGC_; }
   void setNotSafeForMinorGC() { safeForMinorGC_ = false; }
 
-  // Whether the main thread is trying to cancel this build.
-  bool shouldCancel(const char* why) { return cancelBuild_; }
+  // Whether the main thread is trying to cancel this build, or the build has
+  // run past its compile-time budget.
+  bool shouldCancel(const char* why) {
+    if (cancelBuild_) {
+      return true;
+    }
+    if (!compileDeadline_.IsNull() &&
+        mozilla::TimeStamp::Now() >= compileDeadline_) {
+      exceedCompileTimeBudget(why);
+      return true;
+    }
+    return false;
+  }
   void cancel() { cancelBuild_ = true; }
 
+  void setCompileTimeBudget(mozilla::TimeDuration budget) {
+    compileStart_ = mozilla::TimeStamp::Now();
+    compileDeadline_ = compileStart_ + budget;
+  }
+  bool exceededCompileTimeBudget() const {
+    return exceededCompileTimeBudget_;
+  }
+
   bool compilingWasm() const { return info_->compilingWasm(); }
 
   uint32_t wasmMaxStackArgBytes() const {
@@ -148,6 +168,10 @@ class MIRGenerator {
                   mozilla::recordreplay::Behavior::DontPreserve>
       cancelBuild_;
 
+  mozilla::TimeStamp compileStart_;
+  mozilla::TimeStamp compileDeadline_;
+  bool exceededCompileTimeBudget_;
+
   uint32_t wasmMaxStackArgBytes_;
   bool needsOverrecursedCheck_;
   bool needsStaticStackAlignment_;
@@ -158,6 +182,7 @@ class MIRGenerator {
   bool stringsCanBeInNursery_;
 
   void addAbortedPreliminaryGroup(ObjectGroup* group);
+  void exceedCompileTimeBudget(const char* why);
 
   uint32_t minWasmHeapLength_;
 
@@ -30,6 +30,7 @@ MIRGenerator::MIRGenerator(CompileRealm* realm,
       offThreadStatus_(Ok()),
       abortedPreliminaryGroups_(*alloc_),
       cancelBuild_(false),
+      exceededCompileTimeBudget_(false),
       wasmMaxStackArgBytes_(0),
       needsOverrecursedCheck_(false),
       needsStaticStackAlignment_(false),
@@ -42,6 +43,17 @@ MIRGenerator::MIRGenerator(CompileRealm* realm,
       options(options),
       gs_(alloc) {}
 
+void MIRGenerator::exceedCompileTimeBudget(const char* why) {
+  MOZ_ASSERT(!compileDeadline_.IsNull());
+
+  JitSpew(JitSpew_IonAbort,
+          "Compile-time budget exceeded during %s, wasted %.2f ms", why,
+          (mozilla::TimeStamp::Now() - compileStart_).ToMilliseconds());
+
+  exceededCompileTimeBudget_ = true;
+  cancelBuild_ = true;
+}
+
 mozilla::GenericErrorResult<AbortReason> MIRGenerator::abort(AbortReason r) {
   if (JitSpewEnabled(JitSpew_IonAbort)) {
     switch (r) {
@@ -54,6 +66,9 @@ mozilla::GenericErrorResult<AbortReason> MIRGenerator::abort(AbortReason r) {
       case AbortReason::PreliminaryObjects:
         JitSpew(JitSpew_IonAbort, "AbortReason::PreliminaryObjects");
         break;
+      case AbortReason::CompileTimeBudget:
+        JitSpew(JitSpew_IonAbort, "AbortReason::CompileTimeBudget");
+        break;
       case AbortReason::Disable:
         JitSpew(JitSpew_IonAbort, "AbortReason::Disable");
         break;
@@ -24,6 +24,7 @@
 #endif
 #include "jit/AtomicOperations.h"
 #include "jit/FlushICache.h"  // js::jit::FlushICache
+#include "jit/JitOptions.h"
 #include "threading/LockGuard.h"
 #include "threading/Mutex.h"
 #include "util/Memory.h"
@@ -368,6 +369,12 @@ static void* ReserveProcessExecutableMemory(size_t bytes) {
   if (p == MAP_FAILED) {
     return nullptr;
   }
+#  if defined(XP_LINUX) && defined(MADV_HUGEPAGE)
+  // This is only a hint, so ignore failures (e.g. THP disabled).
+  if (JitOptions.hugePagesForCode) {
+    (void)madvise(p, bytes, MADV_HUGEPAGE);
+  }
+#  endif
   return p;
 }
 
@@ -727,6 +734,26 @@ bool js::jit::CanLikelyAllocateMoreExecutableMemory() {
   return execMemory.bytesAllocated() + BufferSize <= MaxCodeBytesPerProcess;
 }
 
+static mozilla::Atomic<uint64_t, mozilla::Relaxed,
+                       mozilla::recordreplay::Behavior::DontPreserve>
+    reprotectCount;
+static mozilla::Atomic<uint64_t, mozilla::Relaxed,
+                       mozilla::recordreplay::Behavior::DontPreserve>
+    reprotectBytes;
+static mozilla::Atomic<uint64_t, mozilla::Relaxed,
+                       mozilla::recordreplay::Behavior::DontPreserve>
+    reprotectNanoseconds;
+
+ReprotectStats js::jit::GetReprotectStats() {
+  ReprotectStats stats;
+  stats.count = reprotectCount;
+  stats.bytes = reprotectBytes;
+  stats.time =
+      mozilla::TimeDuration::FromMicroseconds(double(reprotectNanoseconds) /
+                                              1000.0);
+  return stats;
+}
+
 bool js::jit::ReprotectRegion(void* start, size_t size,
                               ProtectionSetting protection,
                               MustFlushICache flushICache) {
@@ -765,6 +792,8 @@ bool js::jit::ReprotectRegion(void* start, size_t size,
   // jitted atomics.  But the C++ fence is sufficient and correct, too.
   std::atomic_thread_fence(std::memory_order_seq_cst);
 
+  mozilla::TimeStamp startTime = mozilla::TimeStamp::Now();
+
 #ifdef XP_WIN
   DWORD oldProtect;
   DWORD flags = ProtectionSettingToFlags(protection);
@@ -778,6 +807,11 @@ bool js::jit::ReprotectRegion(void* start, size_t size,
   }
 #endif
 
+  mozilla::TimeDuration elapsed = mozilla::TimeStamp::Now() - startTime;
+  reprotectCount++;
+  reprotectBytes += size;
+  reprotectNanoseconds += uint64_t(elapsed.ToMicroseconds() * 1000.0);
+
   execMemory.assertValidAddress(pageStart, size);
   return true;
 }
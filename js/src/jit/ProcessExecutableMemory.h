@@ -8,6 +8,7 @@
 #define jit_ProcessExecutableMemory_h
 
 #include "mozilla/Attributes.h"
+#include "mozilla/TimeStamp.h"
 
 #include "util/Poison.h"
 
@@ -76,6 +77,17 @@ extern MOZ_MUST_USE bool ReprotectRegion(void* start, size_t size,
                                          ProtectionSetting protection,
                                          MustFlushICache flushICache);
 
+// Process-wide counters for the protection changes done by ReprotectRegion,
+// to measure how much time is spent toggling JIT code between writable and
+// executable.
+struct ReprotectStats {
+  uint64_t count = 0;
+  uint64_t bytes = 0;
+  mozilla::TimeDuration time;
+};
+
+extern ReprotectStats GetReprotectStats();
+
 // Functions called at process start-up/shutdown to initialize/release the
 // executable memory region.
 extern MOZ_MUST_USE bool InitProcessExecutableMemory();
@@ -27,6 +27,7 @@
 #include "jit/JitFrames-inl.h"
 #include "jit/VMFunctionList-inl.h"
 #include "vm/Interpreter-inl.h"
+#include "vm/JSContext-inl.h"
 #include "vm/JSScript-inl.h"
 #include "vm/NativeObject-inl.h"
 #include "vm/StringObject-inl.h"
@@ -1578,12 +1579,27 @@ static MOZ_ALWAYS_INLINE bool GetNativeDataPropertyPure(JSContext* cx,
 
   MOZ_ASSERT(JSID_IS_ATOM(id) || JSID_IS_SYMBOL(id));
 
+  // Own data properties of objects with non-dictionary shapes are cached,
+  // avoiding the shape search when the same shape is seen again.
+  MegamorphicCache& cache = cx->caches().megamorphicCache;
+  NativeObject* receiver = obj;
+  Shape* receiverShape = receiver->lastProperty();
+  uint32_t slot;
+  if (cache.lookup(receiverShape, id, &slot)) {
+    *vp = obj->getSlot(slot);
+    return true;
+  }
+
   while (true) {
     if (Shape* shape = obj->lastProperty()->search(cx, id)) {
       if (!shape->isDataProperty()) {
         return false;
       }
 
+      if (obj == receiver && !receiverShape->inDictionary()) {
+        cache.fill(receiverShape, id, shape->slot());
+      }
+
       *vp = obj->getSlot(shape->slot());
       return true;
     }
@@ -1777,9 +1793,28 @@ bool HasNativeDataPropertyPure(JSContext* cx, JSObject* obj, Value* vp) {
     return false;
   }
 
+  // Share the megamorphic property cache with GetNativeDataPropertyPure: a
+  // cached entry means the receiver has an own data property with this id.
+  MegamorphicCache& cache = cx->caches().megamorphicCache;
+  JSObject* receiver = obj;
+  Shape* receiverShape = nullptr;
+  if (receiver->isNative()) {
+    receiverShape = receiver->as<NativeObject>().lastProperty();
+    uint32_t slot;
+    if (cache.lookup(receiverShape, id, &slot)) {
+      vp[1].setBoolean(true);
+      return true;
+    }
+  }
+
   do {
     if (obj->isNative()) {
-      if (obj->as<NativeObject>().lastProperty()->search(cx, id)) {
+      Shape* shape = obj->as<NativeObject>().lastProperty()->search(cx, id);
+      if (shape) {
+        if (obj == receiver && shape->isDataProperty() &&
+            !receiverShape->inDictionary()) {
+          cache.fill(receiverShape, id, shape->slot());
+        }
         vp[1].setBoolean(true);
         return true;
       }
@@ -0,0 +1,36 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "js/AllocationRecording.h"  // JS::{Enable,Disable}RecordingAllocations*
+#include "jsapi-tests/tests.h"
+
+static size_t gRecordedAllocations = 0;
+
+static void RecordAllocation(JS::RecordAllocationInfo&& info) {
+  gRecordedAllocations++;
+}
+
+BEGIN_TEST(testRecordingAllocationsByBytes) {
+  // Each array has a GC cell of a few dozen bytes and about 8KB of elements,
+  // so 2000 of them allocate about 16MB. Sampling one byte in 64KB should
+  // record around 250 of them, and only a handful if the elements weren't
+  // counted.
+  gRecordedAllocations = 0;
+  JS::EnableRecordingAllocationsByBytes(cx, RecordAllocation, 64 * 1024);
+  EXEC(
+      "var arrays = [];"
+      "for (var i = 0; i < 2000; i++) {"
+      "  arrays.push(new Array(1000));"
+      "}");
+  JS::DisableRecordingAllocations(cx);
+
+  CHECK(gRecordedAllocations > 125);
+  CHECK(gRecordedAllocations < 500);
+
+  EXEC("arrays = null;");
+  JS_GC(cx);
+
+  return true;
+}
+END_TEST(testRecordingAllocationsByBytes)
@@ -0,0 +1,54 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Utf8.h"  // mozilla::Utf8Unit
+
+#include "js/CompilationAndEvaluation.h"  // JS::CheckScriptSyntax
+#include "js/SourceText.h"                // JS::Source{Ownership,Text}
+#include "jsapi-tests/tests.h"
+
+BEGIN_TEST(testCheckScriptSyntax) {
+  CHECK(checkUtf8("var x = 1; function f() { return x; }", true));
+  CHECK(checkUtf16(u"var x = 1; function f() { return x; }", true));
+
+  // Plain syntax errors.
+  CHECK(checkUtf8("var x = ;", false));
+  CHECK(checkUtf16(u"var x = ;", false));
+
+  // Early errors are reported too.
+  CHECK(checkUtf8("let x; let x;", false));
+  CHECK(checkUtf16(u"let x; let x;", false));
+
+  return true;
+}
+
+template <size_t N>
+bool checkUtf8(const char (&chars)[N], bool valid) {
+  JS::CompileOptions options(cx);
+  options.setFileAndLine(__FILE__, __LINE__);
+
+  JS::SourceText<mozilla::Utf8Unit> srcBuf;
+  CHECK(srcBuf.init(cx, chars, N - 1, JS::SourceOwnership::Borrowed));
+
+  return checkResult(JS::CheckScriptSyntax(cx, options, srcBuf), valid);
+}
+
+template <size_t N>
+bool checkUtf16(const char16_t (&chars)[N], bool valid) {
+  JS::CompileOptions options(cx);
+  options.setFileAndLine(__FILE__, __LINE__);
+
+  JS::SourceText<char16_t> srcBuf;
+  CHECK(srcBuf.init(cx, chars, N - 1, JS::SourceOwnership::Borrowed));
+
+  return checkResult(JS::CheckScriptSyntax(cx, options, srcBuf), valid);
+}
+
+bool checkResult(bool ok, bool valid) {
+  CHECK_EQUAL(ok, valid);
+  CHECK_EQUAL(JS_IsExceptionPending(cx), !valid);
+  JS_ClearPendingException(cx);
+  return true;
+}
+END_TEST(testCheckScriptSyntax)
@@ -0,0 +1,122 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Utf8.h"  // mozilla::Utf8Unit
+
+#include <string.h>  // strlen, strstr
+
+#include "jsfriendapi.h"  // js::{GetDelazifiedFunctionOffsets,SetRecordDelazifications}
+
+#include "js/CompilationAndEvaluation.h"    // JS::CompileDontInflate
+#include "js/OffThreadScriptCompilation.h"  // JS::{Compile,Finish}OffThread*
+#include "js/SourceText.h"                  // JS::Source{Ownership,Text}
+#include "js/Vector.h"                      // js::Vector
+#include "jsapi-tests/tests.h"
+#include "vm/JSFunction.h"  // JSFunction
+#include "vm/Monitor.h"
+#include "vm/MutexIDs.h"
+
+using OffsetVector = js::Vector<uint32_t, 0, js::SystemAllocPolicy>;
+
+static const char chars[] =
+    "function f() { return 1; }\n"
+    "function g() { return 2; }\n";
+
+BEGIN_TEST(testDelazifiedFunctions) {
+  uint32_t fStart = strstr(chars, "function f") - chars;
+
+  js::SetRecordDelazifications(cx, true);
+
+  JS::CompileOptions options(cx);
+  options.setFileAndLine(__FILE__, __LINE__);
+  JS::RootedScript script(cx, compile(options));
+  CHECK(script);
+  JS::RootedValue rval(cx);
+  CHECK(JS_ExecuteScript(cx, script, &rval));
+  CHECK(isLazy("f"));
+  CHECK(isLazy("g"));
+
+  // Each function is listed once, however often it is delazified.
+  EXEC("f(); f();");
+  CHECK(checkOffsets(script, fStart));
+
+  JS::PrepareForFullGC(cx);
+  JS::NonIncrementalGC(cx, GC_SHRINK, JS::GCReason::API);
+  EXEC("f();");
+  CHECK(checkOffsets(script, fStart));
+
+  // Compiling with the offsets compiles f upfront. They are copied for
+  // off-thread compilation, so they may change before the task runs.
+  OffsetVector offsets;
+  CHECK(js::GetDelazifiedFunctionOffsets(cx, script, &offsets));
+
+  JS::CompileOptions eagerOptions(cx);
+  eagerOptions.setFileAndLine(__FILE__, __LINE__)
+      .setEagerFunctionOffsets(offsets.begin(), offsets.length());
+
+  JS::SourceText<mozilla::Utf8Unit> srcBuf;
+  CHECK(srcBuf.init(cx, chars, strlen(chars), JS::SourceOwnership::Borrowed));
+  CHECK(JS::CompileOffThread(cx, eagerOptions, srcBuf, OffThreadCallback,
+                             this));
+  offsets[0] = UINT32_MAX;
+  offsets.clearAndFree();
+
+  JS::RootedScript eagerScript(cx,
+                               JS::FinishOffThreadScript(cx, waitUntilDone()));
+  CHECK(eagerScript);
+  CHECK(JS_ExecuteScript(cx, eagerScript, &rval));
+  CHECK(!isLazy("f"));
+  CHECK(isLazy("g"));
+
+  // Stopping recording discards the records.
+  js::SetRecordDelazifications(cx, false);
+  CHECK(js::GetDelazifiedFunctionOffsets(cx, script, &offsets));
+  CHECK(offsets.empty());
+
+  return true;
+}
+
+js::Monitor monitor{js::mutexid::ShellOffThreadState};
+JS::OffThreadToken* token = nullptr;
+
+static void OffThreadCallback(JS::OffThreadToken* token, void* context) {
+  auto self = static_cast<cls_testDelazifiedFunctions*>(context);
+  js::AutoLockMonitor lock(self->monitor);
+  self->token = token;
+  lock.notify();
+}
+
+JS::OffThreadToken* waitUntilDone() {
+  js::AutoLockMonitor lock(monitor);
+  while (!token) {
+    lock.wait();
+  }
+  JS::OffThreadToken* result = token;
+  token = nullptr;
+  return result;
+}
+
+JSScript* compile(const JS::ReadOnlyCompileOptions& options) {
+  JS::SourceText<mozilla::Utf8Unit> srcBuf;
+  if (!srcBuf.init(cx, chars, strlen(chars), JS::SourceOwnership::Borrowed)) {
+    return nullptr;
+  }
+  return JS::CompileDontInflate(cx, options, srcBuf);
+}
+
+bool isLazy(const char* name) {
+  JS::RootedValue v(cx);
+  MOZ_RELEASE_ASSERT(JS_GetProperty(cx, global, name, &v));
+  MOZ_RELEASE_ASSERT(v.isObject() && v.toObject().is<JSFunction>());
+  return v.toObject().as<JSFunction>().isInterpretedLazy();
+}
+
+bool checkOffsets(JS::HandleScript script, uint32_t expected) {
+  OffsetVector offsets;
+  CHECK(js::GetDelazifiedFunctionOffsets(cx, script, &offsets));
+  CHECK_EQUAL(offsets.length(), size_t(1));
+  CHECK_EQUAL(offsets[0], expected);
+  return true;
+}
+END_TEST(testDelazifiedFunctions)
@@ -0,0 +1,195 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Utf8.h"  // mozilla::Utf8Unit
+
+#include <string.h>  // strlen
+
+#include "js/CompilationAndEvaluation.h"  // JS::CompileDontInflate
+#include "js/SourceText.h"                // JS::Source{Ownership,Text}
+#include "jsapi-tests/tests.h"
+#include "vm/BytecodeUtil.h"  // js::GetNextPc
+#include "vm/JSScript.h"      // JSScript
+
+// Check that FoldConstants folds comparisons of literals, templates with only
+// literal substitutions and |void <literal>|, and that the folded values are
+// the ones computed at run time.  Cases which can't be folded must still be
+// emitted as the operation.
+
+struct FoldConstantsFixture : public JSAPITest {
+  // Compile and run |source|, and check whether any of the operations that
+  // the folds replace is left in the bytecode.
+  bool compileAndCheck(const char* source, bool folded,
+                       JS::MutableHandleValue rval) {
+    JS::CompileOptions options(cx);
+    options.setFileAndLine(__FILE__, __LINE__);
+
+    JS::SourceText<mozilla::Utf8Unit> srcBuf;
+    CHECK(srcBuf.init(cx, source, strlen(source),
+                      JS::SourceOwnership::Borrowed));
+
+    JS::RootedScript script(cx, JS::CompileDontInflate(cx, options, srcBuf));
+    CHECK(script);
+
+    bool hasFoldableOp = false;
+    for (jsbytecode* pc = script->code(); pc < script->codeEnd();
+         pc = js::GetNextPc(pc)) {
+      switch (JSOp(*pc)) {
+        case JSOp::StrictEq:
+        case JSOp::StrictNe:
+        case JSOp::Eq:
+        case JSOp::Ne:
+        case JSOp::Lt:
+        case JSOp::Le:
+        case JSOp::Gt:
+        case JSOp::Ge:
+        case JSOp::ToString:
+        case JSOp::Add:
+        case JSOp::Void:
+          hasFoldableOp = true;
+          break;
+        default:
+          break;
+      }
+    }
+    CHECK_EQUAL(hasFoldableOp, !folded);
+
+    CHECK(JS_ExecuteScript(cx, script, rval));
+    return true;
+  }
+
+  bool checkBool(const char* source, bool expected, bool folded) {
+    JS::RootedValue rval(cx);
+    CHECK(compileAndCheck(source, folded, &rval));
+    CHECK(rval.isBoolean());
+    CHECK_EQUAL(rval.toBoolean(), expected);
+    return true;
+  }
+
+  bool checkString(const char* source, const char* expected, bool folded) {
+    JS::RootedValue rval(cx);
+    CHECK(compileAndCheck(source, folded, &rval));
+    CHECK(rval.isString());
+    bool match;
+    CHECK(JS_StringEqualsAscii(cx, rval.toString(), expected, &match));
+    CHECK(match);
+    return true;
+  }
+
+  bool checkUndefined(const char* source, bool folded) {
+    JS::RootedValue rval(cx);
+    CHECK(compileAndCheck(source, folded, &rval));
+    CHECK(rval.isUndefined());
+    return true;
+  }
+};
+
+BEGIN_FIXTURE_TEST(FoldConstantsFixture, testFoldConstants_Comparisons) {
+  CHECK(checkBool("1 === 1", true, true));
+  CHECK(checkBool("1 !== 1", false, true));
+  CHECK(checkBool("1 == '1'", true, true));
+  CHECK(checkBool("'1' != 1", false, true));
+  CHECK(checkBool("'abc' === 'abc'", true, true));
+  CHECK(checkBool("'abc' === 'abd'", false, true));
+  CHECK(checkBool("true == 1", true, true));
+  CHECK(checkBool("false === 0", false, true));
+  CHECK(checkBool("null == void 0", true, true));
+  CHECK(checkBool("null === void 0", false, true));
+  CHECK(checkBool("null == 0", false, true));
+  CHECK(checkBool("void 0 == 0", false, true));
+
+  // Relational comparisons of strings compare code units, and of anything
+  // else compare numbers.
+  CHECK(checkBool("'10' < '9'", true, true));
+  CHECK(checkBool("'10' < 9", false, true));
+  CHECK(checkBool("'b' >= 'a'", true, true));
+  CHECK(checkBool("null >= 0", true, true));
+  CHECK(checkBool("true > false", true, true));
+
+  // Chains are folded pairwise from the left.
+  CHECK(checkBool("1 < 2 < 3", true, true));
+  CHECK(checkBool("3 > 2 > 1", false, true));
+
+  return true;
+}
+END_FIXTURE_TEST(FoldConstantsFixture, testFoldConstants_Comparisons)
+
+BEGIN_FIXTURE_TEST(FoldConstantsFixture, testFoldConstants_ComparisonEdges) {
+  // NaN isn't equal to anything, and every relational comparison with it is
+  // false.
+  CHECK(checkBool("0 / 0 === 0 / 0", false, true));
+  CHECK(checkBool("0 / 0 != 0 / 0", true, true));
+  CHECK(checkBool("0 / 0 < 1", false, true));
+  CHECK(checkBool("0 / 0 >= 1", false, true));
+  CHECK(checkBool("void 0 < 1", false, true));
+  CHECK(checkBool("void 0 >= 0", false, true));
+  CHECK(checkBool("'abc' == 0 / 0", false, true));
+  CHECK(checkBool("'abc' <= 0", false, true));
+
+  // -0 is equal to 0.
+  CHECK(checkBool("0 === -0", true, true));
+  CHECK(checkBool("-0 < 0", false, true));
+  CHECK(checkBool("-0 <= 0", true, true));
+  CHECK(checkBool("'-0' == 0", true, true));
+
+  // Numeric-looking strings are only converted when compared with a
+  // non-string.
+  CHECK(checkBool("'0x10' == 16", true, true));
+  CHECK(checkBool("' 1 ' == 1", true, true));
+  CHECK(checkBool("'' == 0", true, true));
+  CHECK(checkBool("'1e3' == 1000", true, true));
+  CHECK(checkBool("'Infinity' == 1 / 0", true, true));
+  CHECK(checkBool("'1' === 1", false, true));
+  CHECK(checkBool("'01' == '1'", false, true));
+  CHECK(checkBool("'2' > '10'", true, true));
+  CHECK(checkBool("'2' > 10", false, true));
+
+  // Operands which aren't number, string, boolean, null or undefined
+  // literals are left alone.
+  CHECK(checkBool("1n == 1", true, false));
+  CHECK(checkBool("1n < 2", true, false));
+  CHECK(checkBool("1 < [].length", false, false));
+  CHECK(checkBool("({}) == '[object Object]'", true, false));
+
+  // Only the leading literal operands of a chain are folded.
+  CHECK(checkBool("1 < 2 < [].length", false, false));
+
+  return true;
+}
+END_FIXTURE_TEST(FoldConstantsFixture, testFoldConstants_ComparisonEdges)
+
+BEGIN_FIXTURE_TEST(FoldConstantsFixture, testFoldConstants_Templates) {
+  CHECK(checkString("`abc`", "abc", true));
+  CHECK(checkString("`a${1}b${true}c${null}d${void 0}`",
+                    "a1btruecnulldundefined", true));
+  CHECK(checkString("`${'x'}${`y${2}`}`", "xy2", true));
+
+  // Numbers are converted with ToString.
+  CHECK(checkString("`${-0}`", "0", true));
+  CHECK(checkString("`${0 / 0}`", "NaN", true));
+  CHECK(checkString("`${1e21}`", "1e+21", true));
+  CHECK(checkString("`${0.1}`", "0.1", true));
+  CHECK(checkString("`${'1' + 1}`", "11", true));
+
+  // Any other substitution leaves the template alone.
+  CHECK(checkString("`${1n}`", "1", false));
+  CHECK(checkString("`a${[].length}b${1}`", "a0b1", false));
+
+  return true;
+}
+END_FIXTURE_TEST(FoldConstantsFixture, testFoldConstants_Templates)
+
+BEGIN_FIXTURE_TEST(FoldConstantsFixture, testFoldConstants_Void) {
+  CHECK(checkUndefined("void 1", true));
+  CHECK(checkUndefined("void 'a'", true));
+  CHECK(checkUndefined("void null", true));
+  CHECK(checkUndefined("void 1n", true));
+  CHECK(checkUndefined("void void 0", true));
+
+  CHECK(checkUndefined("void [].length", false));
+  CHECK(checkUndefined("void function() {}", false));
+
+  return true;
+}
+END_FIXTURE_TEST(FoldConstantsFixture, testFoldConstants_Void)
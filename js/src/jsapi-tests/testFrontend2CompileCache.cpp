@@ -0,0 +1,85 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/ArrayUtils.h"  // mozilla::ArrayLength
+#include "mozilla/Utf8.h"        // mozilla::Utf8Unit
+
+#include "frontend/Frontend2.h"           // js::frontend::Jsparagus
+#include "js/CompilationAndEvaluation.h"  // JS::CompileDontInflate
+#include "js/CompileOptions.h"            // JS::CompileOptions
+#include "js/MemoryMetrics.h"             // JS::{CollectGlobalStats, GlobalStats}
+#include "js/SourceText.h"                // JS::Source{Ownership,Text}
+#include "jsapi-tests/tests.h"
+
+using js::frontend::Jsparagus;
+
+// Count allocations rather than measuring them, which needs a real malloc
+// size function.
+static size_t CountingMallocSizeOf(const void*) { return 1; }
+
+BEGIN_TEST(testFrontend2CompileCache) {
+  Jsparagus::clearCompileCache();
+  CHECK_EQUAL(Jsparagus::compileCacheCount(), size_t(0));
+
+  JS::CompileOptions options(cx);
+  options.setFileAndLine("cache.js", 1).setNoScriptRval(true);
+  options.tryRustFrontend = true;
+
+  CHECK(compile(options));
+  CHECK_EQUAL(Jsparagus::compileCacheCount(), size_t(1));
+
+  // The same source and options hit the cache.
+  CHECK(compile(options));
+  CHECK_EQUAL(Jsparagus::compileCacheCount(), size_t(1));
+
+  // The options passed to the Rust frontend are part of the key.
+  JS::CompileOptions rval(cx, options);
+  rval.setNoScriptRval(false);
+  CHECK(compile(rval));
+  CHECK_EQUAL(Jsparagus::compileCacheCount(), size_t(2));
+
+  // Options which are only used to instantiate the result are not.
+  JS::CompileOptions line(cx, options);
+  line.setLine(10);
+  CHECK(compile(line));
+  CHECK_EQUAL(Jsparagus::compileCacheCount(), size_t(2));
+
+  JS::CompileOptions file(cx, options);
+  file.setFile("other.js");
+  CHECK(compile(file));
+  CHECK_EQUAL(Jsparagus::compileCacheCount(), size_t(2));
+
+  // The cache survives ordinary GCs.
+  JS_GC(cx);
+  CHECK_EQUAL(Jsparagus::compileCacheCount(), size_t(2));
+
+  // It's purged by shrinking GCs, and its entries are reported in the global
+  // memory stats.
+  size_t sizeBefore = cacheSize();
+  JS::PrepareForFullGC(cx);
+  JS::NonIncrementalGC(cx, GC_SHRINK, JS::GCReason::API);
+  CHECK_EQUAL(Jsparagus::compileCacheCount(), size_t(0));
+  CHECK(cacheSize() < sizeBefore);
+
+  return true;
+}
+
+size_t cacheSize() {
+  JS::GlobalStats gStats(CountingMallocSizeOf);
+  MOZ_RELEASE_ASSERT(JS::CollectGlobalStats(&gStats));
+  return gStats.smooshCompileCache;
+}
+
+bool compile(const JS::ReadOnlyCompileOptions& options) {
+  static const char chars[] = "1 + 2;";
+
+  JS::SourceText<mozilla::Utf8Unit> srcBuf;
+  CHECK(srcBuf.init(cx, chars, mozilla::ArrayLength(chars) - 1,
+                    JS::SourceOwnership::Borrowed));
+
+  JS::RootedScript script(cx, JS::CompileDontInflate(cx, options, srcBuf));
+  CHECK(script);
+  return true;
+}
+END_TEST(testFrontend2CompileCache)
@@ -0,0 +1,57 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>  // memcpy
+
+#include "frontend/Frontend2.h"  // js::frontend::{Jsparagus, SmooshFallbackReason}
+#include "js/UniquePtr.h"        // js::UniquePtr
+#include "js/Utility.h"          // js_pod_malloc
+#include "jsapi-tests/tests.h"
+
+using js::frontend::Jsparagus;
+using js::frontend::SmooshFallbackReason;
+
+BEGIN_TEST(testFrontend2Prescan) {
+  SmooshFallbackReason reason;
+
+  // Unterminated string literals and block comments at the end of the source
+  // must not be scanned past the end.
+  CHECK(!prescan("x = \"abc", &reason));
+  CHECK(!prescan(u"x = \"abc", &reason));
+  CHECK(!prescan("x = 'abc\\", &reason));
+  CHECK(!prescan(u"x = 'abc\\", &reason));
+  CHECK(!prescan("x = 1; /*", &reason));
+  CHECK(!prescan(u"x = 1; /*", &reason));
+  CHECK(!prescan("x = 1; /* *", &reason));
+  CHECK(!prescan(u"x = 1; /* *", &reason));
+  CHECK(!prescan("\"", &reason));
+  CHECK(!prescan("/*", &reason));
+
+  // Keywords inside strings and comments don't count, but ones after them do.
+  CHECK(!prescan("x = \"function\"; /* try */", &reason));
+  CHECK(prescan("x = 'a\\'b'; try {} finally {}", &reason));
+  CHECK(reason == SmooshFallbackReason::Try);
+  CHECK(prescan(u"/* ** */ class C {}", &reason));
+  CHECK(reason == SmooshFallbackReason::Class);
+
+  return true;
+}
+
+// Copy the source to a buffer of exactly its length, so that reading past the
+// end is caught by ASan.
+template <typename Unit, size_t N>
+bool prescan(const Unit (&chars)[N], SmooshFallbackReason* reason) {
+  const size_t length = N - 1;
+  js::UniquePtr<Unit[], JS::FreePolicy> units(js_pod_malloc<Unit>(length));
+  MOZ_RELEASE_ASSERT(units);
+  memcpy(units.get(), chars, length * sizeof(Unit));
+
+  if (sizeof(Unit) == 1) {
+    return Jsparagus::prescanForUnsupportedSyntax(
+        reinterpret_cast<const uint8_t*>(units.get()), length, reason);
+  }
+  return Jsparagus::prescanForUnsupportedSyntax(
+      reinterpret_cast<const char16_t*>(units.get()), length, reason);
+}
+END_TEST(testFrontend2Prescan)
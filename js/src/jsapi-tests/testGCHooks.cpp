@@ -5,6 +5,7 @@
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/UniquePtr.h"
 
+#include "gc/Zone.h"
 #include "jsapi-tests/tests.h"
 
 static unsigned gSliceCallbackCount = 0;
@@ -98,3 +99,137 @@ BEGIN_TEST(testGCRootsRemoved) {
   return true;
 }
 END_TEST(testGCRootsRemoved)
+
+BEGIN_TEST(testGCPauseHistogram) {
+  JS::ResetGCPauseHistogram(cx);
+
+  JS::GCPauseHistogram histogram;
+  JS::GetGCPauseHistogram(cx, &histogram);
+  CHECK(histogram.majorSlices.count == 0);
+  CHECK(histogram.minorGCs.count == 0);
+
+  JS::RootedObject obj(cx, JS_NewPlainObject(cx));
+  CHECK(obj);
+
+  JS_GC(cx);
+
+  JS::GetGCPauseHistogram(cx, &histogram);
+  CHECK(histogram.majorSlices.count >= 1);
+  CHECK(histogram.minorGCs.count >= 1);
+  CHECK(histogram.cellsMarked > 0);
+
+  uint64_t total = 0;
+  for (uint64_t count : histogram.majorSlices.buckets) {
+    total += count;
+  }
+  CHECK(total == histogram.majorSlices.count);
+  CHECK(histogram.majorSlices.maxMicroseconds <=
+        histogram.majorSlices.totalMicroseconds);
+
+  JS::ResetGCPauseHistogram(cx);
+  JS::GetGCPauseHistogram(cx, &histogram);
+  CHECK(histogram.majorSlices.count == 0);
+
+  return true;
+}
+END_TEST(testGCPauseHistogram)
+
+BEGIN_TEST(testGCZoneHeapQuota) {
+  JS::Zone* zone = js::GetContextZone(cx);
+  CHECK(JS::GetZoneGCHeapQuota(zone) == 0);
+
+  JS_GC(cx);
+
+  // Without a quota the zone is well below its heap threshold.
+  uint64_t majorGCs = cx->runtime()->gc.majorGCCount();
+  JS_MaybeGC(cx);
+  CHECK(!JS::IsIncrementalGCInProgress(cx));
+  CHECK(cx->runtime()->gc.majorGCCount() == majorGCs);
+
+  // A quota smaller than the zone's heap triggers a GC.
+  JS::SetZoneGCHeapQuota(zone, 1);
+  CHECK(JS::GetZoneGCHeapQuota(zone) == 1);
+  JS_MaybeGC(cx);
+  if (JS::IsIncrementalGCInProgress(cx)) {
+    JS::FinishIncrementalGC(cx, JS::GCReason::API);
+  }
+  CHECK(cx->runtime()->gc.majorGCCount() > majorGCs);
+
+  JS::SetZoneGCHeapQuota(zone, 0);
+  CHECK(JS::GetZoneGCHeapQuota(zone) == 0);
+
+  return true;
+}
+END_TEST(testGCZoneHeapQuota)
+
+BEGIN_TEST(testGCZoneHeapQuotaOverLiveSize) {
+  JS::Zone* zone = js::GetContextZone(cx);
+  JS_GC(cx);
+
+  // The live data is always above this quota.
+  JS::SetZoneGCHeapQuota(zone, 1);
+  CHECK(maybeGC());
+
+  // The quota GC couldn't get the zone under its quota, so the quota doesn't
+  // trigger another until the heap has grown.
+  EXEC("var live = [];");
+  CHECK(!maybeGC());
+  CHECK(!maybeGC());
+
+  // Grow the heap by more than half what the last GC retained.
+  size_t retained = zone->gcHeapSize.retainedBytes();
+  for (size_t i = 0; zone->gcHeapSize.bytes() <= retained * 2; i++) {
+    CHECK(i < 1000);
+    EXEC("for (var i = 0; i < 1000; i++) { live.push({i}); }");
+    cx->minorGC(JS::GCReason::API);
+  }
+  CHECK(maybeGC());
+
+  JS::SetZoneGCHeapQuota(zone, 0);
+  EXEC("live = null;");
+  JS_GC(cx);
+
+  return true;
+}
+
+// Call JS_MaybeGC and return whether it ran a major GC.
+bool maybeGC() {
+  uint64_t majorGCs = cx->runtime()->gc.majorGCCount();
+  JS_MaybeGC(cx);
+  if (JS::IsIncrementalGCInProgress(cx)) {
+    JS::FinishIncrementalGC(cx, JS::GCReason::API);
+  }
+  return cx->runtime()->gc.majorGCCount() > majorGCs;
+}
+END_TEST(testGCZoneHeapQuotaOverLiveSize)
+
+BEGIN_TEST(testGCRunIdleTimeGCWork) {
+  using mozilla::TimeDuration;
+  using mozilla::TimeStamp;
+
+  JS_GC(cx);
+
+  // No time available.
+  CHECK(JS::RunIdleTimeGCWork(cx, TimeStamp::Now()) == JS::IdleGCWork::None);
+
+  // An incremental GC in progress gets a slice.
+  JS::PrepareForFullGC(cx);
+  js::SliceBudget budget(js::WorkBudget(1));
+  cx->runtime()->gc.startDebugGC(GC_NORMAL, budget);
+  CHECK(JS::IsIncrementalGCInProgress(cx));
+
+  // Less than a millisecond isn't enough for a slice.
+  TimeStamp deadline = TimeStamp::Now() + TimeDuration::FromMicroseconds(500);
+  CHECK(JS::RunIdleTimeGCWork(cx, deadline) == JS::IdleGCWork::None);
+  CHECK(JS::IsIncrementalGCInProgress(cx));
+
+  deadline = TimeStamp::Now() + TimeDuration::FromSeconds(10);
+  CHECK(JS::RunIdleTimeGCWork(cx, deadline) == JS::IdleGCWork::MajorSlice);
+
+  if (JS::IsIncrementalGCInProgress(cx)) {
+    JS::FinishIncrementalGC(cx, JS::GCReason::API);
+  }
+
+  return true;
+}
+END_TEST(testGCRunIdleTimeGCWork)
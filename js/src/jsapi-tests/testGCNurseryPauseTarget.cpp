@@ -0,0 +1,64 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/TimeStamp.h"  // mozilla::TimeDuration
+
+#include "gc/Nursery.h"  // js::Nursery
+#include "jsapi-tests/tests.h"
+
+using mozilla::TimeDuration;
+
+static const size_t MB = 1024 * 1024;
+
+BEGIN_TEST(testGCNurseryPauseTarget) {
+  const TimeDuration ms = TimeDuration::FromMilliseconds(1);
+
+  // Tenuring 1MB took 1ms, and 10% of the nursery is tenured: a 10MB nursery
+  // can be collected in 1ms.
+  CHECK(checkCapacity(ms, ms, 1 * MB, 0.1, 10 * MB));
+
+  // Twice the target or half the promotion rate allow twice the size.
+  CHECK(checkCapacity(ms * 2, ms, 1 * MB, 0.1, 20 * MB));
+  CHECK(checkCapacity(ms, ms, 1 * MB, 0.05, 20 * MB));
+
+  // Only the tenured bytes matter, not how much of the nursery was used, so a
+  // slower collection which tenured more gives the same answer.
+  CHECK(checkCapacity(ms, ms * 2, 2 * MB, 0.1, 10 * MB));
+
+  // Nothing can be estimated from a collection which tenured nothing, or
+  // without a promotion rate, so there is no limit.
+  CHECK_EQUAL(js::Nursery::capacityForPauseTarget(ms, ms * 10, 0, 0.1),
+              SIZE_MAX);
+  CHECK_EQUAL(js::Nursery::capacityForPauseTarget(ms, ms, 1 * MB, 0.0),
+              SIZE_MAX);
+  CHECK_EQUAL(
+      js::Nursery::capacityForPauseTarget(ms, TimeDuration(), 1 * MB, 0.1),
+      SIZE_MAX);
+
+  // Minor GCs which tenure nothing leave the nursery to the promotion rate
+  // policy, however short the target.
+  JS_SetGCParameter(cx, JSGC_NURSERY_PAUSE_TARGET_US, 1);
+  CHECK_EQUAL(JS_GetGCParameter(cx, JSGC_NURSERY_PAUSE_TARGET_US), 1u);
+  for (size_t i = 0; i < 10; i++) {
+    EXEC("for (var i = 0; i < 10000; i++) { [i]; }");
+    cx->minorGC(JS::GCReason::API);
+  }
+  JS_ResetGCParameter(cx, JSGC_NURSERY_PAUSE_TARGET_US);
+  CHECK_EQUAL(JS_GetGCParameter(cx, JSGC_NURSERY_PAUSE_TARGET_US), 0u);
+
+  return true;
+}
+
+bool checkCapacity(TimeDuration target, TimeDuration duration,
+                   size_t tenuredBytes, double promotionRate,
+                   size_t expected) {
+  size_t capacity = js::Nursery::capacityForPauseTarget(
+      target, duration, tenuredBytes, promotionRate);
+
+  // Allow for rounding in the floating point arithmetic.
+  CHECK(capacity + 1024 >= expected);
+  CHECK(capacity <= expected + 1024);
+  return true;
+}
+END_TEST(testGCNurseryPauseTarget)
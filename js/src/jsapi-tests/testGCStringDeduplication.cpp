@@ -0,0 +1,83 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/ArrayUtils.h"  // mozilla::ArrayLength
+
+#include "gc/GCRuntime.h"
+#include "gc/Nursery.h"
+#include "js/RootingAPI.h"
+#include "jsapi-tests/tests.h"
+#include "vm/Runtime.h"
+#include "vm/StringType.h"
+
+#include "vm/JSContext-inl.h"
+
+static bool CreateNurseryStrings(JSContext* cx,
+                                 JS::MutableHandleString first,
+                                 JS::MutableHandleString second) {
+  first.set(JS_NewStringCopyZ(cx, "dedup"));
+  second.set(JS_NewStringCopyZ(cx, "dedup"));
+  return first && second;
+}
+
+BEGIN_TEST(testGCStringDeduplication) {
+  if (!cx->nursery().isEnabled() || !cx->nursery().canAllocateStrings() ||
+      !cx->zone()->allocNurseryStrings) {
+    return true;
+  }
+
+  JS::RootedString first(cx);
+  JS::RootedString second(cx);
+
+  // Without deduplication each string is tenured separately.
+  CHECK(JS_GetGCParameter(cx, JSGC_STRING_DEDUPLICATION) == 0);
+  CHECK(CreateNurseryStrings(cx, &first, &second));
+  CHECK(js::gc::IsInsideNursery(first));
+  CHECK(js::gc::IsInsideNursery(second));
+  CHECK(first != second);
+  cx->minorGC(JS::GCReason::API);
+  CHECK(!js::gc::IsInsideNursery(first));
+  CHECK(first != second);
+
+  // With deduplication identical inline strings are tenured once.
+  JS_SetGCParameter(cx, JSGC_STRING_DEDUPLICATION, 1);
+  CHECK(CreateNurseryStrings(cx, &first, &second));
+  CHECK(js::gc::IsInsideNursery(first));
+  CHECK(js::gc::IsInsideNursery(second));
+  cx->minorGC(JS::GCReason::API);
+  CHECK(!js::gc::IsInsideNursery(first));
+  CHECK(first == second);
+
+  bool equal;
+  CHECK(JS_StringEqualsAscii(cx, first, "dedup", &equal));
+  CHECK(equal);
+
+  // Strings with the same characters in different encodings are kept apart.
+  // These are short enough to be thin inline strings in either encoding.
+  static const char16_t twoByteChars[] = u"abc";
+  first.set(JS_NewStringCopyZ(cx, "abc"));
+  CHECK(first);
+  second.set(js::NewStringCopyNDontDeflate<js::CanGC>(
+      cx, twoByteChars, mozilla::ArrayLength(twoByteChars) - 1));
+  CHECK(second);
+  CHECK(js::gc::IsInsideNursery(first));
+  CHECK(js::gc::IsInsideNursery(second));
+  CHECK(first->hasLatin1Chars());
+  CHECK(!second->hasLatin1Chars());
+  CHECK(first->getAllocKind() == second->getAllocKind());
+  cx->minorGC(JS::GCReason::API);
+  CHECK(!js::gc::IsInsideNursery(first));
+  CHECK(!js::gc::IsInsideNursery(second));
+  CHECK(first != second);
+  CHECK(first->hasLatin1Chars());
+  CHECK(!second->hasLatin1Chars());
+
+  JS_ResetGCParameter(cx, JSGC_STRING_DEDUPLICATION);
+
+  return true;
+}
+END_TEST(testGCStringDeduplication)
@@ -0,0 +1,177 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Maybe.h"  // mozilla::Maybe
+#include "mozilla/Utf8.h"   // mozilla::Utf8Unit
+
+#include <string.h>  // strlen
+
+#include "js/OffThreadScriptCompilation.h"  // JS::{Compile,Finish}OffThread*
+#include "js/SourceText.h"                  // JS::Source{Ownership,Text}
+#include "jsapi-tests/tests.h"
+#include "threading/Thread.h"
+#include "vm/HelperThreads.h"
+#include "vm/Monitor.h"
+#include "vm/MutexIDs.h"
+
+// Run helper thread tasks on a thread pool owned by the test, through
+// JS::SetHelperThreadTaskCallback and JS::RunHelperThreadTask.
+
+static const size_t PoolThreadCount = 2;
+static const size_t PoolThreadStackSize = 2 * 1024 * 1024;
+
+class TestThreadPool {
+  js::Monitor monitor_;
+  mozilla::Maybe<js::Thread> threads_[PoolThreadCount];
+  size_t requests_ = 0;
+  size_t tasksRun_ = 0;
+  bool terminate_ = false;
+
+  static void ThreadMain(TestThreadPool* pool) {
+    js::AutoLockMonitor lock(pool->monitor_);
+    while (true) {
+      while (!pool->requests_ && !pool->terminate_) {
+        lock.wait();
+      }
+      if (pool->terminate_) {
+        return;
+      }
+      pool->requests_--;
+
+      {
+        js::AutoUnlockMonitor unlock(pool->monitor_);
+        JS::RunHelperThreadTask();
+      }
+      pool->tasksRun_++;
+    }
+  }
+
+ public:
+  TestThreadPool() : monitor_(js::mutexid::ShellOffThreadState) {}
+
+  bool start() {
+    for (auto& thread : threads_) {
+      thread.emplace(js::Thread::Options().setStackSize(PoolThreadStackSize));
+      if (!thread->init(ThreadMain, this)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void stop() {
+    {
+      js::AutoLockMonitor lock(monitor_);
+      terminate_ = true;
+      lock.notifyAll();
+    }
+    for (auto& thread : threads_) {
+      if (thread && thread->joinable()) {
+        thread->join();
+      }
+      thread.reset();
+    }
+  }
+
+  void dispatch() {
+    // The helper thread lock must have been released.
+    MOZ_ASSERT(!js::HelperThreadState().isLockedByCurrentThread());
+
+    js::AutoLockMonitor lock(monitor_);
+    requests_++;
+    lock.notify();
+  }
+
+  size_t tasksRun() {
+    js::AutoLockMonitor lock(monitor_);
+    return tasksRun_;
+  }
+};
+
+static TestThreadPool* gPool = nullptr;
+
+// Called whenever a task may have become runnable.
+static void DispatchTask() { gPool->dispatch(); }
+
+BEGIN_TEST(testHelperThreadTaskCallback) {
+  static const char chars[] = "function f(a) { return a + 1; } f(41);";
+
+  JS::CompileOptions options(cx);
+  options.setFileAndLine(__FILE__, __LINE__);
+
+  JS::SourceText<mozilla::Utf8Unit> srcBuf;
+  CHECK(srcBuf.init(cx, chars, strlen(chars), JS::SourceOwnership::Borrowed));
+
+  size_t tasksBefore = pool.tasksRun();
+  CHECK(JS::CompileOffThread(cx, options, srcBuf, OffThreadCallback, this));
+
+  JS::OffThreadToken* result;
+  {
+    js::AutoLockMonitor lock(monitor);
+    while (!token) {
+      lock.wait();
+    }
+    result = token;
+    token = nullptr;
+  }
+
+  JS::RootedScript script(cx, JS::FinishOffThreadScript(cx, result));
+  CHECK(script);
+
+  JS::RootedValue rval(cx);
+  CHECK(JS_ExecuteScript(cx, script, &rval));
+  CHECK(rval.isInt32());
+  CHECK_EQUAL(rval.toInt32(), 42);
+
+  // The parse task ran on one of the pool's threads.
+  CHECK(pool.tasksRun() > tasksBefore);
+
+  // So do the GC's parallel tasks.
+  JS_GC(cx);
+
+  return true;
+}
+
+TestThreadPool pool;
+js::Monitor monitor{js::mutexid::ShellOffThreadState};
+JS::OffThreadToken* token = nullptr;
+
+static void OffThreadCallback(JS::OffThreadToken* token, void* context) {
+  auto self = static_cast<cls_testHelperThreadTaskCallback*>(context);
+  js::AutoLockMonitor lock(self->monitor);
+  self->token = token;
+  lock.notify();
+}
+
+// The callback must be set before the helper threads are initialized, which
+// happens when the first runtime is created. Start again with a fresh helper
+// thread state, as testHelperThreadOOM does.
+bool init() override {
+  js::DestroyHelperThreadsState();
+  if (!js::CreateHelperThreadsState()) {
+    return false;
+  }
+
+  gPool = &pool;
+  if (!pool.start()) {
+    return false;
+  }
+  if (!JS::SetHelperThreadTaskCallback(DispatchTask, PoolThreadCount)) {
+    return false;
+  }
+
+  return JSAPITest::init();
+}
+
+void uninit() override {
+  JSAPITest::uninit();
+
+  // Tasks still running on the pool are waited for, so stop it afterwards.
+  js::DestroyHelperThreadsState();
+  pool.stop();
+  gPool = nullptr;
+
+  js::CreateHelperThreadsState();
+}
+END_TEST(testHelperThreadTaskCallback)
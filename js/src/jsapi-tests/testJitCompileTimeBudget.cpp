@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jit/Ion.h"  // js::jit::IsIonEnabled
+#include "jsapi-tests/tests.h"
+#include "vm/HelperThreads.h"  // js::HelperThreadState
+
+#include "vm/JSScript-inl.h"
+
+// Off-thread compilations which run out of ion.compile-time-budget-ms are
+// retried once the script warms up again, rather than disabling Ion for it.
+
+BEGIN_TEST(testJitCompileTimeBudget) {
+  cx->runtime()->setOffthreadIonCompilationEnabled(true);
+
+  // The Ion JIT may be unavailable due to --disable-ion or lack of support
+  // for this platform.
+  if (!js::jit::IsIonEnabled(cx)) {
+    knownFail = true;
+  }
+
+  uint32_t oldBudget;
+  CHECK(JS_GetGlobalJitCompilerOption(cx, JSJITCOMPILER_ION_COMPILE_TIME_BUDGET,
+                                      &oldBudget));
+  JS_SetGlobalJitCompilerOption(cx, JSJITCOMPILER_ION_COMPILE_TIME_BUDGET, 1);
+  bool ok = testBudget();
+  JS_SetGlobalJitCompilerOption(cx, JSJITCOMPILER_ION_COMPILE_TIME_BUDGET,
+                                oldBudget);
+  CHECK(ok);
+
+  return true;
+}
+
+bool testBudget() {
+  // A function big enough that its backend is unlikely to finish within a
+  // millisecond.
+  EXEC(
+      "var body = '';\n"
+      "for (var i = 0; i < 2000; i++) {\n"
+      "  body += 'x = (x * 31 + ' + i + ') | 0;\\n';\n"
+      "}\n"
+      "var f = new Function('x', body + 'return x;');\n");
+
+  JS::RootedValue fval(cx);
+  CHECK(JS_GetProperty(cx, global, "f", &fval));
+  JS::RootedFunction fun(cx, &fval.toObject().as<JSFunction>());
+  JS::RootedScript script(cx, JS_GetFunctionScript(cx, fun));
+  CHECK(script);
+
+  // However often the budget runs out, Ion stays enabled for f.
+  for (size_t i = 0; i < 20; i++) {
+    CHECK(callAndWait(fval));
+    CHECK(script->canIonCompile());
+  }
+
+  // Without a budget, f gets Ion code once it is warm again.
+  JS_SetGlobalJitCompilerOption(cx, JSJITCOMPILER_ION_COMPILE_TIME_BUDGET, 0);
+  for (size_t i = 0; i < 50 && !script->hasIonScript(); i++) {
+    CHECK(callAndWait(fval));
+  }
+  CHECK(script->hasIonScript());
+
+  return true;
+}
+
+// Call f a few hundred times, then let any off-thread compilation finish.
+bool callAndWait(JS::HandleValue fval) {
+  JS::RootedValue arg(cx, JS::Int32Value(1));
+  JS::RootedValue rval(cx);
+  for (size_t i = 0; i < 200; i++) {
+    CHECK(JS_CallFunctionValue(cx, global, fval, JS::HandleValueArray(arg),
+                               &rval));
+  }
+  js::HelperThreadState().waitForAllThreads();
+  return true;
+}
+END_TEST(testJitCompileTimeBudget)
@@ -0,0 +1,105 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/ArrayUtils.h"  // mozilla::ArrayLength
+#include "mozilla/Sprintf.h"     // SprintfLiteral
+
+#include "jit/Ion.h"        // js::jit::{Invalidate,IsIonEnabled}
+#include "jit/JitScript.h"  // js::jit::JitScript
+#include "jsapi-tests/tests.h"
+
+#include "vm/JSScript-inl.h"
+
+// Only invalidations caused by bailouts and type changes count towards
+// JitOptions.ionInvalidationThreshold.
+
+BEGIN_TEST(testJitInvalidationThreshold) {
+  cx->runtime()->setOffthreadIonCompilationEnabled(false);
+
+  // The Ion JIT may be unavailable due to --disable-ion or lack of support
+  // for this platform.
+  if (!js::jit::IsIonEnabled(cx)) {
+    knownFail = true;
+  }
+
+  uint32_t oldThreshold;
+  CHECK(JS_GetGlobalJitCompilerOption(
+      cx, JSJITCOMPILER_ION_INVALIDATION_THRESHOLD, &oldThreshold));
+  JS_SetGlobalJitCompilerOption(cx, JSJITCOMPILER_ION_INVALIDATION_THRESHOLD,
+                                3);
+  bool ok = testThreshold();
+  JS_SetGlobalJitCompilerOption(cx, JSJITCOMPILER_ION_INVALIDATION_THRESHOLD,
+                                oldThreshold);
+  CHECK(ok);
+
+  return true;
+}
+
+bool testThreshold() {
+  EXEC(
+      "function f(o) { return o.p; }\n"
+      "function make(v) { return {p: v}; }\n");
+
+  JS::RootedValue v(cx);
+  CHECK(JS_GetProperty(cx, global, "f", &v));
+  JS::RootedFunction fun(cx, &v.toObject().as<JSFunction>());
+  JS::RootedScript script(cx, JS_GetFunctionScript(cx, fun));
+  CHECK(script);
+
+  // Replacing Ion code, as linking a newer compilation does, isn't counted.
+  for (size_t i = 0; i < 3; i++) {
+    CHECK(warmUp(script, "1"));
+    js::jit::Invalidate(cx, script, /* resetUses = */ false);
+    CHECK_EQUAL(script->jitScript()->ionInvalidationCount(), 0u);
+  }
+  CHECK(script->canIonCompile());
+
+  // A new type for o.p invalidates f.
+  CHECK(warmUp(script, "1"));
+  CHECK(warmUp(script, "1.5"));
+  CHECK(script->jitScript()->ionInvalidationCount() > 0);
+
+  // Ion code which survives until a GC discards it resets the count.
+  JS_GC(cx);
+  CHECK(!script->hasJitScript() ||
+        script->jitScript()->ionInvalidationCount() == 0);
+
+  // The GC may have relazified f.
+  script = JS_GetFunctionScript(cx, fun);
+  CHECK(script);
+
+  // Enough invalidations disable Ion compilation of f.
+  static const char* const values[] = {"'s'",       "true",     "null",
+                                       "undefined", "Symbol()", "({})"};
+  for (size_t i = 0; i < mozilla::ArrayLength(values); i++) {
+    warmUp(script, values[i]);
+    if (!script->canIonCompile()) {
+      break;
+    }
+  }
+  CHECK(!script->canIonCompile());
+  CHECK(!script->hasIonScript());
+
+  return true;
+}
+
+// Call f enough times to Ion-compile it, passing an object whose p property
+// has the value |value|. Returns whether f has Ion code afterwards.
+bool warmUp(JS::HandleScript script, const char* value) {
+  char chars[64];
+  SprintfLiteral(chars, "make(%s)", value);
+
+  JS::RootedValue arg(cx);
+  CHECK(evaluate(chars, __FILE__, __LINE__, &arg));
+
+  JS::RootedValue fval(cx);
+  CHECK(JS_GetProperty(cx, global, "f", &fval));
+  JS::RootedValue rval(cx);
+  for (size_t i = 0; i < 3000; i++) {
+    CHECK(JS_CallFunctionValue(cx, global, fval, JS::HandleValueArray(arg),
+                               &rval));
+  }
+  return script->hasIonScript();
+}
+END_TEST(testJitInvalidationThreshold)
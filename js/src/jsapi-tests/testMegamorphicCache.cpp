@@ -0,0 +1,168 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>  // strlen
+
+#include "jit/VMFunctions.h"  // js::jit::{Get,Has}NativeDataPropertyPure
+#include "jsapi-tests/tests.h"
+#include "vm/Caches.h"  // js::MegamorphicCache
+#include "vm/JSAtom.h"  // js::Atomize
+#include "vm/NativeObject.h"
+#include "vm/Runtime.h"
+
+#include "vm/JSAtom-inl.h"  // js::AtomToId
+
+// The megamorphic property cache maps (receiver shape, id) pairs to the slot
+// of an own data property, for the VM helpers behind megamorphic ICs.
+
+struct MegamorphicCacheFixture : public JSAPITest {
+  js::MegamorphicCache& cache() {
+    return cx->runtime()->caches().megamorphicCache;
+  }
+
+  js::Shape* shapeOf(JS::HandleObject obj) {
+    return obj->as<js::NativeObject>().lastProperty();
+  }
+
+  bool isCached(JS::HandleObject obj, const char* name) {
+    JS::RootedId id(cx, idFor(name));
+    uint32_t slot;
+    return cache().lookup(shapeOf(obj), id, &slot);
+  }
+
+  // Get |name| the way megamorphic IC stubs do.
+  bool getPure(JS::HandleObject obj, const char* name,
+               JS::MutableHandleValue vp) {
+    JS::RootedId id(cx, idFor(name));
+    js::PropertyName* propName = JSID_TO_ATOM(id)->asPropertyName();
+    return js::jit::GetNativeDataPropertyPure<false>(cx, obj, propName,
+                                                     vp.address());
+  }
+
+  // Check for |name| the way megamorphic 'in' stubs do.
+  bool hasPure(JS::HandleObject obj, const char* name, bool* found) {
+    JS::AutoValueArray<2> vp(cx);
+    vp[0].setString(JSID_TO_ATOM(idFor(name)));
+    if (!js::jit::HasNativeDataPropertyPure<false>(cx, obj, vp.begin())) {
+      return false;
+    }
+    *found = vp[1].toBoolean();
+    return true;
+  }
+
+  jsid idFor(const char* name) {
+    JSAtom* atom = js::Atomize(cx, name, strlen(name));
+    MOZ_RELEASE_ASSERT(atom);
+    return js::AtomToId(atom);
+  }
+};
+
+BEGIN_FIXTURE_TEST(MegamorphicCacheFixture, testMegamorphicCache) {
+  JS::RootedValue v(cx);
+  EVAL("var obj = {a: 1, b: 2}; obj", &v);
+  JS::RootedObject obj(cx, &v.toObject());
+
+  // A miss fills the cache, and later lookups of the same shape hit it.
+  cache().purge();
+  CHECK(!isCached(obj, "b"));
+  CHECK(getPure(obj, "b", &v));
+  CHECK_SAME(v, JS::Int32Value(2));
+  CHECK(isCached(obj, "b"));
+
+  // Hits read the property's current value.
+  EXEC("obj.b = 3;");
+  CHECK(getPure(obj, "b", &v));
+  CHECK_SAME(v, JS::Int32Value(3));
+
+  // Adding a property gives the object a new shape, which isn't cached yet.
+  js::Shape* oldShape = shapeOf(obj);
+  EXEC("obj.c = 4;");
+  CHECK(shapeOf(obj) != oldShape);
+  CHECK(!isCached(obj, "b"));
+  CHECK(getPure(obj, "b", &v));
+  CHECK_SAME(v, JS::Int32Value(3));
+  CHECK(isCached(obj, "b"));
+
+  // Deleting a property other than the last one makes the object use a
+  // dictionary shape, which is never cached.
+  EXEC("delete obj.a;");
+  CHECK(shapeOf(obj)->inDictionary());
+  CHECK(getPure(obj, "b", &v));
+  CHECK_SAME(v, JS::Int32Value(3));
+  CHECK(!isCached(obj, "b"));
+
+  // Major GCs purge the cache.
+  EVAL("obj = {a: 1, b: 2}; obj", &v);
+  obj = &v.toObject();
+  CHECK(getPure(obj, "b", &v));
+  CHECK(isCached(obj, "b"));
+  JS_GC(cx);
+  CHECK(!isCached(obj, "b"));
+
+  return true;
+}
+END_FIXTURE_TEST(MegamorphicCacheFixture, testMegamorphicCache)
+
+BEGIN_FIXTURE_TEST(MegamorphicCacheFixture, testMegamorphicCachePurge) {
+  JS::RootedValue v(cx);
+  EVAL("var obj = {a: 1, b: 2}; obj", &v);
+  JS::RootedObject obj(cx, &v.toObject());
+  bool found;
+
+  // Entries filled by either helper are dropped by both kinds of purge.
+  CHECK(getPure(obj, "b", &v));
+  CHECK(isCached(obj, "b"));
+  cx->runtime()->caches().purgeForCompaction();
+  CHECK(!isCached(obj, "b"));
+
+  CHECK(hasPure(obj, "b", &found));
+  CHECK(found);
+  CHECK(isCached(obj, "b"));
+  cx->runtime()->caches().purge();
+  CHECK(!isCached(obj, "b"));
+
+  // After a compacting GC, which may have moved the object and its shape,
+  // lookups still find the property.
+  CHECK(getPure(obj, "b", &v));
+  JS::PrepareForFullGC(cx);
+  JS::NonIncrementalGC(cx, GC_SHRINK, JS::GCReason::API);
+  CHECK(!isCached(obj, "b"));
+  CHECK(getPure(obj, "b", &v));
+  CHECK_SAME(v, JS::Int32Value(2));
+  CHECK(hasPure(obj, "b", &found));
+  CHECK(found);
+  CHECK(hasPure(obj, "z", &found));
+  CHECK(!found);
+
+#ifdef JS_GC_ZEAL
+  // Run megamorphic property loads and 'in' checks while compacting GCs
+  // keep moving the objects and their shapes around (gczeal(14)).
+  JS_SetGCZeal(cx, 14, 50);
+  bool ok = exec(
+      "var objs = [];\n"
+      "for (var i = 0; i < 20; i++) {\n"
+      "  var o = {x: i};\n"
+      "  o['p' + i] = i;\n"
+      "  objs.push(o);\n"
+      "}\n"
+      "var sum = 0, count = 0;\n"
+      "for (var j = 0; j < 2000; j++) {\n"
+      "  var o = objs[j % 20];\n"
+      "  if ('x' in o) {\n"
+      "    count++;\n"
+      "  }\n"
+      "  sum += o.x;\n"
+      "  var garbage = [j];\n"
+      "}\n"
+      "if (count !== 2000 || sum !== 19000) {\n"
+      "  throw new Error('wrong result');\n"
+      "}\n",
+      __FILE__, __LINE__);
+  JS_SetGCZeal(cx, 0, 0);
+  CHECK(ok);
+#endif
+
+  return true;
+}
+END_FIXTURE_TEST(MegamorphicCacheFixture, testMegamorphicCachePurge)
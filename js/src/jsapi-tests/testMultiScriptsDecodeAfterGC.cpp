@@ -0,0 +1,172 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Sprintf.h"  // SprintfLiteral
+#include "mozilla/Utf8.h"     // mozilla::Utf8Unit
+#include "mozilla/Vector.h"   // mozilla::Vector
+
+#include <string.h>  // strlen
+
+#include "gc/GC.h"                          // js::gc::FinishGC
+#include "js/CompilationAndEvaluation.h"    // JS::CompileDontInflate
+#include "js/OffThreadScriptCompilation.h"  // JS::*MultiOffThreadScripts*
+#include "js/SourceText.h"                  // JS::Source{Ownership,Text}
+#include "js/Transcoding.h"  // JS::{EncodeScript,Transcode{Buffer,Sources}}
+#include "jsapi-tests/tests.h"
+#include "vm/HelperThreads.h"  // js::OffThreadParsingMustWaitForGC
+#include "vm/Monitor.h"
+#include "vm/MutexIDs.h"
+
+// Parse tasks started during an incremental GC of the atoms zone wait for the
+// GC to finish, and are queued by EnqueuePendingParseTasksAfterGC.  A
+// multi-script decode is split into several tasks, which must all be queued
+// or dropped without losing track of the lead task.
+
+static const size_t NumScripts = 32;
+
+struct MultiScriptsDecodeFixture : public JSAPITest {
+  mozilla::Vector<JS::TranscodeBuffer> buffers;
+  JS::TranscodeSources sources;
+
+  js::Monitor monitor;
+  JS::OffThreadToken* token;
+
+  MultiScriptsDecodeFixture()
+      : monitor(js::mutexid::ShellOffThreadState), token(nullptr) {}
+
+  static void OffThreadCallback(JS::OffThreadToken* token, void* context) {
+    auto self = static_cast<MultiScriptsDecodeFixture*>(context);
+    js::AutoLockMonitor alm(self->monitor);
+    self->token = token;
+    alm.notify();
+  }
+
+  bool encodeScripts() {
+    CHECK(buffers.resize(NumScripts));
+    for (size_t i = 0; i < NumScripts; i++) {
+      char chars[32];
+      SprintfLiteral(chars, "%zu * 2", i);
+
+      JS::CompileOptions options(cx);
+      options.setFileAndLine(__FILE__, __LINE__);
+
+      JS::SourceText<mozilla::Utf8Unit> srcBuf;
+      CHECK(srcBuf.init(cx, chars, strlen(chars),
+                        JS::SourceOwnership::Borrowed));
+
+      JS::RootedScript script(cx, JS::CompileDontInflate(cx, options, srcBuf));
+      CHECK(script);
+      CHECK(JS::EncodeScript(cx, buffers[i], script) == JS::TranscodeResult_Ok);
+    }
+
+    // |buffers| doesn't change from here on, so the ranges stay valid.
+    for (auto& buffer : buffers) {
+      JS::TranscodeRange range(buffer.begin(), buffer.length());
+      CHECK(sources.emplaceBack(range, __FILE__, __LINE__));
+    }
+    return true;
+  }
+
+  void startAtomsZoneGC() {
+    JS::PrepareForFullGC(cx);
+    js::SliceBudget budget(js::WorkBudget(1));
+    cx->runtime()->gc.startDebugGC(GC_NORMAL, budget);
+  }
+
+  // Start decoding while the atoms zone is being collected, then finish the
+  // GC and the decode.  Returns false, with an exception pending, if the
+  // decode failed.
+  bool decodeDuringGC(JS::MutableHandle<JS::GCVector<JSScript*>> scripts) {
+    JS::CompileOptions options(cx);
+    options.setFileAndLine(__FILE__, __LINE__);
+
+    bool started = JS::DecodeMultiOffThreadScripts(
+        cx, options, sources, OffThreadCallback, this);
+    js::gc::FinishGC(cx);
+    if (!started) {
+      return false;
+    }
+
+    JS::OffThreadToken* result;
+    {
+      js::AutoLockMonitor alm(monitor);
+      while (!token) {
+        alm.wait();
+      }
+      result = token;
+      token = nullptr;
+    }
+    return JS::FinishMultiOffThreadScriptsDecoder(cx, result, scripts);
+  }
+
+  bool checkScripts(JS::Handle<JS::GCVector<JSScript*>> scripts) {
+    CHECK_EQUAL(scripts.length(), NumScripts);
+    JS::RootedScript script(cx);
+    JS::RootedValue rval(cx);
+    for (size_t i = 0; i < NumScripts; i++) {
+      script = scripts[i];
+      CHECK(JS_ExecuteScript(cx, script, &rval));
+      CHECK(rval.isInt32());
+      CHECK_EQUAL(size_t(rval.toInt32()), i * 2);
+    }
+    return true;
+  }
+};
+
+BEGIN_FIXTURE_TEST(MultiScriptsDecodeFixture, testMultiScriptsDecodeAfterGC) {
+  CHECK(encodeScripts());
+
+  startAtomsZoneGC();
+  CHECK(js::OffThreadParsingMustWaitForGC(cx->runtime()));
+
+  JS::Rooted<JS::GCVector<JSScript*>> scripts(cx,
+                                               JS::GCVector<JSScript*>(cx));
+  CHECK(decodeDuringGC(&scripts));
+  CHECK(checkScripts(scripts));
+
+  return true;
+}
+END_FIXTURE_TEST(MultiScriptsDecodeFixture, testMultiScriptsDecodeAfterGC)
+
+#ifdef DEBUG  // js::oom functions are only available in debug builds.
+
+BEGIN_FIXTURE_TEST(MultiScriptsDecodeFixture,
+                   testMultiScriptsDecodeAfterGC_OOM) {
+  CHECK(encodeScripts());
+
+  // Fail each main thread allocation in turn, including those which queue
+  // the waiting tasks when the GC finishes.  Every decode must either
+  // succeed or fail cleanly, and always report its lead task as finished.
+  const uint32_t maxAllocs = 1000;
+  uint32_t oomAfter;
+  for (oomAfter = 1; oomAfter < maxAllocs; ++oomAfter) {
+    startAtomsZoneGC();
+    CHECK(js::OffThreadParsingMustWaitForGC(cx->runtime()));
+
+    JS::Rooted<JS::GCVector<JSScript*>> scripts(cx,
+                                                 JS::GCVector<JSScript*>(cx));
+    js::oom::simulator.simulateFailureAfter(
+        js::oom::FailureSimulator::Kind::OOM, oomAfter, js::THREAD_TYPE_MAIN,
+        true);
+    bool ok = decodeDuringGC(&scripts);
+    bool hadOOM = js::oom::HadSimulatedOOM();
+    js::oom::simulator.reset();
+
+    if (ok) {
+      CHECK(checkScripts(scripts));
+    } else {
+      CHECK(hadOOM);
+      JS_ClearPendingException(cx);
+    }
+    if (!hadOOM) {
+      break;
+    }
+  }
+  CHECK(oomAfter != maxAllocs);
+
+  return true;
+}
+END_FIXTURE_TEST(MultiScriptsDecodeFixture, testMultiScriptsDecodeAfterGC_OOM)
+
+#endif  // DEBUG
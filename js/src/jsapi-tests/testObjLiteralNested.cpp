@@ -0,0 +1,215 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Utf8.h"  // mozilla::Utf8Unit
+
+#include <string.h>  // strlen
+
+#include "js/CompilationAndEvaluation.h"  // JS::CompileDontInflate
+#include "js/SourceText.h"                // JS::Source{Ownership,Text}
+#include "js/Vector.h"                    // js::Vector
+#include "jsapi-tests/tests.h"
+#include "vm/BytecodeUtil.h"  // js::GetNextPc
+#include "vm/JSObject.h"      // JSObject
+#include "vm/JSScript.h"      // JSScript
+
+// Object and array literals whose values are themselves literal-only objects
+// and arrays are encoded as a single ObjLiteral (ObjLiteralOpcode::Nested) in
+// run-once scripts, and built by bytecode everywhere else.
+
+struct ObjLiteralNestedFixture : public JSAPITest {
+  size_t numObjectOps = 0;
+  size_t numAllocOps = 0;
+
+  // Compile and run |source| as a global script, store the result as the
+  // global |o|, and count the JSOp::Object ops and the ops which allocate a
+  // new object or array.
+  bool compileAndRun(const char* source, bool runOnce) {
+    JS::CompileOptions options(cx);
+    options.setFileAndLine(__FILE__, __LINE__).setIsRunOnce(runOnce);
+
+    JS::SourceText<mozilla::Utf8Unit> srcBuf;
+    CHECK(srcBuf.init(cx, source, strlen(source),
+                      JS::SourceOwnership::Borrowed));
+
+    JS::RootedScript script(cx, JS::CompileDontInflate(cx, options, srcBuf));
+    CHECK(script);
+
+    numObjectOps = 0;
+    numAllocOps = 0;
+    for (jsbytecode* pc = script->code(); pc < script->codeEnd();
+         pc = js::GetNextPc(pc)) {
+      switch (JSOp(*pc)) {
+        case JSOp::Object:
+          numObjectOps++;
+          break;
+        case JSOp::NewInit:
+        case JSOp::NewObject:
+        case JSOp::NewObjectWithGroup:
+        case JSOp::NewArray:
+        case JSOp::NewArrayCopyOnWrite:
+          numAllocOps++;
+          break;
+        default:
+          break;
+      }
+    }
+
+    JS::RootedValue rval(cx);
+    CHECK(JS_ExecuteScript(cx, script, &rval));
+    CHECK(JS_SetProperty(cx, global, "o", rval));
+    return true;
+  }
+
+  bool checkJSON(const char* expected) {
+    JS::RootedValue json(cx);
+    EVAL("JSON.stringify(o)", &json);
+    CHECK(json.isString());
+    bool match;
+    CHECK(JS_StringEqualsAscii(cx, json.toString(), expected, &match));
+    CHECK(match);
+    return true;
+  }
+
+  JSObject* getObject(const char* expr) {
+    JS::RootedValue v(cx);
+    if (!evaluate(expr, __FILE__, __LINE__, &v) || !v.isObject()) {
+      return nullptr;
+    }
+    return &v.toObject();
+  }
+};
+
+#define DATA_TREE                                        \
+  "({a: {b: [1, 2.5, {c: 'x'}], d: null, e: {g: -1}}," \
+  " f: [[0], [true, [false]]]})"
+#define DATA_TREE_JSON                                                      \
+  "{\"a\":{\"b\":[1,2.5,{\"c\":\"x\"}],\"d\":null,\"e\":{\"g\":-1}}," \
+  "\"f\":[[0],[true,[false]]]}"
+
+BEGIN_FIXTURE_TEST(ObjLiteralNestedFixture, testObjLiteralNested_RunOnce) {
+  // The whole tree is a single JSOp::Object.
+  CHECK(compileAndRun(DATA_TREE, /* runOnce = */ true));
+  CHECK_EQUAL(numObjectOps, size_t(1));
+  CHECK_EQUAL(numAllocOps, size_t(0));
+  CHECK(checkJSON(DATA_TREE_JSON));
+
+  // Nested arrays are ordinary extensible arrays, not copy-on-write ones.
+  EXEC("o.f[1].push(1); o.a.b[2].c = 'y';");
+  CHECK(checkJSON(
+      "{\"a\":{\"b\":[1,2.5,{\"c\":\"y\"}],\"d\":null,\"e\":{\"g\":-1}},"
+      "\"f\":[[0],[true,[false],1]]}"));
+
+  // Anything non-literal in the tree means it's built by bytecode.
+  CHECK(compileAndRun("({a: {b: [1, [].length]}})", /* runOnce = */ true));
+  CHECK(numAllocOps > 0);
+  CHECK(checkJSON("{\"a\":{\"b\":[1,0]}}"));
+
+  CHECK(compileAndRun("({a: [{b: 1, ['c']: 2}]})", /* runOnce = */ true));
+  CHECK(numAllocOps > 0);
+  CHECK(checkJSON("{\"a\":[{\"b\":1,\"c\":2}]}"));
+
+  // Empty arrays aren't constant, but the result must be the same.
+  CHECK(compileAndRun("({a: [[], {b: []}]})", /* runOnce = */ true));
+  CHECK(checkJSON("{\"a\":[[],{\"b\":[]}]}"));
+
+  return true;
+}
+END_FIXTURE_TEST(ObjLiteralNestedFixture, testObjLiteralNested_RunOnce)
+
+BEGIN_FIXTURE_TEST(ObjLiteralNestedFixture, testObjLiteralNested_NotRunOnce) {
+  // Outside run-once code every evaluation needs fresh objects, so nothing is
+  // emitted as JSOp::Object.
+  CHECK(compileAndRun(DATA_TREE, /* runOnce = */ false));
+  CHECK_EQUAL(numObjectOps, size_t(0));
+  CHECK(numAllocOps > 0);
+  CHECK(checkJSON(DATA_TREE_JSON));
+
+  // Nor in loops of run-once code.
+  CHECK(compileAndRun(
+      "var r; for (var i = 0; i < 2; i++) { r = " DATA_TREE "; } r",
+      /* runOnce = */ true));
+  CHECK_EQUAL(numObjectOps, size_t(0));
+  CHECK(checkJSON(DATA_TREE_JSON));
+
+  return true;
+}
+END_FIXTURE_TEST(ObjLiteralNestedFixture, testObjLiteralNested_NotRunOnce)
+
+BEGIN_FIXTURE_TEST(ObjLiteralNestedFixture, testObjLiteralNested_Groups) {
+  CHECK(compileAndRun("({x: {a: 1, b: 'p'}, y: {a: 2, b: 'q'}, z: {c: 3}})",
+                      /* runOnce = */ true));
+  CHECK_EQUAL(numObjectOps, size_t(1));
+
+  // The outer object is a singleton, as it is without nested literals.
+  JS::RootedObject outer(cx, getObject("o"));
+  CHECK(outer);
+  CHECK(outer->isSingleton());
+
+  // Nested objects aren't singletons, and get their group from their
+  // property names, like the inner objects of a singleton built by bytecode.
+  JS::RootedObject x(cx, getObject("o.x"));
+  JS::RootedObject y(cx, getObject("o.y"));
+  JS::RootedObject z(cx, getObject("o.z"));
+  CHECK(x && y && z);
+  CHECK(!x->isSingleton());
+  CHECK(x->group() == y->group());
+  CHECK(x->group() != z->group());
+
+  // Type information for the shared group includes both values.
+  EXEC("o.x.a = 1.5;");
+  CHECK(checkJSON(
+      "{\"x\":{\"a\":1.5,\"b\":\"p\"},\"y\":{\"a\":2,\"b\":\"q\"},"
+      "\"z\":{\"c\":3}}"));
+
+  return true;
+}
+END_FIXTURE_TEST(ObjLiteralNestedFixture, testObjLiteralNested_Groups)
+
+BEGIN_FIXTURE_TEST(ObjLiteralNestedFixture, testObjLiteralNested_Deep) {
+  CHECK(checkDepth(100));
+
+  // Nesting deep enough to exhaust the native stack in the emitter or the
+  // parser must either still produce the right value or report an error.
+  CHECK(checkDepth(10000));
+  CHECK(checkDepth(100000));
+
+  return true;
+}
+
+bool checkDepth(size_t depth) {
+  js::Vector<char, 0, js::SystemAllocPolicy> source;
+  for (size_t i = 0; i < depth; i++) {
+    CHECK(source.append(i % 2 ? "{a: " : "[", i % 2 ? 4 : 1));
+  }
+  CHECK(source.append("1", 1));
+  for (size_t i = depth; i > 0; i--) {
+    CHECK(source.append((i - 1) % 2 ? "}" : "]", 1));
+  }
+  CHECK(source.append("\0", 1));
+
+  if (!compileAndRun(source.begin(), /* runOnce = */ true)) {
+    CHECK(JS_IsExceptionPending(cx));
+    JS_ClearPendingException(cx);
+    return true;
+  }
+  if (depth <= 100) {
+    CHECK_EQUAL(numObjectOps, size_t(1));
+    CHECK_EQUAL(numAllocOps, size_t(0));
+  }
+
+  JS::RootedValue result(cx);
+  EVAL(
+      "var n = 0;"
+      "for (var v = o; typeof v === 'object';"
+      "     v = Array.isArray(v) ? v[0] : v.a) {"
+      "  n++;"
+      "}"
+      "v === 1 ? n : -1",
+      &result);
+  CHECK(result.isInt32());
+  CHECK_EQUAL(size_t(result.toInt32()), depth);
+  return true;
+}
+END_FIXTURE_TEST(ObjLiteralNestedFixture, testObjLiteralNested_Deep)
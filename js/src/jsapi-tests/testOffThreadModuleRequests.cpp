@@ -0,0 +1,98 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/ArrayUtils.h"  // mozilla::ArrayLength
+
+#include <string.h>  // memcmp
+
+#include "gc/GC.h"                          // js::gc::FinishGC
+#include "js/OffThreadScriptCompilation.h"  // JS::*OffThreadModule*
+#include "js/SourceText.h"                  // JS::Source{Ownership,Text}
+#include "jsapi-tests/tests.h"
+#include "vm/HelperThreads.h"  // js::OffThreadParsingMustWaitForGC
+#include "vm/Monitor.h"
+#include "vm/MutexIDs.h"
+
+// The import specifiers of a module compiled off thread can be read from the
+// compile callback, before the module is finished on the main thread.
+
+struct ModuleRequestsFixture : public JSAPITest {
+  js::Monitor monitor;
+  JS::OffThreadToken* token;
+
+  // Filled in by the callback, on the helper thread.
+  size_t count;
+  bool firstOk;
+  bool secondOk;
+
+  ModuleRequestsFixture()
+      : monitor(js::mutexid::ShellOffThreadState),
+        token(nullptr),
+        count(0),
+        firstOk(false),
+        secondOk(false) {}
+
+  static bool requestEquals(JS::OffThreadToken* token, size_t index,
+                            const char16_t* expected, size_t expectedLength) {
+    size_t length;
+    const char16_t* chars =
+        JS::GetOffThreadModuleRequest(token, index, &length);
+    return length == expectedLength && chars[length] == '\0' &&
+           memcmp(chars, expected, length * sizeof(char16_t)) == 0;
+  }
+
+  static void OffThreadCallback(JS::OffThreadToken* token, void* context) {
+    auto self = static_cast<ModuleRequestsFixture*>(context);
+
+    size_t count = JS::GetOffThreadModuleRequestCount(token);
+    bool firstOk = count == 2 && requestEquals(token, 0, u"a.js", 4);
+    // The second specifier contains a null character.
+    bool secondOk = count == 2 && requestEquals(token, 1, u"b\0.js", 5);
+
+    js::AutoLockMonitor alm(self->monitor);
+    self->count = count;
+    self->firstOk = firstOk;
+    self->secondOk = secondOk;
+    self->token = token;
+    alm.notify();
+  }
+};
+
+BEGIN_FIXTURE_TEST(ModuleRequestsFixture, testOffThreadModuleRequests) {
+  static const char16_t src[] =
+      u"import 'a.js';\n"
+      u"import { x } from 'b\\0.js';\n";
+
+  JS::CompileOptions options(cx);
+  options.setFileAndLine(__FILE__, __LINE__);
+  options.forceAsync = true;
+
+  JS::SourceText<char16_t> srcBuf;
+  CHECK(srcBuf.init(cx, src, mozilla::ArrayLength(src) - 1,
+                    JS::SourceOwnership::Borrowed));
+  CHECK(JS::CompileOffThreadModule(cx, options, srcBuf, OffThreadCallback,
+                                   this));
+  if (js::OffThreadParsingMustWaitForGC(cx->runtime())) {
+    js::gc::FinishGC(cx);
+  }
+
+  JS::OffThreadToken* result;
+  {
+    js::AutoLockMonitor alm(monitor);
+    while (!token) {
+      alm.wait();
+    }
+    result = token;
+  }
+
+  CHECK_EQUAL(count, size_t(2));
+  CHECK(firstOk);
+  CHECK(secondOk);
+
+  JS::RootedObject module(cx, JS::FinishOffThreadModule(cx, result));
+  CHECK(module);
+
+  return true;
+}
+END_FIXTURE_TEST(ModuleRequestsFixture, testOffThreadModuleRequests)
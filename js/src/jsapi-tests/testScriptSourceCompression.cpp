@@ -15,6 +15,7 @@
 #include <stdint.h>   // uint32_t
 
 #include "jsapi.h"  // JS_EnsureLinearString, JS_GC, JS_Get{Latin1,TwoByte}LinearStringChars, JS_GetStringLength, JS_ValueToFunction
+#include "jsfriendapi.h"  // js::SetSourceCompressionCodec, js::SourceCompressionCodec
 #include "jstypes.h"  // JS_PUBLIC_API
 
 #include "js/CompilationAndEvaluation.h"  // JS::Evaluate{,DontInflate}
@@ -477,3 +478,41 @@ bool run() {
   return true;
 }
 END_TEST(testScriptSourceCompression_spansMultipleMiddleChunks)
+
+BEGIN_TEST(testScriptSourceCompression_lz4SpansMultipleMiddleChunks) {
+  js::SetSourceCompressionCodec(cx, js::SourceCompressionCodec::LZ4);
+  bool ok = run<char16_t>() && run<Utf8Unit>();
+  js::SetSourceCompressionCodec(cx, js::SourceCompressionCodec::Zlib);
+  CHECK(ok);
+  return true;
+}
+
+template <typename Unit>
+bool run() {
+  // Four chunks, each compressed as its own LZ4 block.
+  constexpr size_t len = (4 * ChunkSize) / sizeof(Unit);
+  auto source = MakeSourceAllWhitespace<Unit>(cx, len);
+  CHECK(source);
+
+  // This function spans the two middle chunks and further extends one
+  // character to each side.
+  constexpr size_t FunctionSize = 2 + (2 * ChunkSize) / sizeof(Unit);
+
+  // Write out an 's' or 't' function.
+  constexpr char FunctionName = 'r' + sizeof(Unit);
+  WriteFunctionOfSizeAtOffset(source, len, FunctionName, FunctionSize,
+                              ChunkSize / sizeof(Unit) - 1);
+
+  JS::Rooted<JSFunction*> fun(cx);
+  fun = EvaluateChars(cx, std::move(source), len, FunctionName, __FUNCTION__);
+  CHECK(fun);
+
+  CompressSourceSync(fun, cx);
+
+  JS::Rooted<JSString*> str(cx, DecompressSource(cx, fun));
+  CHECK(str);
+  CHECK(IsExpectedFunctionString(str, FunctionName, cx));
+
+  return true;
+}
+END_TEST(testScriptSourceCompression_lz4SpansMultipleMiddleChunks)
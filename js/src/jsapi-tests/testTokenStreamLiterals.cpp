@@ -0,0 +1,80 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Utf8.h"  // mozilla::Utf8Unit
+
+#include "js/CompilationAndEvaluation.h"  // JS::Evaluate{,DontInflate}
+#include "js/SourceText.h"                // JS::Source{Ownership,Text}
+#include "jsapi-tests/tests.h"
+
+// The tokenizer skips runs of plain ASCII code units in string and template
+// literals a word at a time.  Check that everything which ends such a run is
+// still processed, wherever it falls in a word, for both UTF-8 and UTF-16
+// source.
+#define CHECK_LITERAL(source, expected) \
+  CHECK(checkLiteral(u8##source, u##source, u##expected))
+
+BEGIN_TEST(testTokenStreamLiterals) {
+  CHECK_LITERAL("'abcdefghijklmnopqrstuvwxyz'", "abcdefghijklmnopqrstuvwxyz");
+  CHECK_LITERAL("''", "");
+  CHECK_LITERAL("'a'", "a");
+
+  // Escapes.
+  CHECK_LITERAL("'abcdefgh\\nijklmnop\\\\qrstuvw\\'xyz'",
+                "abcdefgh\nijklmnop\\qrstuvw'xyz");
+  CHECK_LITERAL("'\\tabcdefghijklmno\\x41'", "\tabcdefghijklmnoA");
+  CHECK_LITERAL("'abcdefgh\\u0041ijklmnop\\u{42}'", "abcdefghAijklmnopB");
+  CHECK_LITERAL("'abcdefgh\\\nijklmnop'", "abcdefghijklmnop");
+
+  // The other quote doesn't end the literal.
+  CHECK_LITERAL("\"abc'defghijk'lmnopq\"", "abc'defghijk'lmnopq");
+  CHECK_LITERAL("'abc\"defghijk\"lmnopq'", "abc\"defghijk\"lmnopq");
+
+  // Non-ASCII code units.
+  CHECK_LITERAL("'abcdefg\u00e9hijklmno\u3042pqrstuvwxyz'",
+                "abcdefg\u00e9hijklmno\u3042pqrstuvwxyz");
+  CHECK_LITERAL("'\U0001F600abcdefghijklmnop'", "\U0001F600abcdefghijklmnop");
+
+  // Template literals also stop at '$', and keep raw line breaks.
+  CHECK_LITERAL("`abcdefgh$ijklmnop${1 + 1}qrstuvwx`",
+                "abcdefgh$ijklmnop2qrstuvwx");
+  CHECK_LITERAL("`abcdefgh\nijklmnop\r\nqrstuvwx`",
+                "abcdefgh\nijklmnop\nqrstuvwx");
+  CHECK_LITERAL("`abcdefgh'ijklmnop\"qrstuvwx\\`yz`",
+                "abcdefgh'ijklmnop\"qrstuvwx`yz");
+
+  return true;
+}
+
+template <size_t N, size_t M, size_t L>
+bool checkLiteral(const char (&utf8)[N], const char16_t (&utf16)[M],
+                  const char16_t (&expected)[L]) {
+  JS::RootedString expectedStr(cx, JS_NewUCStringCopyN(cx, expected, L - 1));
+  CHECK(expectedStr);
+
+  JS::CompileOptions options(cx);
+  options.setFileAndLine(__FILE__, __LINE__);
+
+  JS::SourceText<mozilla::Utf8Unit> utf8Buf;
+  CHECK(utf8Buf.init(cx, utf8, N - 1, JS::SourceOwnership::Borrowed));
+  JS::RootedValue rval(cx);
+  CHECK(JS::EvaluateDontInflate(cx, options, utf8Buf, &rval));
+  CHECK(checkString(rval, expectedStr));
+
+  JS::SourceText<char16_t> utf16Buf;
+  CHECK(utf16Buf.init(cx, utf16, M - 1, JS::SourceOwnership::Borrowed));
+  CHECK(JS::Evaluate(cx, options, utf16Buf, &rval));
+  CHECK(checkString(rval, expectedStr));
+
+  return true;
+}
+
+bool checkString(JS::HandleValue rval, JS::HandleString expected) {
+  CHECK(rval.isString());
+  int32_t result;
+  CHECK(JS_CompareStrings(cx, rval.toString(), expected, &result));
+  CHECK_EQUAL(result, 0);
+  return true;
+}
+END_TEST(testTokenStreamLiterals)
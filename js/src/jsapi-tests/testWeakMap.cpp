@@ -243,3 +243,42 @@ bool checkSize(JS::HandleObject map, uint32_t expected) {
   return true;
 }
 END_TEST(testWeakMap_keyDelegates)
+
+// Build a long ephemeron chain spread over many WeakMaps, inserted so that
+// discovering each value requires the key found by the previous map. Marking
+// must keep the whole chain alive.
+BEGIN_TEST(testWeakMap_longEphemeronChain) {
+  JS::RootedValue result(cx);
+  EXEC(
+      "var chainLength = 2000;"
+      "var maps = [];"
+      "for (var i = 0; i < chainLength; i++) {"
+      "  maps.push(new WeakMap());"
+      "}"
+      "var head = {};"
+      "var key = head;"
+      "for (var i = chainLength - 1; i >= 0; i--) {"
+      "  var value = {};"
+      "  maps[i].set(key, value);"
+      "  key = value;"
+      "}"
+      "key = null; value = null;");
+
+  JS_GC(cx);
+
+  EVAL(
+      "var count = 0;"
+      "var key = head;"
+      "for (var i = chainLength - 1; i >= 0; i--) {"
+      "  key = maps[i].get(key);"
+      "  if (!key) break;"
+      "  count++;"
+      "}"
+      "count;",
+      &result);
+  CHECK(result.isInt32());
+  CHECK_EQUAL(result.toInt32(), 2000);
+
+  return true;
+}
+END_TEST(testWeakMap_longEphemeronChain)
@@ -3456,6 +3456,7 @@ void JS::TransitiveCompileOptions::copyPODTransitiveOptions(
   hasIntroductionInfo = rhs.hasIntroductionInfo;
   hideScriptFromDebugger = rhs.hideScriptFromDebugger;
   fieldsEnabledOption = rhs.fieldsEnabledOption;
+  tryRustFrontend = rhs.tryRustFrontend;
 };
 
 void JS::ReadOnlyCompileOptions::copyPODNonTransitiveOptions(
@@ -3466,9 +3467,19 @@ void JS::ReadOnlyCompileOptions::copyPODNonTransitiveOptions(
   isRunOnce = rhs.isRunOnce;
   noScriptRval = rhs.noScriptRval;
   nonSyntacticScope = rhs.nonSyntacticScope;
+  speculativeOffThread = rhs.speculativeOffThread;
+  eagerFunctionOffsets = rhs.eagerFunctionOffsets;
+  eagerFunctionOffsetsLength = rhs.eagerFunctionOffsetsLength;
   skipFilenameValidation_ = rhs.skipFilenameValidation_;
 }
 
+bool JS::ReadOnlyCompileOptions::isEagerFunction(
+    uint32_t toStringStart) const {
+  return std::binary_search(eagerFunctionOffsets,
+                            eagerFunctionOffsets + eagerFunctionOffsetsLength,
+                            toStringStart);
+}
+
 JS::OwningCompileOptions::OwningCompileOptions(JSContext* cx)
     : ReadOnlyCompileOptions(),
       elementRoot(cx),
@@ -3481,10 +3492,13 @@ void JS::OwningCompileOptions::release() {
   js_free(const_cast<char*>(filename_));
   js_free(const_cast<char16_t*>(sourceMapURL_));
   js_free(const_cast<char*>(introducerFilename_));
+  js_free(const_cast<uint32_t*>(eagerFunctionOffsets));
 
   filename_ = nullptr;
   sourceMapURL_ = nullptr;
   introducerFilename_ = nullptr;
+  eagerFunctionOffsets = nullptr;
+  eagerFunctionOffsetsLength = 0;
 }
 
 JS::OwningCompileOptions::~OwningCompileOptions() { release(); }
@@ -3492,7 +3506,8 @@ JS::OwningCompileOptions::~OwningCompileOptions() { release(); }
 size_t JS::OwningCompileOptions::sizeOfExcludingThis(
     mozilla::MallocSizeOf mallocSizeOf) const {
   return mallocSizeOf(filename_) + mallocSizeOf(sourceMapURL_) +
-         mallocSizeOf(introducerFilename_);
+         mallocSizeOf(introducerFilename_) +
+         mallocSizeOf(eagerFunctionOffsets);
 }
 
 bool JS::OwningCompileOptions::copy(JSContext* cx,
@@ -3503,6 +3518,10 @@ bool JS::OwningCompileOptions::copy(JSContext* cx,
   copyPODTransitiveOptions(rhs);
   copyPODNonTransitiveOptions(rhs);
 
+  // These still belong to |rhs|. Our own copy is made below.
+  eagerFunctionOffsets = nullptr;
+  eagerFunctionOffsetsLength = 0;
+
   elementRoot = rhs.element();
   elementAttributeNameRoot = rhs.elementAttributeName();
   introductionScriptRoot = rhs.introductionScript();
@@ -3530,6 +3549,17 @@ bool JS::OwningCompileOptions::copy(JSContext* cx,
     }
   }
 
+  if (rhs.eagerFunctionOffsetsLength) {
+    size_t length = rhs.eagerFunctionOffsetsLength;
+    uint32_t* offsets = cx->pod_malloc<uint32_t>(length);
+    if (!offsets) {
+      return false;
+    }
+    PodCopy(offsets, rhs.eagerFunctionOffsets, length);
+    eagerFunctionOffsets = offsets;
+    eagerFunctionOffsetsLength = length;
+  }
+
   return true;
 }
 
@@ -3552,6 +3582,7 @@ JS::CompileOptions::CompileOptions(JSContext* cx)
   throwOnAsmJSValidationFailureOption =
       cx->options().throwOnAsmJSValidationFailure();
   fieldsEnabledOption = cx->realm()->creationOptions().getFieldsEnabled();
+  tryRustFrontend = cx->options().tryRustFrontend();
 
   // Certain modes of operation force strict-mode in general.
   forceStrictMode_ = cx->options().strictMode();
@@ -5342,6 +5373,27 @@ JS_PUBLIC_API void JS_SetGlobalJitCompilerOption(JSContext* cx,
       }
       jit::JitOptions.frequentBailoutThreshold = value;
       break;
+    case JSJITCOMPILER_ION_INVALIDATION_THRESHOLD:
+      if (value == uint32_t(-1)) {
+        jit::DefaultJitOptions defaultValues;
+        value = defaultValues.ionInvalidationThreshold;
+      }
+      jit::JitOptions.ionInvalidationThreshold = value;
+      break;
+    case JSJITCOMPILER_ION_EAGER_RECOMPILE_THRESHOLD:
+      if (value == uint32_t(-1)) {
+        jit::DefaultJitOptions defaultValues;
+        value = defaultValues.ionEagerRecompileThreshold;
+      }
+      jit::JitOptions.ionEagerRecompileThreshold = value;
+      break;
+    case JSJITCOMPILER_ION_COMPILE_TIME_BUDGET:
+      if (value == uint32_t(-1)) {
+        jit::DefaultJitOptions defaultValues;
+        value = defaultValues.ionCompileTimeBudgetMs;
+      }
+      jit::JitOptions.ionCompileTimeBudgetMs = value;
+      break;
     case JSJITCOMPILER_BASELINE_INTERPRETER_ENABLE:
       if (value == 1) {
         jit::JitOptions.baselineInterpreter = true;
@@ -5467,6 +5519,15 @@ JS_PUBLIC_API bool JS_GetGlobalJitCompilerOption(JSContext* cx,
     case JSJITCOMPILER_ION_FREQUENT_BAILOUT_THRESHOLD:
       *valueOut = jit::JitOptions.frequentBailoutThreshold;
       break;
+    case JSJITCOMPILER_ION_INVALIDATION_THRESHOLD:
+      *valueOut = jit::JitOptions.ionInvalidationThreshold;
+      break;
+    case JSJITCOMPILER_ION_EAGER_RECOMPILE_THRESHOLD:
+      *valueOut = jit::JitOptions.ionEagerRecompileThreshold;
+      break;
+    case JSJITCOMPILER_ION_COMPILE_TIME_BUDGET:
+      *valueOut = jit::JitOptions.ionCompileTimeBudgetMs;
+      break;
     case JSJITCOMPILER_BASELINE_INTERPRETER_ENABLE:
       *valueOut = jit::JitOptions.baselineInterpreter;
       break;
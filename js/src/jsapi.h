@@ -2753,6 +2753,40 @@ extern JS_PUBLIC_API void JS_SetParallelParsingEnabled(JSContext* cx,
 extern JS_PUBLIC_API void JS_SetOffthreadIonCompilationEnabled(JSContext* cx,
                                                                bool enabled);
 
+namespace JS {
+
+using HelperThreadTaskCallback = void (*)();
+
+/**
+ * Have the embedder's own thread pool run helper thread tasks (off-thread
+ * parsing, Ion and wasm compilation, source compression, parallel GC work)
+ * instead of threads started by the engine. At most |threadCount| tasks run
+ * at once. This must be called after JS_Init and before the first JSContext
+ * is created.
+ *
+ * |callback| is called, on any thread, whenever a task may have become
+ * runnable. It is never called with the helper thread lock held, but other
+ * engine locks may be held, so it must not call into the engine: it should
+ * only arrange for JS::RunHelperThreadTask to be called once, soon, on a pool
+ * thread with a stack of at least 2 MB. The engine chooses which task to run,
+ * by its own priorities, when that call happens.
+ *
+ * Pool threads are registered with the profiler callbacks passed to
+ * JS::SetProfilingThreadCallbacks while they run a task.
+ *
+ * The pool must stop calling JS::RunHelperThreadTask before JS_ShutDown.
+ */
+extern JS_PUBLIC_API bool SetHelperThreadTaskCallback(
+    HelperThreadTaskCallback callback, size_t threadCount);
+
+/**
+ * Run the highest priority runnable helper thread task, if any, on the
+ * current thread. See SetHelperThreadTaskCallback.
+ */
+extern JS_PUBLIC_API void RunHelperThreadTask();
+
+}  // namespace JS
+
 // clang-format off
 #define JIT_COMPILER_OPTIONS(Register) \
   Register(BASELINE_INTERPRETER_WARMUP_TRIGGER, "blinterp.warmup.trigger") \
@@ -2764,6 +2798,9 @@ extern JS_PUBLIC_API void JS_SetOffthreadIonCompilationEnabled(JSContext* cx,
   Register(ION_ENABLE, "ion.enable") \
   Register(ION_CHECK_RANGE_ANALYSIS, "ion.check-range-analysis") \
   Register(ION_FREQUENT_BAILOUT_THRESHOLD, "ion.frequent-bailout-threshold") \
+  Register(ION_INVALIDATION_THRESHOLD, "ion.invalidation-threshold") \
+  Register(ION_EAGER_RECOMPILE_THRESHOLD, "ion.eager-recompile-threshold") \
+  Register(ION_COMPILE_TIME_BUDGET, "ion.compile-time-budget-ms") \
   Register(BASELINE_INTERPRETER_ENABLE, "blinterp.enable") \
   Register(BASELINE_ENABLE, "baseline.enable") \
   Register(OFFTHREAD_COMPILATION_ENABLE, "offthread-compilation.enable")  \
@@ -11,6 +11,7 @@
 #include "mozilla/PodOperations.h"
 #include "mozilla/TimeStamp.h"
 
+#include <algorithm>
 #include <stdint.h>
 
 #include "builtin/BigInt.h"
@@ -505,6 +506,44 @@ void js::SetPreserveWrapperCallback(JSContext* cx,
   cx->runtime()->preserveWrapperCallback = callback;
 }
 
+void js::SetSourceCompressionCodec(JSContext* cx,
+                                   SourceCompressionCodec codec) {
+  cx->runtime()->sourceCompressionCodec = codec;
+}
+
+void js::SetRecordDelazifications(JSContext* cx, bool record) {
+  JSRuntime* rt = cx->runtime();
+  if (rt->recordDelazifications == record) {
+    return;
+  }
+  rt->recordDelazifications = record;
+  if (record) {
+    return;
+  }
+
+  // Discard what was recorded. Any source without a script left has already
+  // been freed along with its record.
+  for (ZonesIter zone(rt, SkipAtoms); !zone.done(); zone.next()) {
+    for (auto script = zone->cellIter<JSScript>(); !script.done();
+         script.next()) {
+      script->scriptSource()->clearDelazifiedFunctions();
+    }
+    for (auto lazy = zone->cellIter<LazyScript>(); !lazy.done(); lazy.next()) {
+      lazy->scriptSource()->clearDelazifiedFunctions();
+    }
+  }
+}
+
+bool js::GetDelazifiedFunctionOffsets(
+    JSContext* cx, JS::HandleScript script,
+    js::Vector<uint32_t, 0, js::SystemAllocPolicy>* offsets) {
+  if (!offsets->appendAll(script->scriptSource()->delazifiedFunctions())) {
+    ReportOutOfMemory(cx);
+    return false;
+  }
+  return true;
+}
+
 JS_FRIEND_API unsigned JS_PCToLineNumber(JSScript* script, jsbytecode* pc,
                                          unsigned* columnp) {
   return PCToLineNumber(script, pc, columnp);
@@ -24,6 +24,7 @@
 #include "js/StableStringChars.h"
 #include "js/TypeDecls.h"
 #include "js/Utility.h"
+#include "js/Vector.h"
 
 #ifndef JS_STACK_GROWTH_DIRECTION
 #  ifdef __hppa
@@ -939,6 +940,56 @@ JS_FRIEND_API bool StringIsArrayIndex(const char16_t* str, uint32_t length,
 JS_FRIEND_API void SetPreserveWrapperCallback(JSContext* cx,
                                               PreserveWrapperCallback callback);
 
+/**
+ * The codec used to compress the source text of scripts retained for
+ * Function.prototype.toString and delazification. Zlib gives better ratios;
+ * LZ4 is considerably cheaper to decompress on the main thread. Both codecs
+ * compress in chunks of Compressor::CHUNK_SIZE bytes, so any chunk can be
+ * decompressed independently of the others.
+ */
+enum class SourceCompressionCodec : uint8_t { Zlib, LZ4 };
+
+/**
+ * Select the codec used for sources compressed from now on in |cx|'s runtime.
+ * Sources that are already compressed record their codec and are unaffected.
+ */
+JS_FRIEND_API void SetSourceCompressionCodec(JSContext* cx,
+                                             SourceCompressionCodec codec);
+
+/**
+ * How long off-thread parse and source compression tasks have waited in the
+ * helper thread worklists before a thread started them, over the lifetime of
+ * the process.
+ */
+struct HelperThreadQueueWaitStats {
+  uint64_t parseTasks = 0;
+  double parseTotalMs = 0;
+  double parseMaxMs = 0;
+
+  uint64_t compressionTasks = 0;
+  double compressionTotalMs = 0;
+  double compressionMaxMs = 0;
+};
+
+JS_FRIEND_API void GetHelperThreadQueueWaitStats(
+    HelperThreadQueueWaitStats* stats);
+
+/**
+ * Start or stop recording, for every script source, which of its functions
+ * get delazified in |cx|'s runtime. Stopping discards everything recorded.
+ */
+JS_FRIEND_API void SetRecordDelazifications(JSContext* cx, bool record);
+
+/**
+ * Store in |offsets| the toStringStart offsets, sorted and without duplicates,
+ * of the functions of |script|'s source recorded as delazified. Passing them
+ * to JS::CompileOptions::setEagerFunctionOffsets when compiling the same
+ * source again compiles those functions upfront. Returns false on OOM.
+ */
+JS_FRIEND_API bool GetDelazifiedFunctionOffsets(
+    JSContext* cx, JS::HandleScript script,
+    js::Vector<uint32_t, 0, js::SystemAllocPolicy>* offsets);
+
 JS_FRIEND_API bool IsObjectInContextCompartment(JSObject* obj,
                                                 const JSContext* cx);
 
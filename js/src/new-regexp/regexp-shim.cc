@@ -60,7 +60,7 @@ bool FLAG_harmony_regexp_sequence = false;
 bool FLAG_regexp_interpret_all = false;
 bool FLAG_regexp_mode_modifiers = false;
 bool FLAG_regexp_optimization = false;
-bool FLAG_regexp_peephole_optimization = false;
+bool FLAG_regexp_peephole_optimization = true;
 bool FLAG_regexp_possessive_quantifier = false;
 bool FLAG_regexp_tier_up = false;
 bool FLAG_trace_regexp_assembler = false;
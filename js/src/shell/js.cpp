@@ -5362,7 +5362,28 @@ static bool Parse(JSContext* cx, unsigned argc, Value* vp) {
     }
   }
 
-  JSString* scriptContents = args[0].toString();
+  RootedString scriptContents(cx, args[0].toString());
+
+  if (rustFrontend) {
+    // The Rust parser consumes UTF-8, for both Latin-1 and two-byte strings.
+    UniqueChars utf8 = JS_EncodeStringToUTF8(cx, scriptContents);
+    if (!utf8) {
+      return false;
+    }
+    auto bytes = reinterpret_cast<const uint8_t*>(utf8.get());
+    size_t utf8Length = strlen(utf8.get());
+    if (goal == frontend::ParseGoal::Script) {
+      if (!RustParseScript(cx, bytes, utf8Length)) {
+        return false;
+      }
+    } else {
+      if (!RustParseModule(cx, bytes, utf8Length)) {
+        return false;
+      }
+    }
+    args.rval().setUndefined();
+    return true;
+  }
 
   AutoStableStringChars stableChars(cx);
   if (!stableChars.init(cx, scriptContents)) {
@@ -5370,24 +5391,6 @@ static bool Parse(JSContext* cx, unsigned argc, Value* vp) {
   }
 
   size_t length = scriptContents->length();
-  if (rustFrontend) {
-    if (stableChars.isLatin1()) {
-      const Latin1Char* chars = stableChars.latin1Range().begin().get();
-      if (goal == frontend::ParseGoal::Script) {
-        if (!RustParseScript(cx, chars, length)) {
-          return false;
-        }
-      } else {
-        if (!RustParseModule(cx, chars, length)) {
-          return false;
-        }
-      }
-      args.rval().setUndefined();
-      return true;
-    }
-    JS_ReportErrorASCII(cx, "Rust parser does not support two-byte chars yet");
-    return false;
-  }
 
   CompileOptions options(cx);
   options.setIntroductionType("js shell parse").setFileAndLine("<string>", 1);
@@ -5427,6 +5430,161 @@ static bool Parse(JSContext* cx, unsigned argc, Value* vp) {
   return true;
 }
 
+// Compile |srcBuf| as a global script with either the C++ or the Rust
+// frontend, without falling back from one to the other.
+static bool CompileForFrontendComparison(JSContext* cx,
+                                         JS::SourceText<Utf8Unit>& srcBuf,
+                                         bool rustFrontend,
+                                         MutableHandleScript script,
+                                         bool* unimplemented,
+                                         double* elapsedMs) {
+  using namespace js::frontend;
+
+  CompileOptions options(cx);
+  options.setFileAndLine("<compareFrontends>", 1)
+      .setIntroductionType("js shell compareFrontends")
+      .setNoScriptRval(true);
+  options.tryRustFrontend = false;
+
+  *unimplemented = false;
+
+  // Time a full parse, not a hit in the Rust frontend's compile cache.
+  if (rustFrontend) {
+    Jsparagus::clearCompileCache();
+  }
+
+  TimeStamp start = TimeStamp::Now();
+  if (rustFrontend) {
+    LifoAllocScope allocScope(&cx->tempLifoAlloc());
+    CompilationInfo compilationInfo(cx, allocScope, options);
+    if (!compilationInfo.init(cx)) {
+      return false;
+    }
+    script.set(Jsparagus::compileGlobalScript(
+        compilationInfo, srcBuf, unimplemented,
+        /* countFallbacks = */ false));
+  } else {
+    script.set(JS::CompileDontInflate(cx, options, srcBuf));
+  }
+  *elapsedMs = (TimeStamp::Now() - start).ToMilliseconds();
+
+  return script || *unimplemented;
+}
+
+static bool DefineFrontendComparisonResult(JSContext* cx, HandleObject result,
+                                           const char* name,
+                                           HandleScript script,
+                                           double elapsedMs) {
+  RootedObject info(cx, JS_NewPlainObject(cx));
+  if (!info) {
+    return false;
+  }
+
+  RootedValue val(cx, DoubleValue(elapsedMs));
+  if (!JS_DefineProperty(cx, info, "time", val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+  val.setNumber(script->length());
+  if (!JS_DefineProperty(cx, info, "bytecodeLength", val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+  val.setNumber(script->natoms());
+  if (!JS_DefineProperty(cx, info, "atoms", val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+  val.setNumber(uint32_t(script->gcthings().size()));
+  if (!JS_DefineProperty(cx, info, "gcthings", val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  RootedValue infoVal(cx, ObjectValue(*info));
+  return JS_DefineProperty(cx, result, name, infoVal, JSPROP_ENUMERATE);
+}
+
+static bool CompareFrontends(JSContext* cx, unsigned argc, Value* vp) {
+  CallArgs args = CallArgsFromVp(argc, vp);
+
+  if (!args.requireAtLeast(cx, "compareFrontends", 1)) {
+    return false;
+  }
+  if (!args[0].isString()) {
+    const char* typeName = InformalValueTypeName(args[0]);
+    JS_ReportErrorASCII(cx, "expected string to compile, got %s", typeName);
+    return false;
+  }
+
+  RootedString code(cx, args[0].toString());
+  UniqueChars utf8 = JS_EncodeStringToUTF8(cx, code);
+  if (!utf8) {
+    return false;
+  }
+
+  JS::SourceText<Utf8Unit> srcBuf;
+  if (!srcBuf.init(cx, utf8.get(), strlen(utf8.get()),
+                   JS::SourceOwnership::Borrowed)) {
+    return false;
+  }
+
+  RootedObject result(cx, JS_NewPlainObject(cx));
+  if (!result) {
+    return false;
+  }
+
+  RootedScript cppScript(cx);
+  bool unimplemented;
+  double cppMs;
+  if (!CompileForFrontendComparison(cx, srcBuf, /* rustFrontend = */ false,
+                                    &cppScript, &unimplemented, &cppMs)) {
+    return false;
+  }
+  MOZ_ASSERT(cppScript);
+  if (!DefineFrontendComparisonResult(cx, result, "cpp", cppScript, cppMs)) {
+    return false;
+  }
+
+  RootedScript rustScript(cx);
+  double rustMs;
+  if (!CompileForFrontendComparison(cx, srcBuf, /* rustFrontend = */ true,
+                                    &rustScript, &unimplemented, &rustMs)) {
+    return false;
+  }
+
+  RootedValue val(cx);
+  if (unimplemented) {
+    val.setNull();
+    if (!JS_DefineProperty(cx, result, "rust", val, JSPROP_ENUMERATE)) {
+      return false;
+    }
+    args.rval().setObject(*result);
+    return true;
+  }
+
+  if (!DefineFrontendComparisonResult(cx, result, "rust", rustScript,
+                                      rustMs)) {
+    return false;
+  }
+
+#if defined(DEBUG) || defined(JS_JITSPEW)
+  Sprinter cppDis(cx);
+  Sprinter rustDis(cx);
+  if (!cppDis.init() || !rustDis.init()) {
+    return false;
+  }
+  if (!Disassemble(cx, cppScript, /* lines = */ false, &cppDis) ||
+      !Disassemble(cx, rustScript, /* lines = */ false, &rustDis)) {
+    return false;
+  }
+  val.setBoolean(strcmp(cppDis.string(), rustDis.string()) == 0);
+  if (!JS_DefineProperty(cx, result, "disassemblyMatches", val,
+                         JSPROP_ENUMERATE)) {
+    return false;
+  }
+#endif
+
+  args.rval().setObject(*result);
+  return true;
+}
+
 static bool SyntaxParse(JSContext* cx, unsigned argc, Value* vp) {
   using namespace js::frontend;
 
@@ -8899,6 +9057,15 @@ JS_FN_HELP("parseBin", BinParse, 1, 0,
 "parse(code)",
 "  Parses a string, potentially throwing."),
 
+    JS_FN_HELP("compareFrontends", CompareFrontends, 1, 0,
+"compareFrontends(code)",
+"  Compile |code| as a global script with the C++ frontend and then with the\n"
+"  Rust frontend, without fallback.  Returns an object with `cpp` and `rust`\n"
+"  properties describing each compilation ({time, bytecodeLength, atoms,\n"
+"  gcthings}), with `rust` being null if the Rust frontend doesn't support\n"
+"  the code.  In DEBUG and JS_JITSPEW builds, `disassemblyMatches` tells\n"
+"  whether both scripts disassemble identically."),
+
     JS_FN_HELP("syntaxParse", SyntaxParse, 1, 0,
 "syntaxParse(code)",
 "  Check the syntax of a string, returning success value"),
@@ -7,6 +7,8 @@
 #ifndef vm_Caches_h
 #define vm_Caches_h
 
+#include "mozilla/HashFunctions.h"
+
 #include <new>
 
 #include "jsmath.h"
@@ -223,12 +225,64 @@ class NewObjectCache {
   }
 };
 
+/*
+ * Direct-mapped cache for the own data property lookups done by megamorphic
+ * property IC stubs. Entries map a (receiver shape, id) pair to the slot of
+ * the property and are only added for shapes that are not in dictionary mode,
+ * so the result is immutable for as long as the shape is alive.
+ *
+ * The cache is purged on every major GC so entries can't refer to shapes that
+ * have been finalized or moved.
+ */
+class MegamorphicCache {
+  struct Entry {
+    Shape* shape;
+    jsid id;
+    uint32_t slot;
+  };
+
+  static const size_t NumEntries = 256;
+  Entry entries_[NumEntries];
+
+  static size_t entryIndex(Shape* shape, jsid id) {
+    HashNumber hash = mozilla::HashGeneric(shape, JSID_BITS(id));
+    return hash % NumEntries;
+  }
+
+ public:
+  MegamorphicCache() : entries_{} {}
+
+  void purge() {
+    for (Entry& entry : entries_) {
+      entry.shape = nullptr;
+    }
+  }
+
+  bool lookup(Shape* shape, jsid id, uint32_t* slot) const {
+    const Entry& entry = entries_[entryIndex(shape, id)];
+    if (entry.shape != shape || entry.id != id) {
+      return false;
+    }
+    *slot = entry.slot;
+    return true;
+  }
+
+  void fill(Shape* shape, jsid id, uint32_t slot) {
+    MOZ_ASSERT(!shape->inDictionary());
+    Entry& entry = entries_[entryIndex(shape, id)];
+    entry.shape = shape;
+    entry.id = id;
+    entry.slot = slot;
+  }
+};
+
 class RuntimeCaches {
  public:
   js::GSNCache gsnCache;
   js::NewObjectCache newObjectCache;
   js::UncompressedSourceCache uncompressedSourceCache;
   js::EvalCache evalCache;
+  js::MegamorphicCache megamorphicCache;
 
   void purgeForMinorGC(JSRuntime* rt) {
     newObjectCache.clearNurseryObjects(rt);
@@ -238,12 +292,14 @@ class RuntimeCaches {
   void purgeForCompaction() {
     newObjectCache.purge();
     evalCache.clear();
+    megamorphicCache.purge();
   }
 
+  // The uncompressed source cache is bounded and only purged by shrinking
+  // GCs, see GCRuntime::purgeRuntime.
   void purge() {
     purgeForCompaction();
     gsnCache.purge();
-    uncompressedSourceCache.purge();
   }
 };
 
@@ -200,6 +200,43 @@ JSScript* JS::CompileForNonSyntacticScopeDontInflate(
   return CompileSourceBuffer(cx, options, srcBuf);
 }
 
+template <typename Unit>
+static bool CheckSourceBufferSyntax(JSContext* cx,
+                                    const ReadOnlyCompileOptions& options,
+                                    SourceText<Unit>& srcBuf) {
+  MOZ_ASSERT(!cx->zone()->isAtomsZone());
+  AssertHeapIsIdle();
+  CHECK_THREAD(cx);
+
+  using frontend::CompilationInfo;
+  using frontend::FullParseHandler;
+  using frontend::Parser;
+
+  LifoAllocScope allocScope(&cx->tempLifoAlloc());
+  CompilationInfo compilationInfo(cx, allocScope, options);
+  if (!compilationInfo.init(cx)) {
+    return false;
+  }
+
+  // Only parse: nothing is emitted, so there's no point in folding constants.
+  Parser<FullParseHandler, Unit> parser(cx, options, srcBuf.units(),
+                                        srcBuf.length(),
+                                        /* foldConstants = */ false,
+                                        compilationInfo, nullptr, nullptr,
+                                        compilationInfo.sourceObject);
+  return parser.checkOptions() && parser.parse();
+}
+
+bool JS::CheckScriptSyntax(JSContext* cx, const ReadOnlyCompileOptions& options,
+                           SourceText<char16_t>& srcBuf) {
+  return CheckSourceBufferSyntax(cx, options, srcBuf);
+}
+
+bool JS::CheckScriptSyntax(JSContext* cx, const ReadOnlyCompileOptions& options,
+                           SourceText<Utf8Unit>& srcBuf) {
+  return CheckSourceBufferSyntax(cx, options, srcBuf);
+}
+
 JS_PUBLIC_API bool JS_Utf8BufferIsCompilableUnit(JSContext* cx,
                                                  HandleObject obj,
                                                  const char* utf8,
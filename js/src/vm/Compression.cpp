@@ -6,25 +6,34 @@
 
 #include "vm/Compression.h"
 
+#include "mozilla/Compression.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/MemoryChecking.h"
 #include "mozilla/PodOperations.h"
 #include "mozilla/ScopeExit.h"
 
+#include "jsfriendapi.h"  // js::SourceCompressionCodec
+
 #include "js/Utility.h"
 #include "util/Memory.h"
 
 using namespace js;
 
+using mozilla::Compression::LZ4;
+
 static void* zlib_alloc(void* cx, uInt items, uInt size) {
   return js_calloc(items, size);
 }
 
 static void zlib_free(void* cx, void* addr) { js_free(addr); }
 
-Compressor::Compressor(const unsigned char* inp, size_t inplen)
+Compressor::Compressor(const unsigned char* inp, size_t inplen,
+                       SourceCompressionCodec codec)
     : inp(inp),
       inplen(inplen),
+      codec(codec),
+      out(nullptr),
+      outlen(0),
       initialized(false),
       finished(false),
       currentChunkSize(0),
@@ -51,7 +60,7 @@ Compressor::Compressor(const unsigned char* inp, size_t inplen)
 }
 
 Compressor::~Compressor() {
-  if (initialized) {
+  if (initialized && codec == SourceCompressionCodec::Zlib) {
     int ret = deflateEnd(&zs);
     if (ret != Z_OK) {
       // If we finished early, we can get a Z_DATA_ERROR.
@@ -70,6 +79,11 @@ bool Compressor::init() {
   if (inplen >= UINT32_MAX) {
     return false;
   }
+  if (codec == SourceCompressionCodec::LZ4) {
+    // LZ4 keeps no state between chunks.
+    initialized = true;
+    return true;
+  }
   // zlib is slow and we'd rather be done compression sooner
   // even if it means decompression is slower which penalizes
   // Function.toString()
@@ -85,11 +99,49 @@ bool Compressor::init() {
 
 void Compressor::setOutput(unsigned char* out, size_t outlen) {
   MOZ_ASSERT(outlen > outbytes);
+  this->out = out;
+  this->outlen = outlen;
   zs.next_out = out + outbytes;
   zs.avail_out = outlen - outbytes;
 }
 
 Compressor::Status Compressor::compressMore() {
+  if (codec == SourceCompressionCodec::LZ4) {
+    return compressMoreLZ4();
+  }
+  return compressMoreZlib();
+}
+
+Compressor::Status Compressor::compressMoreLZ4() {
+  MOZ_ASSERT(out);
+
+  // Each call compresses one whole chunk, so every chunk is an independent
+  // LZ4 block that can be decompressed on its own.
+  size_t chunk = chunkOffsets.length();
+  size_t chunkStart = chunk * CHUNK_SIZE;
+  MOZ_ASSERT(chunkStart < inplen);
+  size_t chunkBytes = chunkSize(inplen, chunk);
+
+  size_t written = LZ4::compressLimitedOutput(
+      reinterpret_cast<const char*>(inp + chunkStart), chunkBytes,
+      reinterpret_cast<char*>(out + outbytes), outlen - outbytes);
+  if (written == 0) {
+    // Nothing is kept from the failed attempt: once the caller provides a
+    // bigger buffer, this chunk is compressed again from the start.
+    return MOREOUTPUT;
+  }
+
+  outbytes += written;
+  if (!chunkOffsets.append(outbytes)) {
+    return OOM;
+  }
+
+  bool done = chunkStart + chunkBytes == inplen;
+  MOZ_ASSERT_IF(done, chunkOffsets.length() == (inplen - 1) / CHUNK_SIZE + 1);
+  return done ? DONE : CONTINUE;
+}
+
+Compressor::Status Compressor::compressMoreZlib() {
   MOZ_ASSERT(zs.next_out);
   uInt left = inplen - (zs.next_in - inp);
   if (left <= MAX_INPUT_SIZE) {
@@ -155,6 +207,7 @@ void Compressor::finish(char* dest, size_t destBytes) {
   CompressedDataHeader* compressedHeader =
       reinterpret_cast<CompressedDataHeader*>(dest);
   compressedHeader->compressedBytes = outbytes;
+  compressedHeader->codec = uint32_t(codec);
 
   size_t outbytesAligned = AlignBytes(outbytes, sizeof(uint32_t));
 
@@ -218,6 +271,19 @@ bool js::DecompressStringChunk(const unsigned char* inp, size_t chunk,
   MOZ_ASSERT(compressedStart < compressedEnd);
   MOZ_ASSERT(compressedEnd <= compressedBytes);
 
+  if (SourceCompressionCodec(header->codec) == SourceCompressionCodec::LZ4) {
+    size_t decompressedBytes;
+    bool ok = LZ4::decompress(
+        reinterpret_cast<const char*>(inp + compressedStart),
+        compressedEnd - compressedStart, reinterpret_cast<char*>(out), outlen,
+        &decompressedBytes);
+    MOZ_RELEASE_ASSERT(ok);
+    MOZ_RELEASE_ASSERT(decompressedBytes == outlen);
+    return true;
+  }
+  MOZ_ASSERT(SourceCompressionCodec(header->codec) ==
+             SourceCompressionCodec::Zlib);
+
   bool lastChunk = compressedEnd == compressedBytes;
 
   // Mark the memory we pass to zlib as initialized for MSan.
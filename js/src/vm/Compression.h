@@ -16,8 +16,13 @@
 
 namespace js {
 
+enum class SourceCompressionCodec : uint8_t;
+
 struct CompressedDataHeader {
   uint32_t compressedBytes;
+
+  // The SourceCompressionCodec the chunks were compressed with.
+  uint32_t codec;
 };
 
 class Compressor {
@@ -34,6 +39,11 @@ class Compressor {
   const unsigned char* inp;
   size_t inplen;
   size_t outbytes;
+  SourceCompressionCodec codec;
+
+  // LZ4 compresses each chunk in one step, straight from |inp| to |out|.
+  unsigned char* out;
+  size_t outlen;
   bool initialized;
   bool finished;
 
@@ -48,12 +58,19 @@ class Compressor {
  public:
   enum Status { MOREOUTPUT, DONE, CONTINUE, OOM };
 
-  Compressor(const unsigned char* inp, size_t inplen);
+  Compressor(const unsigned char* inp, size_t inplen,
+             SourceCompressionCodec codec);
   ~Compressor();
   bool init();
   void setOutput(unsigned char* out, size_t outlen);
   /* Compress some of the input. Return true if it should be called again. */
   Status compressMore();
+
+ private:
+  Status compressMoreZlib();
+  Status compressMoreLZ4();
+
+ public:
   size_t sizeOfChunkOffsets() const {
     return chunkOffsets.length() * sizeof(chunkOffsets[0]);
   }
@@ -106,6 +123,7 @@ bool DecompressString(const unsigned char* inp, size_t inplen,
  * Decompress a single chunk of at most Compressor::CHUNK_SIZE bytes.
  * |chunk| is the chunk index. The caller must know the length of the output
  * (the uncompressed chunk) and allocate |out| to a string of that length.
+ * The codec is read from the CompressedDataHeader at the start of |inp|.
  */
 bool DecompressStringChunk(const unsigned char* inp, size_t chunk,
                            unsigned char* out, size_t outlen);
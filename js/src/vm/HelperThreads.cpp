@@ -8,11 +8,13 @@
 
 #include "mozilla/Maybe.h"
 #include "mozilla/ScopeExit.h"
+#include "mozilla/ThreadLocal.h"
 #include "mozilla/Unused.h"
 #include "mozilla/Utf8.h"  // mozilla::Utf8Unit
 
 #include <algorithm>
 
+#include "builtin/ModuleObject.h"
 #include "frontend/BytecodeCompilation.h"
 #include "jit/IonBuilder.h"
 #include "js/ContextOptions.h"  // JS::ContextOptions
@@ -39,6 +41,7 @@
 using namespace js;
 
 using mozilla::Maybe;
+using mozilla::Some;
 using mozilla::TimeDuration;
 using mozilla::TimeStamp;
 using mozilla::Unused;
@@ -63,8 +66,43 @@ GlobalHelperThreadState* gHelperThreadState = nullptr;
   HelperThread::AutoProfilerLabel PROFILER_RAII( \
       this, label, JS::ProfilingCategoryPair::categoryPair)
 
+// The slot whose task the current thread is running, when that thread was
+// provided by the embedder. See JS::SetHelperThreadTaskCallback.
+static MOZ_THREAD_LOCAL(HelperThread*) tlsDispatchedHelperThread;
+
+// Per-thread state for running helper thread tasks, set up both by the
+// engine's own threads and by the embedder's threads which run tasks through
+// JS::RunHelperThreadTask.
+class MOZ_RAII AutoHelperTaskThread {
+  // Helper threads are allowed to run differently during recording and
+  // replay, as compiled scripts and GCs are allowed to vary. Because of
+  // this, no recorded events at all should occur while on helper threads.
+  mozilla::recordreplay::AutoDisallowThreadEvents disallowThreadEvents_;
+
+  JS::AutoSuppressGCAnalysis nogc_;
+};
+
+static ProfilingStack* RegisterHelperThreadWithProfiler() {
+  if (mozilla::recordreplay::IsRecordingOrReplaying()) {
+    return nullptr;
+  }
+
+  // Note: To avoid dead locks, we should not hold on the helper thread lock
+  // while calling this function. This is safe because the registerThread field
+  // is a WriteOnceData<> type stored on the global helper tread state.
+  JS::RegisterThreadCallback callback = HelperThreadState().registerThread;
+  if (!callback) {
+    return nullptr;
+  }
+  return callback("JS Helper", reinterpret_cast<void*>(GetNativeStackBase()));
+}
+
 bool js::CreateHelperThreadsState() {
   MOZ_ASSERT(!gHelperThreadState);
+  if (!tlsDispatchedHelperThread.init()) {
+    return false;
+  }
+
   UniquePtr<GlobalHelperThreadState> helperThreadState =
       MakeUnique<GlobalHelperThreadState>();
   if (!helperThreadState) {
@@ -123,6 +161,56 @@ bool js::SetFakeCPUCount(size_t count) {
   return true;
 }
 
+void js::GetHelperThreadQueueWaitStats(HelperThreadQueueWaitStats* stats) {
+  AutoLockHelperThreadState lock;
+
+  const HelperTaskQueueWaitStats& parse =
+      HelperThreadState().parseQueueWaitStats(lock);
+  stats->parseTasks = parse.count;
+  stats->parseTotalMs = parse.total.ToMilliseconds();
+  stats->parseMaxMs = parse.max.ToMilliseconds();
+
+  const HelperTaskQueueWaitStats& compression =
+      HelperThreadState().compressionQueueWaitStats(lock);
+  stats->compressionTasks = compression.count;
+  stats->compressionTotalMs = compression.total.ToMilliseconds();
+  stats->compressionMaxMs = compression.max.ToMilliseconds();
+}
+
+bool JS::SetHelperThreadTaskCallback(HelperThreadTaskCallback callback,
+                                     size_t threadCount) {
+  MOZ_ASSERT(callback);
+  MOZ_ASSERT(threadCount > 0);
+
+  // This must be called before the threads have been initialized.
+  MOZ_ASSERT(!HelperThreadState().threads);
+
+  HelperThreadState().dispatchTaskCallback = callback;
+  HelperThreadState().threadCount = threadCount;
+  return HelperThreadState().ensureContextListForThreadCount();
+}
+
+void JS::RunHelperThreadTask() {
+  MOZ_ASSERT(CanUseExtraThreads());
+
+  // The embedder's threads are only registered with the profiler while they
+  // run a task, as they may be used for other work in between.
+  AutoHelperTaskThread helperTaskThread;
+  ProfilingStack* profilingStack = RegisterHelperThreadWithProfiler();
+
+  {
+    AutoLockHelperThreadState lock;
+    HelperThreadState().runDispatchedTask(lock, profilingStack);
+  }
+
+  if (profilingStack) {
+    if (JS::UnregisterThreadCallback callback =
+            HelperThreadState().unregisterThread) {
+      callback();
+    }
+  }
+}
+
 void JS::SetProfilingThreadCallbacks(
     JS::RegisterThreadCallback registerThread,
     JS::UnregisterThreadCallback unregisterThread) {
@@ -517,6 +605,7 @@ bool ParseTask::init(JSContext* cx, const ReadOnlyCompileOptions& options,
 
 void ParseTask::activate(JSRuntime* rt) {
   rt->setUsedByHelperThread(parseGlobal->zone());
+  queuedTime = TimeStamp::Now();
 }
 
 ParseTask::~ParseTask() = default;
@@ -640,6 +729,9 @@ void ModuleParseTask<Unit>::parse(JSContext* cx) {
   ModuleObject* module =
       frontend::ParseModule(cx, options, data, &sourceObject.get());
   if (module) {
+    if (!recordModuleRequests(cx, module)) {
+      return;
+    }
     scripts.infallibleAppend(module->script());
     if (sourceObject) {
       sourceObjects.infallibleAppend(sourceObject);
@@ -647,6 +739,35 @@ void ModuleParseTask<Unit>::parse(JSContext* cx) {
   }
 }
 
+bool ParseTask::recordModuleRequests(JSContext* cx, ModuleObject* module) {
+  // Copy the specifiers out of the parse zone so they can be read from the
+  // off thread compile callback without touching GC things.
+  ArrayObject& requests = module->requestedModules();
+  if (!moduleRequests.reserve(requests.length())) {
+    ReportOutOfMemory(cx);
+    return false;
+  }
+
+  for (uint32_t i = 0; i < requests.length(); i++) {
+    auto& request =
+        requests.getDenseElement(i).toObject().as<RequestedModuleObject>();
+    JSAtom* specifier = request.moduleSpecifier();
+
+    UniqueTwoByteChars chars(js_pod_malloc<char16_t>(specifier->length() + 1));
+    if (!chars) {
+      ReportOutOfMemory(cx);
+      return false;
+    }
+    CopyChars(chars.get(), *specifier);
+    chars[specifier->length()] = '\0';
+
+    moduleRequests.infallibleAppend(
+        ModuleRequestChars{std::move(chars), specifier->length()});
+  }
+
+  return true;
+}
+
 ScriptDecodeTask::ScriptDecodeTask(JSContext* cx,
                                    const JS::TranscodeRange& range,
                                    JS::OffThreadCompileCallback callback,
@@ -707,21 +828,63 @@ void BinASTDecodeTask::parse(JSContext* cx) {
 #endif /* JS_BUILD_BINAST */
 
 MultiScriptsDecodeTask::MultiScriptsDecodeTask(
-    JSContext* cx, JS::TranscodeSources& sources,
+    JSContext* cx, JS::TranscodeSources& sources, MultiScriptsDecodeTask* lead,
     JS::OffThreadCompileCallback callback, void* callbackData)
     : ParseTask(ParseTaskKind::MultiScriptsDecode, cx, callback, callbackData),
-      sources(&sources) {}
+      sources(&sources),
+      lead(lead),
+      nextSource(0),
+      decodeFailed(false),
+      pendingRuns(1) {}
+
+bool MultiScriptsDecodeTask::releasePendingRun(
+    AutoLockHelperThreadState& lock) {
+  MOZ_ASSERT(!lead);
+  MOZ_ASSERT(pendingRuns > 0);
+  return --pendingRuns == 0;
+}
+
+MultiScriptsDecodeTask* MultiScriptsDecodeTask::discard(
+    AutoLockHelperThreadState& lock) {
+  MOZ_ASSERT(lead);
+
+  MultiScriptsDecodeTask* task = lead;
+  task->parts.eraseIfEqual(this);
+
+  // The part has been activated, so its zone is in use by a helper thread.
+  parseGlobal->runtimeFromAnyThread()->clearUsedByHelperThread(
+      parseGlobal->zoneFromAnyThread());
+  js_delete(this);
+
+  return task->releasePendingRun(lock) ? task : nullptr;
+}
+
+ParseTask* MultiScriptsDecodeTask::finishRun(AutoLockHelperThreadState& lock) {
+  MultiScriptsDecodeTask* task = leadTask();
+  return task->releasePendingRun(lock) ? task : nullptr;
+}
 
 void MultiScriptsDecodeTask::parse(JSContext* cx) {
   MOZ_ASSERT(cx->isHelperThreadContext());
 
+  MultiScriptsDecodeTask* task = leadTask();
+
+  // We don't know how many sources this task will end up claiming.
   if (!scripts.reserve(sources->length()) ||
-      !sourceObjects.reserve(sources->length())) {
+      !sourceObjects.reserve(sources->length()) ||
+      !sourceIndices.reserve(sources->length())) {
+    task->decodeFailed = true;
     ReportOutOfMemory(cx);  // This sets |outOfMemory|.
     return;
   }
 
-  for (auto& source : *sources) {
+  while (!task->decodeFailed) {
+    size_t index = task->nextSource++;
+    if (index >= sources->length()) {
+      break;
+    }
+
+    auto& source = (*sources)[index];
     CompileOptions opts(cx, options);
     opts.setFileAndLine(source.filename, source.lineno);
 
@@ -732,6 +895,7 @@ void MultiScriptsDecodeTask::parse(JSContext* cx) {
         cx, js::MakeUnique<XDROffThreadDecoder>(cx, &opts, &sourceObject.get(),
                                                 source.range));
     if (!decoder) {
+      task->decodeFailed = true;
       ReportOutOfMemory(cx);
       return;
     }
@@ -739,11 +903,13 @@ void MultiScriptsDecodeTask::parse(JSContext* cx) {
     MOZ_ASSERT(bool(resultScript) == res.isOk());
 
     if (res.isErr()) {
+      task->decodeFailed = true;
       break;
     }
     MOZ_ASSERT(resultScript);
     scripts.infallibleAppend(resultScript);
     sourceObjects.infallibleAppend(sourceObject);
+    sourceIndices.infallibleAppend(index);
   }
 }
 
@@ -916,9 +1082,8 @@ static JSObject* CreateGlobalForOffThreadParse(JSContext* cx,
                             JS::DontFireOnNewGlobalHook, realmOptions);
 }
 
-static bool QueueOffThreadParseTask(JSContext* cx, UniquePtr<ParseTask> task) {
-  AutoLockHelperThreadState lock;
-
+static bool QueueOffThreadParseTask(JSContext* cx, UniquePtr<ParseTask> task,
+                                    AutoLockHelperThreadState& lock) {
   bool mustWait = OffThreadParsingMustWaitForGC(cx->runtime());
 
   // Append null first, then overwrite it on  success, to avoid having two
@@ -941,6 +1106,11 @@ static bool QueueOffThreadParseTask(JSContext* cx, UniquePtr<ParseTask> task) {
   return true;
 }
 
+static bool QueueOffThreadParseTask(JSContext* cx, UniquePtr<ParseTask> task) {
+  AutoLockHelperThreadState lock;
+  return QueueOffThreadParseTask(cx, std::move(task), lock);
+}
+
 static bool StartOffThreadParseTask(JSContext* cx, UniquePtr<ParseTask> task,
                                     const ReadOnlyCompileOptions& options) {
   // Suppress GC so that calls below do not trigger a new incremental GC
@@ -1050,18 +1220,92 @@ bool js::StartOffThreadDecodeScript(JSContext* cx,
   return StartOffThreadParseTask(cx, std::move(task), options);
 }
 
+// Queue another part of |lead|'s decode. This fails without reporting an
+// error if the lead has already finished: its sources have all been claimed
+// and the helper thread that ran last has reported it to the embedder.
+static bool StartOffThreadDecodePart(JSContext* cx,
+                                     MultiScriptsDecodeTask* lead,
+                                     const ReadOnlyCompileOptions& options) {
+  auto part = cx->make_unique<MultiScriptsDecodeTask>(
+      cx, *lead->sources, lead, /* callback = */ nullptr,
+      /* callbackData = */ nullptr);
+  if (!part) {
+    return false;
+  }
+
+  gc::AutoSuppressGC nogc(cx);
+  gc::AutoSuppressNurseryCellAlloc noNurseryAlloc(cx);
+  AutoSuppressAllocationMetadataBuilder suppressMetadata(cx);
+
+  JSObject* global = CreateGlobalForOffThreadParse(cx, nogc);
+  if (!global) {
+    return false;
+  }
+
+  AutoSetCreatedForHelperThread createdForHelper(global);
+
+  if (!part->init(cx, options, global)) {
+    return false;
+  }
+
+  // Take the pending run and queue the part under the same lock, so that the
+  // lead can't finish in between.
+  MultiScriptsDecodeTask* raw = part.get();
+  AutoLockHelperThreadState lock;
+  if (lead->pendingRuns == 0) {
+    return false;
+  }
+
+  lead->pendingRuns++;
+  if (!QueueOffThreadParseTask(cx, std::move(part), lock)) {
+    MOZ_ALWAYS_FALSE(lead->releasePendingRun(lock));
+    return false;
+  }
+
+  // |raw| can't be merged or destroyed before the lead is finished.
+  lead->parts.infallibleAppend(raw);
+  createdForHelper.forget();
+  return true;
+}
+
 bool js::StartOffThreadDecodeMultiScripts(JSContext* cx,
                                           const ReadOnlyCompileOptions& options,
                                           JS::TranscodeSources& sources,
                                           JS::OffThreadCompileCallback callback,
                                           void* callbackData) {
-  auto task = cx->make_unique<MultiScriptsDecodeTask>(cx, sources, callback,
-                                                      callbackData);
+  auto task = cx->make_unique<MultiScriptsDecodeTask>(
+      cx, sources, /* lead = */ nullptr, callback, callbackData);
   if (!task) {
     return false;
   }
 
-  return StartOffThreadParseTask(cx, std::move(task), options);
+  // Split the list across the helper threads, keeping at least
+  // MinSourcesPerPart sources per task.
+  size_t numTasks = std::min(HelperThreadState().threadCount,
+                             HelperThreadState().maxParseThreads());
+  numTasks = std::min(
+      numTasks, sources.length() / MultiScriptsDecodeTask::MinSourcesPerPart);
+  size_t numParts = numTasks > 0 ? numTasks - 1 : 0;  // The lead decodes too.
+  if (!task->parts.reserve(numParts)) {
+    ReportOutOfMemory(cx);
+    return false;
+  }
+
+  MultiScriptsDecodeTask* lead = task.get();
+  if (!StartOffThreadParseTask(cx, std::move(task), options)) {
+    return false;
+  }
+
+  // From here on the lead is queued and we can't fail: any source that a
+  // part would have decoded is picked up by the other tasks instead.
+  for (size_t i = 0; i < numParts; i++) {
+    if (!StartOffThreadDecodePart(cx, lead, options)) {
+      cx->clearPendingException();
+      break;
+    }
+  }
+
+  return true;
 }
 
 #if defined(JS_BUILD_BINAST)
@@ -1090,45 +1334,50 @@ bool js::StartOffThreadDecodeBinAST(JSContext* cx,
 void js::EnqueuePendingParseTasksAfterGC(JSRuntime* rt) {
   MOZ_ASSERT(!OffThreadParsingMustWaitForGC(rt));
 
-  GlobalHelperThreadState::ParseTaskVector newTasks;
-  {
-    AutoLockHelperThreadState lock;
-    GlobalHelperThreadState::ParseTaskVector& waiting =
-        HelperThreadState().parseWaitingOnGC(lock);
-
-    for (size_t i = 0; i < waiting.length(); i++) {
-      ParseTask* task = waiting[i];
-      if (task->runtimeMatches(rt)) {
-        AutoEnterOOMUnsafeRegion oomUnsafe;
-        if (!newTasks.append(task)) {
-          oomUnsafe.crash("EnqueuePendingParseTasksAfterGC");
-        }
-        HelperThreadState().remove(waiting, &i);
-      }
-    }
-  }
-
-  if (newTasks.empty()) {
-    return;
-  }
+  AutoLockHelperThreadState lock;
+  GlobalHelperThreadState::ParseTaskVector& waiting =
+      HelperThreadState().parseWaitingOnGC(lock);
+  GlobalHelperThreadState::ParseTaskVector& worklist =
+      HelperThreadState().parseWorklist(lock);
 
   // This logic should mirror the contents of the
   // !OffThreadParsingMustWaitForGC() branch in QueueOffThreadParseTask:
 
-  for (size_t i = 0; i < newTasks.length(); i++) {
-    newTasks[i]->activate(rt);
-  }
+  bool enqueued = false;
+  for (size_t i = 0; i < waiting.length(); i++) {
+    ParseTask* task = waiting[i];
+    if (!task->runtimeMatches(rt)) {
+      continue;
+    }
+    HelperThreadState().remove(waiting, &i);
 
-  AutoLockHelperThreadState lock;
+    task->activate(rt);
+    if (worklist.append(task)) {
+      enqueued = true;
+      continue;
+    }
 
-  {
-    AutoEnterOOMUnsafeRegion oomUnsafe;
-    if (!HelperThreadState().parseWorklist(lock).appendAll(newTasks)) {
-      oomUnsafe.crash("EnqueuePendingParseTasksAfterGC");
+    // A part of a multi-script decode can be dropped: the other tasks decode
+    // its share of the sources instead.
+    if (task->kind == ParseTaskKind::MultiScriptsDecode &&
+        static_cast<MultiScriptsDecodeTask*>(task)->lead) {
+      auto part = static_cast<MultiScriptsDecodeTask*>(task);
+      // The last run to finish reports the lead to the embedder, which must
+      // happen on a helper thread. If that would be this part, then it has
+      // to be queued like any other task.
+      if (part->lead->pendingRuns > 1) {
+        MOZ_ALWAYS_FALSE(part->discard(lock));
+        continue;
+      }
     }
+
+    AutoEnterOOMUnsafeRegion oomUnsafe;
+    oomUnsafe.crash("EnqueuePendingParseTasksAfterGC");
   }
 
-  HelperThreadState().notifyAll(GlobalHelperThreadState::PRODUCER, lock);
+  if (enqueued) {
+    HelperThreadState().notifyAll(GlobalHelperThreadState::PRODUCER, lock);
+  }
 }
 
 #ifdef DEBUG
@@ -1163,6 +1412,11 @@ bool GlobalHelperThreadState::ensureInitialized() {
       threads->infallibleEmplaceBack();
       HelperThread& helper = (*threads)[i];
 
+      // The embedder's threads run the tasks of these slots.
+      if (dispatchTaskCallback) {
+        continue;
+      }
+
       helper.thread = mozilla::Some(
           Thread(Thread::Options().setStackSize(HELPER_STACK_SIZE)));
       if (!helper.thread->init(HelperThread::ThreadMain, &helper)) {
@@ -1187,7 +1441,10 @@ GlobalHelperThreadState::GlobalHelperThreadState()
       threads(nullptr),
       registerThread(nullptr),
       unregisterThread(nullptr),
+      dispatchTaskCallback(nullptr),
       wasmTier2GeneratorsFinished_(0),
+      pendingDispatches_(0),
+      dispatchesToSend_(0),
       helperLock(mutexid::GlobalHelperThreadState) {
   cpuCount = ClampDefaultCPUCount(GetCPUCount());
   threadCount = ThreadCountForCPUCount(cpuCount);
@@ -1216,6 +1473,16 @@ void GlobalHelperThreadState::finishThreads() {
   }
 
   MOZ_ASSERT(CanUseExtraThreads());
+
+  if (dispatchTaskCallback) {
+    // There are no threads to join, but tasks may still be running on the
+    // embedder's threads.
+    AutoLockHelperThreadState lock;
+    waitForAllThreadsLocked(lock);
+    threads.reset(nullptr);
+    return;
+  }
+
   for (auto& thread : *threads) {
     thread.destroy();
   }
@@ -1283,19 +1550,88 @@ bool GlobalHelperThreadState::isLockedByCurrentThread() const {
 void GlobalHelperThreadState::wait(
     AutoLockHelperThreadState& locked, CondVar which,
     TimeDuration timeout /* = TimeDuration::Forever() */) {
+  if (dispatchesToSend_) {
+    // The thread we are waiting for may not have been asked for yet. The
+    // dispatch callback must be called without the lock held.
+    AutoUnlockHelperThreadState unlock(locked);
+    sendPendingDispatches();
+  }
   whichWakeup(which).wait_for(locked, timeout);
 }
 
 void GlobalHelperThreadState::notifyAll(CondVar which,
-                                        const AutoLockHelperThreadState&) {
+                                        const AutoLockHelperThreadState& lock) {
+  if (which == PRODUCER && dispatchTaskCallback) {
+    // Each dispatched task asks for another thread before it runs, so one
+    // request is enough to get all the runnable work going.
+    dispatchTask(lock);
+    return;
+  }
   whichWakeup(which).notify_all();
 }
 
 void GlobalHelperThreadState::notifyOne(CondVar which,
-                                        const AutoLockHelperThreadState&) {
+                                        const AutoLockHelperThreadState& lock) {
+  if (which == PRODUCER && dispatchTaskCallback) {
+    dispatchTask(lock);
+    return;
+  }
   whichWakeup(which).notify_one();
 }
 
+void GlobalHelperThreadState::dispatchTask(
+    const AutoLockHelperThreadState& lock) {
+  MOZ_ASSERT(dispatchTaskCallback);
+
+  // There is no point in asking for more threads than there are slots.
+  if (pendingDispatches_ >= threadCount) {
+    return;
+  }
+
+  // The callback is called once the lock is released, see
+  // sendPendingDispatches.
+  pendingDispatches_++;
+  dispatchesToSend_++;
+}
+
+void GlobalHelperThreadState::sendPendingDispatches() {
+  if (!dispatchTaskCallback) {
+    return;
+  }
+
+  MOZ_ASSERT(!isLockedByCurrentThread());
+
+  // Another thread releasing the lock may send some of these first.
+  size_t count = dispatchesToSend_;
+  while (count > 0) {
+    if (dispatchesToSend_.compareExchange(count, count - 1)) {
+      dispatchTaskCallback.ref()();
+    }
+    count = dispatchesToSend_;
+  }
+}
+
+void GlobalHelperThreadState::runDispatchedTask(
+    AutoLockHelperThreadState& lock, ProfilingStack* profilingStack) {
+  MOZ_ASSERT(dispatchTaskCallback);
+
+  if (pendingDispatches_ > 0) {
+    pendingDispatches_--;
+  }
+
+  if (!threads) {
+    return;
+  }
+
+  // If every slot is busy, whichever finishes first dispatches again.
+  for (auto& helper : *threads) {
+    if (helper.idle()) {
+      helper.runDispatchedTask(lock, profilingStack);
+      return;
+    }
+  }
+}
+
 bool GlobalHelperThreadState::hasActiveThreads(
     const AutoLockHelperThreadState&) {
   if (!threads) {
@@ -1672,6 +2008,42 @@ bool GlobalHelperThreadState::canStartParseTask(
          checkTaskThreadLimit<ParseTask*>(maxParseThreads(), /*isMaster=*/true);
 }
 
+ParseTask* GlobalHelperThreadState::popNextParseTask(
+    const AutoLockHelperThreadState& lock) {
+  auto& worklist = parseWorklist(lock);
+  MOZ_ASSERT(!worklist.empty());
+
+  // Speculative tasks that have been waiting for too long go first, oldest
+  // first. Otherwise blocking tasks go before speculative ones. Within each
+  // group the most recently queued task goes first.
+  TimeStamp agingCutoff =
+      TimeStamp::Now() -
+      TimeDuration::FromMilliseconds(SpeculativeParseAgingMs);
+  Maybe<size_t> aged;
+  Maybe<size_t> blocking;
+  for (size_t i = 0; i < worklist.length(); i++) {
+    ParseTask* task = worklist[i];
+    if (!task->options.speculativeOffThread) {
+      blocking = Some(i);
+    } else if (task->queuedTime <= agingCutoff &&
+               (aged.isNothing() ||
+                task->queuedTime < worklist[*aged]->queuedTime)) {
+      aged = Some(i);
+    }
+  }
+
+  size_t index = worklist.length() - 1;
+  if (aged) {
+    index = *aged;
+  } else if (blocking) {
+    index = *blocking;
+  }
+
+  ParseTask* task = worklist[index];
+  worklist.erase(&worklist[index]);
+  return task;
+}
+
 bool GlobalHelperThreadState::canStartCompressionTask(
     const AutoLockHelperThreadState& lock) {
   return !compressionWorklist(lock).empty() &&
@@ -1691,8 +2063,11 @@ void GlobalHelperThreadState::scheduleCompressionTasks(
   auto& pending = compressionPendingList(lock);
   auto& worklist = compressionWorklist(lock);
 
+  TimeStamp now = TimeStamp::Now();
   for (size_t i = 0; i < pending.length(); i++) {
     if (pending[i]->shouldStart()) {
+      pending[i]->setQueuedTime(now);
+
       // OOMing during appending results in the task not being scheduled
       // and deleted.
       Unused << worklist.append(std::move(pending[i]));
@@ -1906,6 +2281,13 @@ UniquePtr<ParseTask> GlobalHelperThreadState::finishParseTaskCommon(
 
   mergeParseTaskRealm(cx, parseTask.get().get(), cx->realm());
 
+  if (kind == ParseTaskKind::MultiScriptsDecode) {
+    auto task = static_cast<MultiScriptsDecodeTask*>(parseTask.get().get());
+    if (!mergeMultiScriptsDecodeParts(cx, task, cx->realm())) {
+      return nullptr;
+    }
+  }
+
   for (auto& script : parseTask->scripts) {
     cx->releaseCheck(script);
   }
@@ -2128,6 +2510,79 @@ void GlobalHelperThreadState::mergeParseTaskRealm(JSContext* cx,
   gc::MergeRealms(parseTask->parseGlobal->as<GlobalObject>().realm(), dest);
 }
 
+bool GlobalHelperThreadState::mergeMultiScriptsDecodeParts(
+    JSContext* cx, MultiScriptsDecodeTask* task, Realm* dest) {
+  MOZ_ASSERT(!task->lead);
+
+  size_t numScripts = task->scripts.length();
+  size_t numSourceObjects = task->sourceObjects.length();
+  size_t numErrors = task->errors.length();
+  for (MultiScriptsDecodeTask* part : task->parts) {
+    numScripts += part->scripts.length();
+    numSourceObjects += part->sourceObjects.length();
+    numErrors += part->errors.length();
+  }
+
+  // Reserve everything up front: nothing below can GC before the scripts
+  // are back in the (rooted) lead task, and a part which has been merged
+  // can't be left in |parts|.
+  Vector<JSScript*, 0, SystemAllocPolicy> ordered;
+  if (!ordered.appendN(nullptr, task->sources->length()) ||
+      !task->scripts.reserve(numScripts) ||
+      !task->sourceObjects.reserve(numSourceObjects) ||
+      !task->errors.reserve(numErrors)) {
+    ReportOutOfMemory(cx);
+    return false;
+  }
+
+  for (size_t i = 0; i < task->scripts.length(); i++) {
+    ordered[task->sourceIndices[i]] = task->scripts[i];
+  }
+
+  for (MultiScriptsDecodeTask*& part : task->parts) {
+    mergeParseTaskRealm(cx, part, dest);
+
+    for (size_t i = 0; i < part->scripts.length(); i++) {
+      ordered[part->sourceIndices[i]] = part->scripts[i];
+    }
+    for (auto& sourceObject : part->sourceObjects) {
+      task->sourceObjects.infallibleAppend(sourceObject);
+    }
+    for (auto& error : part->errors) {
+      task->errors.infallibleAppend(std::move(error));
+    }
+    task->overRecursed |= part->overRecursed;
+    task->outOfMemory |= part->outOfMemory;
+
+    js_delete(part);
+    part = nullptr;
+  }
+  task->parts.clear();
+
+  // Keep the leading decoded scripts in source order. A failed decode leaves
+  // a gap, after which nothing is kept, as if the list was decoded in order.
+  task->scripts.clear();
+  for (JSScript* script : ordered) {
+    if (!script) {
+      break;
+    }
+    task->scripts.infallibleAppend(script);
+  }
+
+  return true;
+}
+
+MultiScriptsDecodeTask::~MultiScriptsDecodeTask() {
+  // Parts which haven't been merged into the destination realm are discarded
+  // along with the lead.
+  for (MultiScriptsDecodeTask* part : parts) {
+    if (part) {
+      LeaveParseTaskZone(part->parseGlobal->runtimeFromAnyThread(), part);
+      js_delete(part);
+    }
+  }
+}
+
 void HelperThread::destroy() {
   if (thread.isSome()) {
     {
@@ -2144,18 +2599,11 @@ void HelperThread::destroy() {
 }
 
 void HelperThread::ensureRegisteredWithProfiler() {
-  if (profilingStack || mozilla::recordreplay::IsRecordingOrReplaying()) {
+  if (profilingStack) {
     return;
   }
 
-  // Note: To avoid dead locks, we should not hold on the helper thread lock
-  // while calling this function. This is safe because the registerThread field
-  // is a WriteOnceData<> type stored on the global helper tread state.
-  JS::RegisterThreadCallback callback = HelperThreadState().registerThread;
-  if (callback) {
-    profilingStack =
-        callback("JS Helper", reinterpret_cast<void*>(GetNativeStackBase()));
-  }
+  profilingStack = RegisterHelperThreadWithProfiler();
 }
 
 void HelperThread::unregisterWithProfilerIfNeeded() {
@@ -2177,10 +2625,7 @@ void HelperThread::unregisterWithProfilerIfNeeded() {
 void HelperThread::ThreadMain(void* arg) {
   ThisThread::SetName("JS Helper");
 
-  // Helper threads are allowed to run differently during recording and
-  // replay, as compiled scripts and GCs are allowed to vary. Because of
-  // this, no recorded events at all should occur while on helper threads.
-  mozilla::recordreplay::AutoDisallowThreadEvents d;
+  AutoHelperTaskThread helperTaskThread;
   auto helper = static_cast<HelperThread*>(arg);
 
   helper->ensureRegisteredWithProfiler();
@@ -2201,16 +2646,29 @@ void HelperThread::handleWasmWorkload(AutoLockHelperThreadState& locked,
   MOZ_ASSERT(HelperThreadState().canStartWasmCompile(locked, mode));
   MOZ_ASSERT(idle());
 
-  currentTask.emplace(
-      HelperThreadState().wasmWorklist(locked, mode).popCopyFront());
+  GlobalHelperThreadState::Selector selector =
+      mode == wasm::CompileMode::Tier1
+          ? &GlobalHelperThreadState::canStartWasmTier1Compile
+          : &GlobalHelperThreadState::canStartWasmTier2Compile;
 
-  wasm::CompileTask* task = wasmTask();
-  {
-    AutoUnlockHelperThreadState unlock(locked);
-    task->runTask();
-  }
+  // Keep draining this worklist for as long as it remains the highest
+  // priority work. A module's tasks are small and numerous, and going back
+  // through threadLoop for each would wake every CONSUMER waiter once per
+  // task, all of them then contending for the helper thread lock.
+  const TaskSpec* next;
+  do {
+    currentTask.emplace(
+        HelperThreadState().wasmWorklist(locked, mode).popCopyFront());
 
-  currentTask.reset();
+    wasm::CompileTask* task = wasmTask();
+    {
+      AutoUnlockHelperThreadState unlock(locked);
+      task->runTask();
+    }
+
+    currentTask.reset();
+    next = terminate ? nullptr : findHighestPriorityTask(locked);
+  } while (next && next->canStart == selector);
 
   // Since currentTask is only now reset(), this could be the last active thread
   // waitForAllThreads() is waiting for. No one else should be waiting, though.
@@ -2319,6 +2777,9 @@ HelperThread* js::CurrentHelperThread() {
   if (!HelperThreadState().threads) {
     return nullptr;
   }
+  if (HelperThread* helper = tlsDispatchedHelperThread.get()) {
+    return helper;
+  }
   auto threadId = ThreadId::ThisThreadId();
   for (auto& thisThread : *HelperThreadState().threads) {
     if (thisThread.thread.isSome() && threadId == thisThread.thread->get_id()) {
@@ -2362,8 +2823,10 @@ void HelperThread::handleParseWorkload(AutoLockHelperThreadState& locked) {
   MOZ_ASSERT(HelperThreadState().canStartParseTask(locked));
   MOZ_ASSERT(idle());
 
-  currentTask.emplace(HelperThreadState().parseWorklist(locked).popCopy());
+  currentTask.emplace(HelperThreadState().popNextParseTask(locked));
   ParseTask* task = parseTask();
+  HelperThreadState().parseQueueWaitStats(locked).record(
+      TimeStamp::Now() - task->queuedTime);
 
 #ifdef DEBUG
   JSRuntime* runtime = task->parseGlobal->runtimeFromAnyThread();
@@ -2374,12 +2837,16 @@ void HelperThread::handleParseWorkload(AutoLockHelperThreadState& locked) {
     AutoUnlockHelperThreadState unlock(locked);
     task->runTask();
   }
-  // The callback is invoked while we are still off thread.
-  task->callback(task, task->callbackData);
+  // Tasks which are part of a larger decode only report the whole decode,
+  // once everything in it has run.
+  if (ParseTask* finished = task->finishRun(locked)) {
+    // The callback is invoked while we are still off thread.
+    finished->callback(finished, finished->callbackData);
 
-  // FinishOffThreadScript will need to be called on the script to
-  // migrate it into the correct compartment.
-  HelperThreadState().parseFinishedList(locked).insertBack(task);
+    // FinishOffThreadScript will need to be called on the script to
+    // migrate it into the correct compartment.
+    HelperThreadState().parseFinishedList(locked).insertBack(finished);
+  }
 
 #ifdef DEBUG
   runtime->decOffThreadParsesRunning();
@@ -2403,6 +2870,8 @@ void HelperThread::handleCompressionWorkload(
     worklist.popBack();
     currentTask.emplace(task.get());
   }
+  HelperThreadState().compressionQueueWaitStats(locked).record(
+      TimeStamp::Now() - task->queuedTime());
 
   {
     AutoUnlockHelperThreadState unlock(locked);
@@ -2642,7 +3111,6 @@ HelperThread::AutoProfilerLabel::~AutoProfilerLabel() {
 void HelperThread::threadLoop() {
   MOZ_ASSERT(CanUseExtraThreads());
 
-  JS::AutoSuppressGCAnalysis nogc;
   AutoLockHelperThreadState lock;
 
   while (!terminate) {
@@ -2667,6 +3135,34 @@ void HelperThread::threadLoop() {
   }
 }
 
+void HelperThread::runDispatchedTask(AutoLockHelperThreadState& locked,
+                                     ProfilingStack* currentProfilingStack) {
+  MOZ_ASSERT(thread.isNothing());
+  MOZ_ASSERT(idle());
+  MOZ_ASSERT(!profilingStack);
+
+  const TaskSpec* task = findHighestPriorityTask(locked);
+  if (!task) {
+    return;
+  }
+
+  // More work may be queued behind this task, so ask for another thread.
+  HelperThreadState().dispatchTask(locked);
+
+  tlsDispatchedHelperThread.set(this);
+  profilingStack = currentProfilingStack;
+  js::oom::SetThreadType(task->type);
+  (this->*(task->handleWorkload))(locked);
+  js::oom::SetThreadType(js::THREAD_TYPE_NONE);
+  profilingStack = nullptr;
+  tlsDispatchedHelperThread.set(nullptr);
+
+  // Nobody else may be left to pick up work that this task could not start.
+  if (findHighestPriorityTask(locked)) {
+    HelperThreadState().dispatchTask(locked);
+  }
+}
+
 const HelperThread::TaskSpec* HelperThread::findHighestPriorityTask(
     const AutoLockHelperThreadState& locked) {
   // Return the highest priority task that is ready to start, or nullptr.
@@ -13,6 +13,7 @@
 #ifndef vm_HelperThreads_h
 #define vm_HelperThreads_h
 
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/GuardObjects.h"
 #include "mozilla/PodOperations.h"
@@ -45,6 +46,8 @@ class AutoLockHelperThreadState;
 class AutoUnlockHelperThreadState;
 class CompileError;
 struct HelperThread;
+class ModuleObject;
+struct MultiScriptsDecodeTask;
 struct ParseTask;
 struct PromiseHelperTask;
 namespace jit {
@@ -78,6 +81,21 @@ typedef Vector<Tier2GeneratorTask*, 0, SystemAllocPolicy>
 
 }  // namespace wasm
 
+// Time tasks of one kind spent in a worklist before a thread started them.
+struct HelperTaskQueueWaitStats {
+  uint64_t count = 0;
+  mozilla::TimeDuration total;
+  mozilla::TimeDuration max;
+
+  void record(mozilla::TimeDuration wait) {
+    count++;
+    total += wait;
+    if (wait > max) {
+      max = wait;
+    }
+  }
+};
+
 // Per-process state for off thread work items.
 class GlobalHelperThreadState {
   friend class AutoLockHelperThreadState;
@@ -88,6 +106,11 @@ class GlobalHelperThreadState {
   // do not want to allow more than one such ModuleGenerator to run at a time.
   static const size_t MaxTier2GeneratorTasks = 1;
 
+  // Speculative parse tasks queued for longer than this are started before
+  // any other parse task, so a steady stream of blocking parses can't starve
+  // them.
+  static const uint32_t SpeculativeParseAgingMs = 500;
+
   // Number of CPUs to treat this machine as having when creating threads.
   // May be accessed without locking.
   size_t cpuCount;
@@ -113,6 +136,11 @@ class GlobalHelperThreadState {
   WriteOnceData<JS::RegisterThreadCallback> registerThread;
   WriteOnceData<JS::UnregisterThreadCallback> unregisterThread;
 
+  // Set when the embedder runs helper tasks on its own threads, see
+  // JS::SetHelperThreadTaskCallback. |threads| then holds slots without an
+  // OS thread, each tracking a task running on one of the embedder's threads.
+  WriteOnceData<JS::HelperThreadTaskCallback> dispatchTaskCallback;
+
  private:
   // The lists below are all protected by |lock|.
 
@@ -147,12 +175,23 @@ class GlobalHelperThreadState {
   // Finished source compression tasks.
   SourceCompressionTaskVector compressionFinishedList_;
 
+  HelperTaskQueueWaitStats parseQueueWaitStats_;
+  HelperTaskQueueWaitStats compressionQueueWaitStats_;
+
   // GC tasks needing to be done in parallel.
   GCParallelTaskList gcParallelWorklist_;
 
   // Global list of JSContext for GlobalHelperThreadState to use.
   ContextVector helperContexts_;
 
+  // The number of calls to |dispatchTaskCallback| that have not yet been
+  // answered by JS::RunHelperThreadTask.
+  size_t pendingDispatches_;
+
+  // The number of calls to |dispatchTaskCallback| to make once the lock is
+  // released. The callback is never called with the lock held.
+  mozilla::Atomic<size_t, mozilla::ReleaseAcquire> dispatchesToSend_;
+
   ParseTask* removeFinishedParseTask(ParseTaskKind kind,
                                      JS::OffThreadToken* token);
 
@@ -199,6 +238,18 @@ class GlobalHelperThreadState {
   void notifyAll(CondVar which, const AutoLockHelperThreadState&);
   void notifyOne(CondVar which, const AutoLockHelperThreadState&);
 
+  // Ask the embedder for a thread to run a task on, unless enough requests
+  // are already outstanding.
+  void dispatchTask(const AutoLockHelperThreadState& lock);
+
+  // Run a task in an idle slot on the current, embedder-provided, thread.
+  void runDispatchedTask(AutoLockHelperThreadState& lock,
+                         ProfilingStack* profilingStack);
+
+  // Make the calls to |dispatchTaskCallback| requested while the lock was
+  // held. Must be called without the lock.
+  void sendPendingDispatches();
+
   // Helper method for removing items from the vectors below while iterating
   // over them.
   template <typename T>
@@ -262,6 +313,18 @@ class GlobalHelperThreadState {
     return parseWaitingOnGC_;
   }
 
+  // Remove and return the parse task to run next from the worklist.
+  ParseTask* popNextParseTask(const AutoLockHelperThreadState& lock);
+
+  HelperTaskQueueWaitStats& parseQueueWaitStats(
+      const AutoLockHelperThreadState&) {
+    return parseQueueWaitStats_;
+  }
+  HelperTaskQueueWaitStats& compressionQueueWaitStats(
+      const AutoLockHelperThreadState&) {
+    return compressionQueueWaitStats_;
+  }
+
   SourceCompressionTaskVector& compressionPendingList(
       const AutoLockHelperThreadState&) {
     return compressionPendingList_;
@@ -281,6 +344,10 @@ class GlobalHelperThreadState {
     return gcParallelWorklist_;
   }
 
+  // The type of the canStart* members below that take no other argument.
+  using Selector =
+      bool (GlobalHelperThreadState::*)(const AutoLockHelperThreadState&);
+
   bool canStartWasmCompile(const AutoLockHelperThreadState& lock,
                            wasm::CompileMode mode);
 
@@ -314,6 +381,9 @@ class GlobalHelperThreadState {
 
   void mergeParseTaskRealm(JSContext* cx, ParseTask* parseTask,
                            JS::Realm* dest);
+  bool mergeMultiScriptsDecodeParts(JSContext* cx,
+                                    MultiScriptsDecodeTask* task,
+                                    JS::Realm* dest);
 
  public:
   void cancelParseTask(JSRuntime* rt, ParseTaskKind kind,
@@ -423,6 +493,11 @@ struct HelperThread {
   static void ThreadMain(void* arg);
   void threadLoop();
 
+  // Run one task on the current thread when this slot has no thread of its
+  // own, see GlobalHelperThreadState::runDispatchedTask.
+  void runDispatchedTask(AutoLockHelperThreadState& locked,
+                         ProfilingStack* currentProfilingStack);
+
   void ensureRegisteredWithProfiler();
   void unregisterWithProfilerIfNeeded();
 
@@ -445,8 +520,7 @@ struct HelperThread {
   ProfilingStack* profilingStack;
 
   struct TaskSpec {
-    using Selector =
-        bool (GlobalHelperThreadState::*)(const AutoLockHelperThreadState&);
+    using Selector = GlobalHelperThreadState::Selector;
     using Handler = void (HelperThread::*)(AutoLockHelperThreadState&);
 
     js::ThreadType type;
@@ -677,7 +751,17 @@ void AttachFinishedCompressions(JSRuntime* runtime,
 // Run all pending source compression tasks synchronously, for testing purposes
 void RunPendingSourceCompressions(JSRuntime* runtime);
 
-class MOZ_RAII AutoLockHelperThreadState : public LockGuard<Mutex> {
+// Sends the dispatches requested while the lock was held when it is
+// destroyed, see GlobalHelperThreadState::sendPendingDispatches.
+class AutoSendPendingDispatches {
+ public:
+  ~AutoSendPendingDispatches() { HelperThreadState().sendPendingDispatches(); }
+};
+
+// Bases are destroyed in reverse order, so the lock is released before
+// pending dispatches are sent.
+class MOZ_RAII AutoLockHelperThreadState : private AutoSendPendingDispatches,
+                                           public LockGuard<Mutex> {
   using Base = LockGuard<Mutex>;
 
   MOZ_DECL_USE_GUARD_OBJECT_NOTIFIER
@@ -699,6 +783,7 @@ class MOZ_RAII AutoUnlockHelperThreadState : public UnlockGuard<Mutex> {
       AutoLockHelperThreadState& locked MOZ_GUARD_OBJECT_NOTIFIER_PARAM)
       : Base(locked) {
     MOZ_GUARD_OBJECT_NOTIFIER_INIT;
+    HelperThreadState().sendPendingDispatches();
   }
 };
 
@@ -717,6 +802,12 @@ struct MOZ_RAII AutoSetHelperThreadContext {
   }
 };
 
+// A copy of a module's import specifier, see ParseTask::moduleRequests.
+struct ModuleRequestChars {
+  UniqueTwoByteChars chars;
+  size_t length;
+};
+
 struct ParseTask : public mozilla::LinkedListElement<ParseTask>,
                    public JS::OffThreadToken,
                    public RunnableTask {
@@ -744,6 +835,14 @@ struct ParseTask : public mozilla::LinkedListElement<ParseTask>,
   bool overRecursed;
   bool outOfMemory;
 
+  // When the task was added to the parse worklist, see activate().
+  mozilla::TimeStamp queuedTime;
+
+  // For module parses, the null-terminated specifiers of the module's static
+  // import requests, in source order. These are available as soon as the
+  // task has finished, before the module is merged into the main runtime.
+  Vector<ModuleRequestChars, 0, SystemAllocPolicy> moduleRequests;
+
   ParseTask(ParseTaskKind kind, JSContext* cx,
             JS::OffThreadCompileCallback callback, void* callbackData);
   virtual ~ParseTask();
@@ -753,6 +852,13 @@ struct ParseTask : public mozilla::LinkedListElement<ParseTask>,
 
   void activate(JSRuntime* rt);
   virtual void parse(JSContext* cx) = 0;
+  bool recordModuleRequests(JSContext* cx, ModuleObject* module);
+
+  // Called with the helper thread lock held once this task has run. Returns
+  // the task to report to the embedder as finished, if any.
+  virtual ParseTask* finishRun(AutoLockHelperThreadState& lock) {
+    return this;
+  }
 
   bool runtimeMatches(JSRuntime* rt) {
     return parseGlobal->runtimeFromAnyThread() == rt;
@@ -791,13 +897,52 @@ struct BinASTDecodeTask : public ParseTask {
 
 #endif /* JS_BUILD_BINAST */
 
+// Decoding a list of scripts may be split across several helper threads.
+// The task handed to the embedder (the lead) is queued first, followed by
+// parts which are owned by the lead. Every task claims sources from the lead's
+// shared cursor and decodes them into its own realm. The lead is only reported
+// as finished once all of them have run, and finishing it merges the parts'
+// realms and puts the scripts back in source order.
 struct MultiScriptsDecodeTask : public ParseTask {
   JS::TranscodeSources* sources;
 
+  // Indices in |sources| of the entries of |scripts|.
+  Vector<size_t, 0, SystemAllocPolicy> sourceIndices;
+
+  // The lead task, or nullptr if this is the lead.
+  MultiScriptsDecodeTask* lead;
+
+  // The following are only used by the lead.
+  Vector<MultiScriptsDecodeTask*, 0, SystemAllocPolicy> parts;
+  mozilla::Atomic<size_t, mozilla::ReleaseAcquire> nextSource;
+  mozilla::Atomic<bool, mozilla::ReleaseAcquire> decodeFailed;
+
+  // Number of queued tasks which haven't run yet. Once this drops to zero the
+  // lead has been reported as finished and no more parts can be queued.
+  // Protected by the helper thread lock.
+  size_t pendingRuns;
+
+  // Don't split small lists: each part needs its own global.
+  static const size_t MinSourcesPerPart = 8;
+
   MultiScriptsDecodeTask(JSContext* cx, JS::TranscodeSources& sources,
+                         MultiScriptsDecodeTask* lead,
                          JS::OffThreadCompileCallback callback,
                          void* callbackData);
+  ~MultiScriptsDecodeTask() override;
+
+  MultiScriptsDecodeTask* leadTask() { return lead ? lead : this; }
+
+  // Drop one of the lead's pending runs, returning whether it was the last.
+  bool releasePendingRun(AutoLockHelperThreadState& lock);
+
+  // Remove a part which couldn't be queued from its lead and destroy it,
+  // returning the lead if that dropped its last pending run. Parts holding
+  // the last run must not be discarded.
+  MultiScriptsDecodeTask* discard(AutoLockHelperThreadState& lock);
+
   void parse(JSContext* cx) override;
+  ParseTask* finishRun(AutoLockHelperThreadState& lock) override;
 };
 
 // Return whether, if a new parse task was started, it would need to wait for
@@ -826,9 +971,16 @@ class SourceCompressionTask : public RunnableTask {
   // The major GC number of the runtime when the task was enqueued.
   uint64_t majorGCNumber_;
 
+  // When the task was moved to the worklist, see scheduleCompressionTasks.
+  mozilla::TimeStamp queuedTime_;
+
   // The source to be compressed.
   ScriptSourceHolder sourceHolder_;
 
+  // The runtime's codec when the task was enqueued. The runtime field is only
+  // accessible from the main thread.
+  SourceCompressionCodec codec_;
+
   // The resultant compressed string. If the compressed string is larger
   // than the original, or we OOM'd during compression, or nothing else
   // except the task is holding the ScriptSource alive when scheduled to
@@ -840,10 +992,15 @@ class SourceCompressionTask : public RunnableTask {
   SourceCompressionTask(JSRuntime* rt, ScriptSource* source)
       : runtime_(rt),
         majorGCNumber_(rt->gc.majorGCCount()),
-        sourceHolder_(source) {}
+        sourceHolder_(source),
+        codec_(rt->sourceCompressionCodec) {}
   virtual ~SourceCompressionTask() {}
 
   bool runtimeMatches(JSRuntime* runtime) const { return runtime == runtime_; }
+
+  void setQueuedTime(mozilla::TimeStamp time) { queuedTime_ = time; }
+  mozilla::TimeStamp queuedTime() const { return queuedTime_; }
+
   bool shouldStart() const {
     // We wait 2 major GCs to start compressing, in order to avoid
     // immediate compression.
@@ -15,6 +15,7 @@
 
 #include "builtin/AtomicsObject.h"
 #include "ds/MemoryProtectionExceptionHandler.h"
+#include "frontend/Frontend2.h"
 #include "gc/Statistics.h"
 #include "jit/AtomicOperations.h"
 #include "jit/ExecutableAllocator.h"
@@ -160,6 +161,8 @@ JS_PUBLIC_API const char* JS::detail::InitWithFailureDiagnostic(
 
   RETURN_IF_FAIL(js::InitDateTimeState());
 
+  RETURN_IF_FAIL(js::frontend::InitSmooshCompileCache());
+
 #ifdef MOZ_VTUNE
   RETURN_IF_FAIL(js::vtune::Initialize());
 #endif
@@ -253,6 +256,8 @@ JS_PUBLIC_API void JS_ShutDown(void) {
 
   js::FinishDateTimeState();
 
+  js::frontend::FinishSmooshCompileCache();
+
   if (!JSRuntime::hasLiveRuntimes()) {
     js::jit::ReleaseProcessExecutableMemory();
     MOZ_ASSERT(!js::LiveMappedBufferCount());
@@ -1500,7 +1500,8 @@ size_t JSContext::sizeOfExcludingThis(
    * ones have been found by DMD to be worth measuring.  More stuff may be
    * added later.
    */
-  return cycleDetectorVector().sizeOfExcludingThis(mallocSizeOf);
+  return cycleDetectorVector().sizeOfExcludingThis(mallocSizeOf) +
+         frontendCollectionPool_.ref().sizeOfExcludingThis(mallocSizeOf);
 }
 
 #ifdef DEBUG
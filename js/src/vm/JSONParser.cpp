@@ -11,6 +11,8 @@
 #include "mozilla/Sprintf.h"
 #include "mozilla/TextUtils.h"
 
+#include <string.h>
+
 #include "jsnum.h"
 
 #include "builtin/Array.h"
@@ -97,6 +99,43 @@ bool JSONParserBase::errorReturn() {
   return parseType == ParseType::AttemptForEval;
 }
 
+// Skip over the leading run of characters in a string literal which need no
+// special handling, i.e. anything other than '"', '\\' and control
+// characters. Latin-1 input is scanned a word at a time; the remaining
+// characters are examined individually by the caller.
+static inline const Latin1Char* SkipPlainStringChars(const Latin1Char* cur,
+                                                     const Latin1Char* end) {
+  constexpr uint64_t Ones = 0x0101010101010101ULL;
+  constexpr uint64_t Highs = 0x8080808080808080ULL;
+  constexpr uint64_t Quotes = Ones * '"';
+  constexpr uint64_t Backslashes = Ones * '\\';
+  constexpr uint64_t Controls = Ones * 0x20;
+
+  while (end - cur >= ptrdiff_t(sizeof(uint64_t))) {
+    uint64_t word;
+    memcpy(&word, cur, sizeof(word));
+
+    // Each term has a high bit set iff some byte of |word| is '"', '\\' or
+    // below 0x20, respectively. Borrows can only set extra high bits above a
+    // genuine match, so the combined test is exact.
+    uint64_t quote = word ^ Quotes;
+    uint64_t backslash = word ^ Backslashes;
+    uint64_t special = ((quote - Ones) & ~quote) |
+                       ((backslash - Ones) & ~backslash) |
+                       ((word - Controls) & ~word);
+    if (special & Highs) {
+      break;
+    }
+    cur += sizeof(uint64_t);
+  }
+  return cur;
+}
+
+static inline const char16_t* SkipPlainStringChars(const char16_t* cur,
+                                                   const char16_t* end) {
+  return cur;
+}
+
 template <typename CharT>
 template <JSONParserBase::StringType ST>
 JSONParserBase::Token JSONParser<CharT>::readString() {
@@ -118,6 +157,7 @@ JSONParserBase::Token JSONParser<CharT>::readString() {
    * string directly from the source text.
    */
   CharPtr start = current;
+  current += SkipPlainStringChars(current.get(), end.get()) - current.get();
   for (; current < end; current++) {
     if (*current == '"') {
       size_t length = current - start;
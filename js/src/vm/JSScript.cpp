@@ -2020,20 +2020,43 @@ const Unit* UncompressedSourceCache::lookup(const ScriptSourceChunk& ssc,
   MOZ_ASSERT(!holder_);
   MOZ_ASSERT(ssc.ss->isCompressed<Unit>());
 
-  if (!map_) {
-    return nullptr;
-  }
-
-  if (Map::Ptr p = map_->lookup(ssc)) {
-    holdEntry(holder, ssc);
-    return static_cast<const Unit*>(p->value().get());
+  if (map_) {
+    if (Map::Ptr p = map_->lookup(ssc)) {
+      hits_++;
+      p->value().lastUse = ++useCount_;
+      holdEntry(holder, ssc);
+      return static_cast<const Unit*>(p->value().data.get());
+    }
   }
 
+  misses_++;
   return nullptr;
 }
 
+void UncompressedSourceCache::evictUntilFits(size_t bytes) {
+  MOZ_ASSERT(!holder_, "the held entry must not be evicted");
+
+  // The cache only holds a handful of chunks, so a linear scan for the least
+  // recently used one is cheap next to the decompression that precedes it.
+  while (!map_->empty() && totalBytes_ + bytes > MaxBytes) {
+    ScriptSourceChunk oldest;
+    uint64_t oldestUse = UINT64_MAX;
+    for (Map::Range r = map_->all(); !r.empty(); r.popFront()) {
+      if (r.front().value().lastUse < oldestUse) {
+        oldest = r.front().key();
+        oldestUse = r.front().value().lastUse;
+      }
+    }
+
+    Map::Ptr p = map_->lookup(oldest);
+    MOZ_ASSERT(totalBytes_ >= p->value().bytes);
+    totalBytes_ -= p->value().bytes;
+    map_->remove(p);
+  }
+}
+
 bool UncompressedSourceCache::put(const ScriptSourceChunk& ssc, SourceData data,
-                                  AutoHoldEntry& holder) {
+                                  size_t bytes, AutoHoldEntry& holder) {
   MOZ_ASSERT(!holder_);
 
   if (!map_) {
@@ -2043,9 +2066,13 @@ bool UncompressedSourceCache::put(const ScriptSourceChunk& ssc, SourceData data,
     }
   }
 
-  if (!map_->put(ssc, std::move(data))) {
+  MOZ_ASSERT(!map_->has(ssc));
+  evictUntilFits(bytes);
+
+  if (!map_->putNew(ssc, Entry(std::move(data), bytes, ++useCount_))) {
     return false;
   }
+  totalBytes_ += bytes;
 
   holdEntry(holder, ssc);
   return true;
@@ -2058,12 +2085,13 @@ void UncompressedSourceCache::purge() {
 
   for (Map::Range r = map_->all(); !r.empty(); r.popFront()) {
     if (holder_ && r.front().key() == holder_->sourceChunk()) {
-      holder_->deferDelete(std::move(r.front().value()));
+      holder_->deferDelete(std::move(r.front().value().data));
       holder_ = nullptr;
     }
   }
 
   map_ = nullptr;
+  totalBytes_ = 0;
 }
 
 size_t UncompressedSourceCache::sizeOfExcludingThis(
@@ -2072,7 +2100,7 @@ size_t UncompressedSourceCache::sizeOfExcludingThis(
   if (map_ && !map_->empty()) {
     n += map_->shallowSizeOfIncludingThis(mallocSizeOf);
     for (Map::Range r = map_->all(); !r.empty(); r.popFront()) {
-      n += mallocSizeOf(r.front().value().get());
+      n += mallocSizeOf(r.front().value().data.get());
     }
   }
   return n;
@@ -2112,7 +2140,7 @@ const Unit* ScriptSource::chunkUnits(
 
   const Unit* ret = decompressed.get();
   if (!cx->caches().uncompressedSourceCache.put(
-          ssc, ToSourceData(std::move(decompressed)), holder)) {
+          ssc, ToSourceData(std::move(decompressed)), chunkBytes, holder)) {
     JS_ReportOutOfMemory(cx);
     return nullptr;
   }
@@ -2664,7 +2692,8 @@ void SourceCompressionTask::workEncodingSpecific() {
   }
 
   const Unit* chars = source->uncompressedData<Unit>()->units();
-  Compressor comp(reinterpret_cast<const unsigned char*>(chars), inputBytes);
+  Compressor comp(reinterpret_cast<const unsigned char*>(chars), inputBytes,
+                  codec_);
   if (!comp.init()) {
     return;
   }
@@ -2835,7 +2864,8 @@ bool js::SynchronouslyCompressSource(JSContext* cx,
 
 void ScriptSource::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
                                           JS::ScriptSourceInfo* info) const {
-  info->misc += mallocSizeOf(this);
+  info->misc += mallocSizeOf(this) +
+                delazifiedFunctions_.sizeOfExcludingThis(mallocSizeOf);
   info->numScripts++;
 }
 
@@ -18,9 +18,11 @@
 #include "mozilla/Span.h"
 #include "mozilla/Tuple.h"
 #include "mozilla/UniquePtr.h"
+#include "mozilla/Unused.h"
 #include "mozilla/Utf8.h"
 #include "mozilla/Variant.h"
 
+#include <algorithm>    // std::lower_bound
 #include <type_traits>  // std::is_same
 #include <utility>      // std::move
 
@@ -281,18 +283,22 @@ class ScriptSource;
 
 struct ScriptSourceChunk {
   ScriptSource* ss = nullptr;
+
+  // Entries of the UncompressedSourceCache outlive major GCs, so they can
+  // outlive their ScriptSource too. The source's id tells a new source apart
+  // from a dead one that happened to be allocated at the same address.
+  uint32_t sourceId = 0;
   uint32_t chunk = 0;
 
   ScriptSourceChunk() = default;
 
-  ScriptSourceChunk(ScriptSource* ss, uint32_t chunk) : ss(ss), chunk(chunk) {
-    MOZ_ASSERT(valid());
-  }
+  inline ScriptSourceChunk(ScriptSource* ss, uint32_t chunk);
 
   bool valid() const { return ss != nullptr; }
 
   bool operator==(const ScriptSourceChunk& other) const {
-    return ss == other.ss && chunk == other.chunk;
+    return ss == other.ss && sourceId == other.sourceId &&
+           chunk == other.chunk;
   }
 };
 
@@ -301,7 +307,7 @@ struct ScriptSourceChunkHasher {
 
   static HashNumber hash(const ScriptSourceChunk& ssc) {
     return mozilla::AddToHash(DefaultHasher<ScriptSource*>::hash(ssc.ss),
-                              ssc.chunk);
+                              ssc.sourceId, ssc.chunk);
   }
   static bool match(const ScriptSourceChunk& c1, const ScriptSourceChunk& c2) {
     return c1 == c2;
@@ -327,8 +333,23 @@ inline SourceData ToSourceData(EntryUnits<Unit> chars) {
   return SourceData(chars.release());
 }
 
+// A bounded cache of decompressed chunks of compressed sources, evicting the
+// least recently used chunk first. It is kept across GCs, except shrinking
+// ones, so that delazifying a script after a GC doesn't decompress the same
+// chunks all over again.
 class UncompressedSourceCache {
-  using Map = HashMap<ScriptSourceChunk, SourceData, ScriptSourceChunkHasher,
+  struct Entry {
+    SourceData data;
+    size_t bytes = 0;
+
+    // The value of |useCount_| at the last lookup or put of this entry.
+    uint64_t lastUse = 0;
+
+    Entry(SourceData data, size_t bytes, uint64_t lastUse)
+        : data(std::move(data)), bytes(bytes), lastUse(lastUse) {}
+  };
+
+  using Map = HashMap<ScriptSourceChunk, Entry, ScriptSourceChunkHasher,
                       SystemAllocPolicy>;
 
  public:
@@ -393,19 +414,36 @@ class UncompressedSourceCache {
   UniquePtr<Map> map_ = nullptr;
   AutoHoldEntry* holder_ = nullptr;
 
+  // The sum of the |bytes| of all entries.
+  size_t totalBytes_ = 0;
+
+  // Bumped on every lookup hit and put, to order entries by recency.
+  uint64_t useCount_ = 0;
+
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+
  public:
+  // Room for sixteen full chunks of Compressor::CHUNK_SIZE bytes.
+  static constexpr size_t MaxBytes = 16 * 64 * 1024;
+
   UncompressedSourceCache() = default;
 
   template <typename Unit>
   const Unit* lookup(const ScriptSourceChunk& ssc, AutoHoldEntry& asp);
 
-  bool put(const ScriptSourceChunk& ssc, SourceData data, AutoHoldEntry& asp);
+  bool put(const ScriptSourceChunk& ssc, SourceData data, size_t bytes,
+           AutoHoldEntry& asp);
 
   void purge();
 
+  uint64_t hits() const { return hits_; }
+  uint64_t misses() const { return misses_; }
+
   size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf);
 
  private:
+  void evictUntilFits(size_t bytes);
   void holdEntry(AutoHoldEntry& holder, const ScriptSourceChunk& ssc);
   void releaseEntry(AutoHoldEntry& holder);
 };
@@ -668,6 +706,12 @@ class ScriptSource {
   // our syntax parse vs. full parse heuristics are correct.
   mozilla::TimeStamp parseEnded_;
 
+  // The toStringStart offsets of the functions delazified while the runtime
+  // was recording delazifications, sorted and without duplicates, so that
+  // functions which are relazified and delazified again are only listed once.
+  // See js::GetDelazifiedFunctionOffsets.
+  js::Vector<uint32_t, 0, SystemAllocPolicy> delazifiedFunctions_;
+
   // A string indicating how this source code was introduced into the system.
   // This is a constant, statically allocated C string, so does not need memory
   // management.
@@ -1216,6 +1260,22 @@ class ScriptSource {
     parseEnded_ = ReallyNow();
   }
 
+  // Note that the function starting at |toStringStart| was delazified. This
+  // is a hint for later runs only, so failing to record it is harmless.
+  void recordDelazification(uint32_t toStringStart) {
+    uint32_t* pos =
+        std::lower_bound(delazifiedFunctions_.begin(),
+                         delazifiedFunctions_.end(), toStringStart);
+    if (pos == delazifiedFunctions_.end() || *pos != toStringStart) {
+      mozilla::Unused << delazifiedFunctions_.insert(pos, toStringStart);
+    }
+  }
+  const js::Vector<uint32_t, 0, SystemAllocPolicy>& delazifiedFunctions()
+      const {
+    return delazifiedFunctions_;
+  }
+  void clearDelazifiedFunctions() { delazifiedFunctions_.clearAndFree(); }
+
  private:
   template <typename Unit,
             template <typename U, SourceRetrievable CanRetrieve> class Data,
@@ -1250,6 +1310,11 @@ class ScriptSource {
   void trace(JSTracer* trc);
 };
 
+inline ScriptSourceChunk::ScriptSourceChunk(ScriptSource* ss, uint32_t chunk)
+    : ss(ss), sourceId(ss->id()), chunk(chunk) {
+  MOZ_ASSERT(valid());
+}
+
 class ScriptSourceHolder {
   ScriptSource* ss;
 
@@ -2209,6 +2274,9 @@ class BaseScript : public gc::TenuredCell {
 
     // Set for LazyScripts which have been wrapped by some Debugger.
     WrappedByDebugger = 1 << 28,
+
+    // Script caused frequent bailouts while inlined into another script.
+    HadFrequentBailoutsWhenInlined = 1 << 29,
   };
 
   uint8_t* jitCodeRaw() const { return jitCodeRaw_; }
@@ -2392,6 +2460,8 @@ setterLevel:                                                                  \
   MUTABLE_FLAG_GETTER_SETTER(failedShapeGuard, FailedShapeGuard)
   MUTABLE_FLAG_GETTER_SETTER(hadFrequentBailouts, HadFrequentBailouts)
   MUTABLE_FLAG_GETTER_SETTER(hadOverflowBailout, HadOverflowBailout)
+  MUTABLE_FLAG_GETTER_SETTER(hadFrequentBailoutsWhenInlined,
+                             HadFrequentBailoutsWhenInlined)
   MUTABLE_FLAG_GETTER_SETTER(uninlineable, Uninlineable)
   MUTABLE_FLAG_GETTER_SETTER(invalidatedIdempotentCache,
                              InvalidatedIdempotentCache)
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 
+#include "frontend/Frontend2.h"
 #include "gc/GC.h"
 #include "gc/Nursery.h"
 #include "gc/PublicIterators.h"
@@ -732,6 +733,10 @@ JS_PUBLIC_API bool JS::CollectGlobalStats(GlobalStats* gStats) {
   gStats->tracelogger += SizeOfTraceLogGraphState(gStats->mallocSizeOf_);
 #endif
 
+  // The Rust frontend's compile cache is shared by all runtimes.
+  gStats->smooshCompileCache +=
+      js::frontend::Jsparagus::sizeOfCompileCache(gStats->mallocSizeOf_);
+
   return true;
 }
 
@@ -49,6 +49,7 @@
   _(BufferStreamState, 500)           \
   _(SharedArrayGrow, 500)             \
   _(RuntimeScriptData, 500)           \
+  _(SmooshCompileCache, 500)          \
   _(WasmFuncTypeIdSet, 500)           \
   _(WasmCodeProfilingLabels, 500)     \
   _(WasmCompileTaskState, 500)        \
@@ -126,6 +126,22 @@ JS_PUBLIC_API JSObject* JS::FinishOffThreadModule(JSContext* cx,
   return HelperThreadState().finishModuleParseTask(cx, token);
 }
 
+JS_PUBLIC_API size_t
+JS::GetOffThreadModuleRequestCount(JS::OffThreadToken* token) {
+  auto task = static_cast<ParseTask*>(token);
+  MOZ_ASSERT(task->kind == ParseTaskKind::Module);
+  return task->moduleRequests.length();
+}
+
+JS_PUBLIC_API const char16_t* JS::GetOffThreadModuleRequest(
+    JS::OffThreadToken* token, size_t index, size_t* length) {
+  auto task = static_cast<ParseTask*>(token);
+  MOZ_ASSERT(task->kind == ParseTaskKind::Module);
+  const ModuleRequestChars& request = task->moduleRequests[index];
+  *length = request.length;
+  return request.chars.get();
+}
+
 JS_PUBLIC_API void JS::CancelOffThreadModule(JSContext* cx,
                                              JS::OffThreadToken* token) {
   MOZ_ASSERT(cx);
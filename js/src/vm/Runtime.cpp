@@ -114,6 +114,8 @@ JSRuntime::JSRuntime(JSRuntime* parentRuntime)
       trustedPrincipals_(nullptr),
       wrapObjectCallbacks(&DefaultWrapObjectCallbacks),
       preserveWrapperCallback(nullptr),
+      sourceCompressionCodec(SourceCompressionCodec::Zlib),
+      recordDelazifications(false),
       scriptEnvironmentPreparer(nullptr),
       ctypesActivityCallback(nullptr),
       windowProxyClass_(nullptr),
@@ -360,6 +362,10 @@ void JSRuntime::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
 
   rtSizes->uncompressedSourceCache +=
       caches().uncompressedSourceCache.sizeOfExcludingThis(mallocSizeOf);
+  rtSizes->uncompressedSourceCacheHits +=
+      caches().uncompressedSourceCache.hits();
+  rtSizes->uncompressedSourceCacheMisses +=
+      caches().uncompressedSourceCache.misses();
 
   rtSizes->gc.nurseryCommitted += gc.nursery().committed();
   rtSizes->gc.nurseryMallocedBuffers +=
@@ -850,6 +856,17 @@ JS_FRIEND_API void JS::EnableRecordingAllocations(
   cx->runtime()->startRecordingAllocations(probability, callback);
 }
 
+JS_FRIEND_API void JS::EnableRecordingAllocationsByBytes(
+    JSContext* cx, JS::RecordAllocationsCallback callback,
+    uint32_t averageBytesBetweenSamples) {
+  MOZ_ASSERT(cx);
+  MOZ_ASSERT(cx->isMainThreadContext());
+  MOZ_ASSERT(averageBytesBetweenSamples > 0);
+  cx->runtime()->startRecordingAllocations(
+      1.0 / double(averageBytesBetweenSamples), callback,
+      /* samplingByBytes = */ true);
+}
+
 JS_FRIEND_API void JS::DisableRecordingAllocations(JSContext* cx) {
   MOZ_ASSERT(cx);
   MOZ_ASSERT(cx->isMainThreadContext());
@@ -862,8 +879,10 @@ JS_PUBLIC_API void JS::shadow::RegisterWeakCache(
 }
 
 void JSRuntime::startRecordingAllocations(
-    double probability, JS::RecordAllocationsCallback callback) {
+    double probability, JS::RecordAllocationsCallback callback,
+    bool samplingByBytes) {
   allocationSamplingProbability = probability;
+  allocationSamplingByBytes = samplingByBytes;
   recordAllocationCallback = callback;
 
   // Go through all of the existing realms, and turn on allocation tracking.
@@ -428,6 +428,12 @@ struct JSRuntime {
   js::MainThreadData<const JSWrapObjectCallbacks*> wrapObjectCallbacks;
   js::MainThreadData<js::PreserveWrapperCallback> preserveWrapperCallback;
 
+  /* Codec used by SourceCompressionTask for newly compressed sources. */
+  js::MainThreadData<js::SourceCompressionCodec> sourceCompressionCodec;
+
+  /* Whether ScriptSources record which of their functions get delazified. */
+  js::MainThreadData<bool> recordDelazifications;
+
   js::MainThreadData<js::ScriptEnvironmentPreparer*> scriptEnvironmentPreparer;
 
   js::MainThreadData<js::CTypesActivityCallback> ctypesActivityCallback;
@@ -539,6 +545,10 @@ struct JSRuntime {
   js::MainThreadData<JS::RecordAllocationsCallback> recordAllocationCallback;
   js::MainThreadData<double> allocationSamplingProbability;
 
+  // Whether allocationSamplingProbability is the probability of sampling each
+  // allocated byte rather than each allocation.
+  js::MainThreadData<bool> allocationSamplingByBytes;
+
  private:
   // Number of debuggee realms in the runtime.
   js::MainThreadData<size_t> numDebuggeeRealms_;
@@ -556,7 +566,8 @@ struct JSRuntime {
   void decrementNumDebuggeeRealmsObservingCoverage();
 
   void startRecordingAllocations(double probability,
-                                 JS::RecordAllocationsCallback callback);
+                                 JS::RecordAllocationsCallback callback,
+                                 bool samplingByBytes = false);
   void stopRecordingAllocations();
   void ensureRealmIsRecordingAllocations(JS::Handle<js::GlobalObject*> global);
 
@@ -1797,6 +1797,7 @@ void SavedStacks::chooseSamplingProbability(Realm* realm) {
       // The runtime is tracking allocations across all realms, in this case
       // ignore all of the debugger values, and use the runtime's probability.
       this->setSamplingProbability(runtime->allocationSamplingProbability);
+      samplingByBytes = runtime->allocationSamplingByBytes;
       return;
     }
   }
@@ -1814,6 +1815,7 @@ void SavedStacks::chooseSamplingProbability(Realm* realm) {
   }
 
   this->setSamplingProbability(*probability);
+  samplingByBytes = false;
 }
 
 void SavedStacks::setSamplingProbability(double probability) {
@@ -1827,13 +1829,39 @@ void SavedStacks::setSamplingProbability(double probability) {
   bernoulli.setProbability(probability);
 }
 
+bool SavedStacks::sampleAllocation(JSContext* cx, JSObject* obj) {
+  if (!samplingByBytes) {
+    return bernoulli.trial();
+  }
+
+  // Use the size the object has, or would have if it were tenured, so that
+  // nursery and tenured allocations are sampled consistently.
+  gc::AllocKind kind = obj->isTenured()
+                           ? obj->asTenured().getAllocKind()
+                           : obj->allocKindForTenure(cx->nursery());
+  size_t bytes = gc::Arena::thingSize(kind);
+
+  // Count the slots and elements allocated along with the object, but not
+  // copy-on-write elements, which belong to another object.
+  if (obj->isNative()) {
+    NativeObject* nobj = &obj->as<NativeObject>();
+    bytes += nobj->numDynamicSlots() * sizeof(HeapSlot);
+    if (nobj->hasDynamicElements() && !nobj->denseElementsAreCopyOnWrite()) {
+      bytes += nobj->getElementsHeader()->numAllocatedElements() *
+               sizeof(HeapSlot);
+    }
+  }
+
+  return bernoulli.trial(bytes);
+}
+
 JSObject* SavedStacks::MetadataBuilder::build(
     JSContext* cx, HandleObject target,
     AutoEnterOOMUnsafeRegion& oomUnsafe) const {
   RootedObject obj(cx, target);
 
   SavedStacks& stacks = cx->realm()->savedStacks();
-  if (!stacks.bernoulli.trial()) {
+  if (!stacks.sampleAllocation(cx, obj)) {
     return nullptr;
   }
 
@@ -159,6 +159,7 @@ class SavedStacks {
       : frames(),
         bernoulliSeeded(false),
         bernoulli(1.0, 0x59fdad7f6b4cc573, 0x91adf38db96a9354),
+        samplingByBytes(false),
         creatingSavedFrame(false) {}
 
   MOZ_MUST_USE bool saveCurrentStack(
@@ -183,6 +184,9 @@ class SavedStacks {
 
   size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf);
 
+  // Decide whether to record the allocation of |obj|.
+  bool sampleAllocation(JSContext* cx, JSObject* obj);
+
   // An alloction metadata builder that marks cells with the JavaScript stack
   // at which they were allocated.
   struct MetadataBuilder : public AllocationMetadataBuilder {
@@ -197,6 +201,10 @@ class SavedStacks {
   SavedFrame::Set frames;
   bool bernoulliSeeded;
   mozilla::FastBernoulliTrial bernoulli;
+
+  // Whether |bernoulli| is applied to each allocated byte rather than to each
+  // allocation.
+  bool samplingByBytes;
   bool creatingSavedFrame;
 
   // Similar to mozilla::ReentrancyGuard, but instead of asserting against
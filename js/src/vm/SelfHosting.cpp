@@ -155,6 +155,17 @@ static bool intrinsic_IsCrossRealmArrayConstructor(JSContext* cx, unsigned argc,
   return true;
 }
 
+static bool intrinsic_IsArraySpeciesDefault(JSContext* cx, unsigned argc,
+                                            Value* vp) {
+  CallArgs args = CallArgsFromVp(argc, vp);
+  MOZ_ASSERT(args.length() == 1);
+  MOZ_ASSERT(args[0].isObject());
+
+  RootedObject obj(cx, &args[0].toObject());
+  args.rval().setBoolean(IsArraySpeciesDefault(cx, obj));
+  return true;
+}
+
 static bool intrinsic_ToIntegerPositiveZero(JSContext* cx, unsigned argc,
                                             Value* vp) {
   CallArgs args = CallArgsFromVp(argc, vp);
@@ -2164,6 +2175,7 @@ static const JSFunctionSpec intrinsic_functions[] = {
     JS_INLINABLE_FN("IsCrossRealmArrayConstructor",
                     intrinsic_IsCrossRealmArrayConstructor, 1, 0,
                     IntrinsicIsCrossRealmArrayConstructor),
+    JS_FN("IsArraySpeciesDefault", intrinsic_IsArraySpeciesDefault, 1, 0),
     JS_INLINABLE_FN("ToIntegerPositiveZero", intrinsic_ToIntegerPositiveZero, 1,
                     0, IntrinsicToIntegerPositiveZero),
     JS_INLINABLE_FN("ToString", intrinsic_ToString, 1, 0, IntrinsicToString),
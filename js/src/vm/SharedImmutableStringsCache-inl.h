@@ -19,19 +19,31 @@ SharedImmutableStringsCache::getOrCreate(const char* chars, size_t length,
   MOZ_ASSERT(chars);
   Hasher::Lookup lookup(Hasher::hashLongString(chars, length), chars, length);
 
+  {
+    auto locked = inner_->lock();
+    if (auto entry = locked->set.lookup(lookup)) {
+      return mozilla::Some(SharedImmutableString(locked, entry->get()));
+    }
+  }
+
+  // Create the owned copy without holding the lock, as it may be large. Some
+  // other thread may insert the same string meanwhile, in which case our copy
+  // is simply discarded.
+  OwnedChars ownedChars(intoOwnedChars());
+  if (!ownedChars) {
+    return mozilla::Nothing();
+  }
+  MOZ_ASSERT(ownedChars.get() == chars ||
+             memcmp(ownedChars.get(), chars, length) == 0);
+  auto box = StringBox::Create(std::move(ownedChars), length);
+  if (!box) {
+    return mozilla::Nothing();
+  }
+
   auto locked = inner_->lock();
   auto entry = locked->set.lookupForAdd(lookup);
-  if (!entry) {
-    OwnedChars ownedChars(intoOwnedChars());
-    if (!ownedChars) {
-      return mozilla::Nothing();
-    }
-    MOZ_ASSERT(ownedChars.get() == chars ||
-               memcmp(ownedChars.get(), chars, length) == 0);
-    auto box = StringBox::Create(std::move(ownedChars), length);
-    if (!box || !locked->set.add(entry, std::move(box))) {
-      return mozilla::Nothing();
-    }
+  if (!entry && !locked->set.add(entry, std::move(box))) {
+    return mozilla::Nothing();
   }
 
   MOZ_ASSERT(entry && *entry);
@@ -49,22 +61,32 @@ SharedImmutableStringsCache::getOrCreate(
                                      length * sizeof(char16_t));
   Hasher::Lookup lookup(hash, chars, length);
 
+  {
+    auto locked = inner_->lock();
+    if (auto entry = locked->set.lookup(lookup)) {
+      return mozilla::Some(SharedImmutableTwoByteString(locked, entry->get()));
+    }
+  }
+
+  // As above, copy outside the lock.
+  OwnedTwoByteChars ownedTwoByteChars(intoOwnedTwoByteChars());
+  if (!ownedTwoByteChars) {
+    return mozilla::Nothing();
+  }
+  MOZ_ASSERT(
+      ownedTwoByteChars.get() == chars ||
+      memcmp(ownedTwoByteChars.get(), chars, length * sizeof(char16_t)) == 0);
+  OwnedChars ownedChars(reinterpret_cast<char*>(ownedTwoByteChars.release()));
+  auto box =
+      StringBox::Create(std::move(ownedChars), length * sizeof(char16_t));
+  if (!box) {
+    return mozilla::Nothing();
+  }
+
   auto locked = inner_->lock();
   auto entry = locked->set.lookupForAdd(lookup);
-  if (!entry) {
-    OwnedTwoByteChars ownedTwoByteChars(intoOwnedTwoByteChars());
-    if (!ownedTwoByteChars) {
-      return mozilla::Nothing();
-    }
-    MOZ_ASSERT(
-        ownedTwoByteChars.get() == chars ||
-        memcmp(ownedTwoByteChars.get(), chars, length * sizeof(char16_t)) == 0);
-    OwnedChars ownedChars(reinterpret_cast<char*>(ownedTwoByteChars.release()));
-    auto box =
-        StringBox::Create(std::move(ownedChars), length * sizeof(char16_t));
-    if (!box || !locked->set.add(entry, std::move(box))) {
-      return mozilla::Nothing();
-    }
+  if (!entry && !locked->set.add(entry, std::move(box))) {
+    return mozilla::Nothing();
   }
 
   MOZ_ASSERT(entry && *entry);
@@ -2619,7 +2619,42 @@ void TypeZone::processPendingRecompiles(JSFreeOp* fop,
   RecompileInfoVector pending(std::move(recompiles));
   recompiles.clear();
 
-  jit::Invalidate(*this, fop, pending);
+  // Scripts which haven't been invalidated often keep their warm-up count so
+  // Baseline code immediately requests an off-thread recompilation with the
+  // new types. Scripts which keep flapping have to warm up again, which lets
+  // them observe more general types before the next compilation.
+  RecompileInfoVector eager;
+  if (jit::JitOptions.ionEagerRecompileThreshold) {
+    RecompileInfoVector delayed;
+    bool ok = true;
+    for (const RecompileInfo& info : pending) {
+      JSScript* script = info.script();
+      bool isEager =
+          script->hasJitScript() &&
+          script->jitScript()->ionInvalidationCount() <
+              jit::JitOptions.ionEagerRecompileThreshold;
+      RecompileInfoVector& list = isEager ? eager : delayed;
+      if (!list.append(info)) {
+        ok = false;
+        break;
+      }
+    }
+    if (ok) {
+      pending = std::move(delayed);
+    } else {
+      eager.clear();
+    }
+  }
+
+  // Type changes count towards the scripts' invalidation thresholds.
+  if (!eager.empty()) {
+    jit::Invalidate(*this, fop, eager, /* resetUses = */ false,
+                    /* cancelOffThread = */ true, /* deoptimized = */ true);
+  }
+  if (!pending.empty()) {
+    jit::Invalidate(*this, fop, pending, /* resetUses = */ true,
+                    /* cancelOffThread = */ true, /* deoptimized = */ true);
+  }
 
   MOZ_ASSERT(recompiles.empty());
 }
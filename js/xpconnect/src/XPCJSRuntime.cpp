@@ -2347,6 +2347,18 @@ void JSReporter::CollectReports(WindowPaths* windowPaths,
       NS_LITERAL_CSTRING("js-main-runtime/runtime"), KIND_OTHER, rtTotal,
       "The sum of all measurements under 'explicit/js-non-window/runtime/'.");
 
+  REPORT(NS_LITERAL_CSTRING("js-main-runtime-uncompressed-source-cache/hits"),
+         KIND_OTHER, UNITS_COUNT_CUMULATIVE,
+         rtStats.runtime.uncompressedSourceCacheHits,
+         "The number of source chunk lookups that found the chunk already "
+         "decompressed in the uncompressed source cache.");
+
+  REPORT(
+      NS_LITERAL_CSTRING("js-main-runtime-uncompressed-source-cache/misses"),
+      KIND_OTHER, UNITS_COUNT_CUMULATIVE,
+      rtStats.runtime.uncompressedSourceCacheMisses,
+      "The number of source chunk lookups that had to decompress the chunk.");
+
   // Report the number of HelperThread
 
   REPORT(NS_LITERAL_CSTRING("js-helper-threads/idle"), KIND_OTHER, UNITS_COUNT,
@@ -2554,6 +2566,13 @@ void JSReporter::CollectReports(WindowPaths* windowPaths,
       gStats.tracelogger,
       "The memory used for the tracelogger, including the graph and events.");
 
+  // Report the Rust frontend's compile cache (global).
+
+  REPORT_BYTES(
+      NS_LITERAL_CSTRING("explicit/js-non-window/smoosh-compile-cache"),
+      KIND_HEAP, gStats.smooshCompileCache,
+      "The memory used to cache the output of the Rust frontend.");
+
   // Report HelperThreadState.
 
   REPORT_BYTES(